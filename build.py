@@ -19,6 +19,10 @@ def parse_options():
                         action="store_true", help="Build in debug mode.")
     parser.add_argument('--cxx-compiler',
                         default='default', help="Path to CXX compiler used by CMake.")
+    parser.add_argument('--flat-relations',
+                        action="store_true",
+                        help="Store the relations of states as sorted flat tuple arrays "
+                             "instead of hash sets.")
     return parser.parse_args()
 
 def get_build_dir(debug):
@@ -32,7 +36,7 @@ def create_dir(path):
     if not os.path.exists(path):
         os.makedirs(path)
 
-def build(debug_flag, compiler):
+def build(debug_flag, compiler, flat_relations=False):
     BUILD_DIR = get_build_dir(debug_flag)
     BUILD_SEARCH_DIR = os.path.join(BUILD_DIR, 'search')
     if debug_flag:
@@ -46,6 +50,8 @@ def build(debug_flag, compiler):
     extra_options = []
     if compiler != 'default':
         extra_options = ['-DCMAKE_CXX_COMPILER='+compiler]
+    if flat_relations:
+        extra_options.append('-DFLAT_RELATIONS=ON')
 
     subprocess.check_call(['cmake', SEARCH_DIR,
                            '-DCMAKE_BUILD_TYPE='+BUILD_TYPE] + extra_options,
@@ -55,4 +61,4 @@ def build(debug_flag, compiler):
 
 if __name__ == '__main__':
     options = parse_options()
-    build(options.debug, options.cxx_compiler)
+    build(options.debug, options.cxx_compiler, options.flat_relations)
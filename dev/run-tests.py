@@ -29,23 +29,30 @@ OPTIMAL_PLAN_COSTS = {'domains/airport/p05-airport2-p1.pddl': 21,
                       'domains/organic-synthesis/p05.pddl': 2}
 SEARCH_CONFIGS = ['bfs', 'gbfs']
 HEURISTIC_CONFIGS = ['blind']
-GENERATOR_CONFIGS = ['full_reducer', 'join', 'yannakakis']
+GENERATOR_CONFIGS = ['full_reducer', 'join', 'yannakakis', 'leapfrog', 'adaptive_join']
 STATE_REPR_CONFIGS = ['sparse', 'extensional']
+# Configurations run in addition to the ones above, with extra planner arguments
+EXTRA_ARGS_CONFIGS = [(('hda-astar', 'blind', 'yannakakis', 'sparse'), ['--threads', '4']),
+                      (('hda-astar', 'blind', 'yannakakis', 'extensional'), ['--threads', '4'])]
 
 
 class TestRun:
-    def __init__(self, instance, config):
+    def __init__(self, instance, config, extra_args=()):
         self.instance = instance
         self.search = config[0]
         self.heuristic = config[1]
         self.generator = config[2]
         self.state_representation = config[3]
+        self.extra_args = list(extra_args)
 
     def get_config(self):
-        return "{}, {}, {}, and {}".format(self.search,
-                                           self.heuristic,
-                                           self.generator,
-                                           self.state_representation)
+        config = "{}, {}, {}, and {}".format(self.search,
+                                             self.heuristic,
+                                             self.generator,
+                                             self.state_representation)
+        if self.extra_args:
+            config += " ({})".format(' '.join(self.extra_args))
+        return config
 
     def __str__(self):
         return "{} with {}".format(self.instance, self.get_config())
@@ -58,7 +65,7 @@ class TestRun:
                                           '-e', self.heuristic,
                                           '-g', self.generator,
                                           '--state', self.state_representation,
-                                          '--validate'])
+                                          '--validate'] + self.extra_args)
         return output
 
     def evaluate(self, output, optimal_cost):
@@ -120,8 +127,10 @@ if __name__ == '__main__':
     failures = 0
     passes = 0
     for instance, cost in OPTIMAL_PLAN_COSTS.items():
-        for config in product(SEARCH_CONFIGS, HEURISTIC_CONFIGS, GENERATOR_CONFIGS, STATE_REPR_CONFIGS):
-            test = TestRun(instance, config)
+        configs = [(config, []) for config in product(SEARCH_CONFIGS, HEURISTIC_CONFIGS,
+                                                      GENERATOR_CONFIGS, STATE_REPR_CONFIGS)]
+        for config, extra_args in configs + EXTRA_ARGS_CONFIGS:
+            test = TestRun(instance, config, extra_args)
             output = test.run()
             passed = test.evaluate(output, cost)
             if passed:
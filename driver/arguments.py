@@ -15,13 +15,19 @@ SEARCH_CHOICES = ["astar",
                   "alt-bfws1",
                   "alt-bfws2",
                   "gbfs",
+                  "hda-astar",
+                  "hda-gbfs",
                   "iw1",
                   "iw1gc",
                   "iw2",
                   "iw2gc",
                   "lazy",
                   "lazy-po",
-                  "lazy-prune"]
+                  "lazy-prune",
+                  "par-bfws1",
+                  "par-bfws1-rx",
+                  "par-bfws2",
+                  "par-bfws2-rx"]
 
 EVALUATOR_CHOICES = ["blind",
                      "goalcount",
@@ -35,6 +41,8 @@ SUCCESSOR_GENERATOR_CHOICES = ['yannakakis',
                                'random_join',
                                'ordered_join',
                                'full_reducer',
+                               'leapfrog',
+                               'adaptive_join',
                                'clique_bk',
                                'clique_kckp']
 
@@ -71,11 +79,15 @@ def parse_options():
                         default="sparse", choices=("sparse", "extensional"))
     parser.add_argument('--seed', action='store', help='Random seed.',
                         default=1)
+    parser.add_argument('--threads', action='store', type=int, default=1,
+                        help='Number of threads used for successor generation or by the parallel search engines (hda-*, par-bfws*).')
     parser.add_argument('--time-limit', action='store', type=int, help='Time limit in seconds.',
                         default=1800)
     parser.add_argument('--translator-output-file', dest='translator_file',
                         default='output.lifted',
                         help='Output file of the translator')
+    parser.add_argument('--binary-task-file', action='store_true',
+                        help='Write the translator output in the binary format, which is faster to load')
     parser.add_argument('--plan-file', dest='plan_file',
                         default='plan',
                         help='name of plan file')
@@ -96,13 +108,41 @@ def parse_options():
                         help="flag if the novelty evaluation of a state should only consider atoms in the applied action effect")
     parser.add_argument("--novelty-early-stop", action="store_true",
                         help="flag if the novelty evaluation of a state should stop as soon as the w-value is defined")
+    parser.add_argument("--dense-novelty-tables", action="store_true",
+                        help="flag if the novelty evaluation should number the relaxed reachable atoms before the "
+                             "search and use bitmaps instead of hash sets (at most 256 MiB of bitmaps of pairs of atoms "
+                             "in total; the buckets reached afterwards keep their pairs in hash sets)")
+    parser.add_argument("--novelty-bloom-filter-bytes", type=int, default=0,
+                        help="size in bytes of the Bloom filter keeping the pairs of atoms of each novelty bucket "
+                             "for width 2 (default: 0, exact tables)")
+    parser.add_argument("--novelty-false-positive-rate", type=float, default=0.01,
+                        help="false positive rate the novelty Bloom filters are designed for, strictly between 0 and 1 "
+                             "(default: %(default)s)")
+    parser.add_argument("--stop-expansion-early", action="store_true",
+                        help="flag if lazy search and BFWS should stop expanding a state at its first child reached "
+                             "by a useful operator (lazy search) or of novelty 1 (BFWS), and reopen it")
+    parser.add_argument("--expansion-budget", type=int, default=0,
+                        help="number of children opened by lazy search and BFWS before the expansion of a state "
+                             "is stopped and the state reopened (default: 0, no limit)")
     parser.add_argument("--unit-cost", action="store_true",
                            help="flag if the actions should be treated as unit-cost actions")
     parser.add_argument("--validate", action="store_true",
                         help="flag if VAL should be called to validate the plan found")
     parser.add_argument("--forward-reachability", action="store_true",
                         help="run forward reachibility to generate all fact layers")
+    parser.add_argument("--incremental-grounding", action="store_true",
+                        help="keep the ground rules of the add, hmax and ff heuristics between states")
+    parser.add_argument("--incremental-successors", action="store_true",
+                        help="derive the applicable actions of a state from those of its parent "
+                             "(join and clique successor generators only)")
+    parser.add_argument("--memory-budget", type=int, default=0,
+                        help="memory (in MiB) above which the search space moves its oldest states "
+                             "and nodes to a file (default: 0, keep everything in memory)")
+    parser.add_argument("--spill-directory", default=".",
+                        help="directory of the file used by --memory-budget (default: current directory)")
     args = parser.parse_args()
+    if not 0 < args.novelty_false_positive_rate < 1:
+        parser.error("--novelty-false-positive-rate must be strictly between 0 and 1")
     if args.domain is None:
         args.domain = find_domain_filename(args.instance)
         if args.domain is None:
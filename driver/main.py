@@ -77,14 +77,35 @@ def set_extra_options(options):
         CPP_EXTRA_OPTIONS += ['--only-effects-novelty-check', str(1)]
     if options.novelty_early_stop:
         CPP_EXTRA_OPTIONS += ['--novelty-early-stop', str(1)]
+    if options.dense_novelty_tables:
+        CPP_EXTRA_OPTIONS += ['--dense-novelty-tables', str(1)]
+    if options.novelty_bloom_filter_bytes > 0:
+        CPP_EXTRA_OPTIONS += ['--novelty-bloom-filter-bytes', str(options.novelty_bloom_filter_bytes),
+                              '--novelty-false-positive-rate', str(options.novelty_false_positive_rate)]
+    if options.stop_expansion_early:
+        CPP_EXTRA_OPTIONS += ['--stop-expansion-early', str(1)]
+    if options.expansion_budget > 0:
+        CPP_EXTRA_OPTIONS += ['--expansion-budget', str(options.expansion_budget)]
 
 
     # Checks if unit-cost flag is true
     if options.unit_cost:
         PYTHON_EXTRA_OPTIONS += ["--unit-cost"]
+    if options.binary_task_file:
+        PYTHON_EXTRA_OPTIONS += ["--binary-output"]
     
     if options.forward_reachability:
         CPP_EXTRA_OPTIONS += ['--forward-reachability', str(1)]
+    if options.incremental_grounding:
+        CPP_EXTRA_OPTIONS += ['--incremental-grounding', str(1)]
+    if options.incremental_successors:
+        CPP_EXTRA_OPTIONS += ['--incremental-successors', str(1)]
+    if options.memory_budget > 0:
+        CPP_EXTRA_OPTIONS += ['--memory-budget', str(options.memory_budget),
+                              '--spill-directory', options.spill_directory]
+
+    if options.threads > 1:
+        CPP_EXTRA_OPTIONS += ['--threads', str(options.threads)]
 
     return PYTHON_EXTRA_OPTIONS, CPP_EXTRA_OPTIONS
 
@@ -1,5 +1,15 @@
 #include "kpkc.h"
 
+#include "../utils/worker_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
 namespace algorithms {
 
 bool find_all_k_cliques_in_k_partite_graph_helper(const std::vector<boost::dynamic_bitset<>> &adjacency_matrix,
@@ -111,4 +121,253 @@ bool find_all_k_cliques_in_k_partite_graph(const std::vector<boost::dynamic_bits
     return finished;
 }
 
+
+/*
+  Word-level AND of two ranges of blocks, returning the number of bits set in
+  the result.
+*/
+using Block = KPartiteGraph::Block;
+using AndCountFunction = std::size_t (*)(Block *, const Block *, const Block *, std::size_t);
+
+static std::size_t and_count_generic(Block *result, const Block *first, const Block *second, std::size_t num_blocks) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        result[i] = first[i] & second[i];
+        count += __builtin_popcountll(result[i]);
+    }
+    return count;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target("avx2,popcnt"))) static std::size_t and_count_avx2(Block *result,
+                                                                         const Block *first,
+                                                                         const Block *second,
+                                                                         std::size_t num_blocks) {
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(second + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + i), _mm256_and_si256(a, b));
+        count += _mm_popcnt_u64(result[i]) + _mm_popcnt_u64(result[i + 1])
+            + _mm_popcnt_u64(result[i + 2]) + _mm_popcnt_u64(result[i + 3]);
+    }
+    for (; i < num_blocks; ++i) {
+        result[i] = first[i] & second[i];
+        count += _mm_popcnt_u64(result[i]);
+    }
+    return count;
+}
+#endif
+
+static AndCountFunction select_and_count() {
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return and_count_avx2;
+    }
+#endif
+    return and_count_generic;
+}
+
+static const AndCountFunction and_count = select_and_count();
+
+KPartiteGraph::KPartiteGraph(const std::vector<std::vector<std::size_t>> &partitions)
+    : first_vertex(1, 0), first_block(1, 0), row_size(0) {
+    for (std::size_t partition = 0; partition < partitions.size(); ++partition) {
+        const std::size_t size = partitions[partition].size();
+        for (std::size_t index = 0; index < size; ++index) {
+            assert(partitions[partition][index] == first_vertex.back() + index);
+            partition_of_vertex.push_back(partition);
+        }
+        first_vertex.push_back(first_vertex.back() + size);
+        first_block.push_back(first_block.back() + (size + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK);
+    }
+    row_size = (first_block.back() + 3) / 4 * 4;
+    rows.assign(get_num_vertices() * row_size, 0);
+}
+
+void KPartiteGraph::add_edge(std::size_t first, std::size_t second) {
+    const std::size_t first_partition = partition_of_vertex[first];
+    const std::size_t second_partition = partition_of_vertex[second];
+    assert(first_partition != second_partition);
+    const std::size_t first_index = first - first_vertex[first_partition];
+    const std::size_t second_index = second - first_vertex[second_partition];
+    rows[first * row_size + first_block[second_partition] + second_index / BITS_PER_BLOCK] |=
+        Block(1) << (second_index % BITS_PER_BLOCK);
+    rows[second * row_size + first_block[first_partition] + first_index / BITS_PER_BLOCK] |=
+        Block(1) << (first_index % BITS_PER_BLOCK);
+}
+
+void KPartiteGraph::remove_all_edges() {
+    std::fill(rows.begin(), rows.end(), 0);
+}
+
+bool KPartiteGraph::has_edge(std::size_t first, std::size_t second) const {
+    const std::size_t second_partition = partition_of_vertex[second];
+    const std::size_t second_index = second - first_vertex[second_partition];
+    return (get_row(first)[first_block[second_partition] + second_index / BITS_PER_BLOCK]
+            >> (second_index % BITS_PER_BLOCK)) & 1;
+}
+
+void KPartiteSearchStack::initialize(const KPartiteGraph &graph) {
+    const std::size_t k = graph.get_num_partitions();
+    const std::size_t row_size = graph.get_row_size();
+    compatible.resize(k * row_size);
+    num_compatible.resize(k * k);
+    is_covered.assign(k, false);
+    partial_clique.clear();
+
+    // At depth 0, all vertices are compatible
+    std::fill(compatible.begin(), compatible.begin() + row_size, 0);
+    for (std::size_t partition = 0; partition < k; ++partition) {
+        const std::size_t size = graph.get_partition_size(partition);
+        Block *blocks = compatible.data() + graph.get_first_block(partition);
+        for (std::size_t index = 0; index < size; ++index) {
+            blocks[index / KPartiteGraph::BITS_PER_BLOCK] |= Block(1) << (index % KPartiteGraph::BITS_PER_BLOCK);
+        }
+        num_compatible[partition] = size;
+    }
+}
+
+// Uncovered partition with the fewest compatible vertices at the given depth
+static std::size_t select_partition(const KPartiteGraph &graph, const KPartiteSearchStack &stack, std::size_t depth) {
+    const std::size_t k = graph.get_num_partitions();
+    std::size_t best_partition = std::numeric_limits<std::size_t>::max();
+    std::size_t best_size = std::numeric_limits<std::size_t>::max();
+    for (std::size_t partition = 0; partition < k; ++partition) {
+        if (!stack.is_covered[partition] && stack.num_compatible[depth * k + partition] < best_size) {
+            best_size = stack.num_compatible[depth * k + partition];
+            best_partition = partition;
+        }
+    }
+    return best_partition;
+}
+
+/*
+  Computes the compatible vertices of depth + 1 after adding the vertex to the
+  partial clique, and returns false if some uncovered partition has none.
+*/
+static bool intersect(const KPartiteGraph &graph, KPartiteSearchStack &stack, std::size_t depth, std::size_t vertex) {
+    const std::size_t k = graph.get_num_partitions();
+    const std::size_t row_size = graph.get_row_size();
+    const Block *current = stack.compatible.data() + depth * row_size;
+    Block *next = stack.compatible.data() + (depth + 1) * row_size;
+    const Block *row = graph.get_row(vertex);
+    for (std::size_t partition = 0; partition < k; ++partition) {
+        if (stack.is_covered[partition]) {
+            continue;
+        }
+        const std::size_t first = graph.get_first_block(partition);
+        const std::size_t count = and_count(next + first, current + first, row + first, graph.get_num_blocks(partition));
+        stack.num_compatible[(depth + 1) * k + partition] = count;
+        if (count == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void search(const KPartiteGraph &graph,
+                   KPartiteSearchStack &stack,
+                   std::size_t depth,
+                   std::vector<std::vector<uint32_t>> &out_cliques);
+
+// Extends the partial clique with a vertex of the partition covered at the given depth
+static void branch(const KPartiteGraph &graph,
+                   KPartiteSearchStack &stack,
+                   std::size_t depth,
+                   std::size_t vertex,
+                   std::vector<std::vector<uint32_t>> &out_cliques) {
+    stack.partial_clique.push_back(static_cast<uint32_t>(vertex));
+    if (stack.partial_clique.size() == graph.get_num_partitions()) {
+        out_cliques.push_back(stack.partial_clique);
+    }
+    else if (intersect(graph, stack, depth, vertex)) {
+        search(graph, stack, depth + 1, out_cliques);
+    }
+    stack.partial_clique.pop_back();
+}
+
+static void search(const KPartiteGraph &graph,
+                   KPartiteSearchStack &stack,
+                   std::size_t depth,
+                   std::vector<std::vector<uint32_t>> &out_cliques) {
+    const std::size_t partition = select_partition(graph, stack, depth);
+    const std::size_t first = graph.get_first_block(partition);
+    const std::size_t num_blocks = graph.get_num_blocks(partition);
+    const Block *compatible = stack.compatible.data() + depth * graph.get_row_size();
+    stack.is_covered[partition] = true;
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        for (Block bits = compatible[first + block]; bits != 0; bits &= bits - 1) {
+            const std::size_t index = block * KPartiteGraph::BITS_PER_BLOCK + __builtin_ctzll(bits);
+            branch(graph, stack, depth, graph.get_first_vertex(partition) + index, out_cliques);
+        }
+    }
+    stack.is_covered[partition] = false;
+}
+
+KPartiteCliqueEnumerator::KPartiteCliqueEnumerator(unsigned num_threads) : stacks(std::max(num_threads, 1u)) {
+    if (num_threads > 1) {
+        worker_pool = std::make_unique<utils::WorkerPool>(num_threads);
+    }
+}
+
+KPartiteCliqueEnumerator::~KPartiteCliqueEnumerator() = default;
+
+std::size_t KPartiteCliqueEnumerator::acquire_stack() {
+    std::lock_guard<std::mutex> lock(free_stacks_mutex);
+    assert(!free_stacks.empty());
+    const std::size_t stack = free_stacks.back();
+    free_stacks.pop_back();
+    return stack;
+}
+
+void KPartiteCliqueEnumerator::release_stack(std::size_t stack) {
+    std::lock_guard<std::mutex> lock(free_stacks_mutex);
+    free_stacks.push_back(stack);
+}
+
+void KPartiteCliqueEnumerator::find_all_cliques(const KPartiteGraph &graph,
+                                                std::vector<std::vector<uint32_t>> &out_cliques) {
+    const std::size_t k = graph.get_num_partitions();
+    if (k == 0) {
+        return;
+    }
+    for (std::size_t partition = 0; partition < k; ++partition) {
+        if (graph.get_partition_size(partition) == 0) {
+            return;
+        }
+    }
+
+    if (!worker_pool || graph.get_num_vertices() < MIN_VERTICES_PARALLEL) {
+        stacks[0].initialize(graph);
+        search(graph, stacks[0], 0, out_cliques);
+        return;
+    }
+
+    // Every vertex of the first partition is compatible, and is a branch
+    free_stacks.clear();
+    for (std::size_t stack = 0; stack < stacks.size(); ++stack) {
+        stacks[stack].initialize(graph);
+        free_stacks.push_back(stack);
+    }
+    const std::size_t partition = select_partition(graph, stacks[0], 0);
+    for (auto &stack : stacks) {
+        stack.is_covered[partition] = true;
+    }
+    const std::size_t num_branches = graph.get_partition_size(partition);
+    cliques_per_branch.resize(num_branches);
+    worker_pool->run(num_branches, [&](std::size_t index) {
+        const std::size_t stack = acquire_stack();
+        branch(graph, stacks[stack], 0, graph.get_first_vertex(partition) + index, cliques_per_branch[index]);
+        release_stack(stack);
+    });
+    for (std::size_t index = 0; index < num_branches; ++index) {
+        auto &cliques = cliques_per_branch[index];
+        std::move(cliques.begin(), cliques.end(), std::back_inserter(out_cliques));
+        cliques.clear();
+    }
+}
+
 }  // namespace algorithms
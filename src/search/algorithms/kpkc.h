@@ -3,14 +3,143 @@
 
 #include <boost/dynamic_bitset.hpp>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+namespace utils {
+class WorkerPool;
+}
+
 namespace algorithms {
+/*
+  Reference implementation, kept to validate and benchmark the
+  KPartiteCliqueEnumerator below (see benchmarks/kpkc_benchmark.cc).
+*/
 bool find_all_k_cliques_in_k_partite_graph(const std::vector<boost::dynamic_bitset<>> &adjacency_matrix,
                                            const std::vector<std::vector<size_t>> &partitions,
                                            std::vector<std::vector<uint32_t>> &out_cliques);
+
+/*
+  Adjacency matrix of a k-partite graph whose vertices are numbered partition
+  after partition.
+
+  Each row is split into one bitset per partition, and each of them starts at
+  a 64-bit word, so the neighbors of a vertex in a partition are a contiguous
+  range of words that can be intersected word by word. Rows are padded to a
+  multiple of four words (256 bits).
+*/
+class KPartiteGraph {
+public:
+    using Block = std::uint64_t;
+    static const std::size_t BITS_PER_BLOCK = 64;
+
+private:
+    // Indexed by partition, with one more entry for the end of the last one
+    std::vector<std::size_t> first_vertex;
+    std::vector<std::size_t> first_block;
+    std::vector<std::size_t> partition_of_vertex;
+    std::size_t row_size;
+    std::vector<Block> rows;
+
+public:
+    // The vertices of partitions[i] must follow those of partitions[i - 1]
+    explicit KPartiteGraph(const std::vector<std::vector<std::size_t>> &partitions);
+
+    void add_edge(std::size_t first, std::size_t second);
+
+    void remove_all_edges();
+
+    bool has_edge(std::size_t first, std::size_t second) const;
+
+    std::size_t get_num_vertices() const {
+        return partition_of_vertex.size();
+    }
+
+    std::size_t get_num_partitions() const {
+        return first_vertex.size() - 1;
+    }
+
+    std::size_t get_partition_size(std::size_t partition) const {
+        return first_vertex[partition + 1] - first_vertex[partition];
+    }
+
+    std::size_t get_first_vertex(std::size_t partition) const {
+        return first_vertex[partition];
+    }
+
+    std::size_t get_first_block(std::size_t partition) const {
+        return first_block[partition];
+    }
+
+    std::size_t get_num_blocks(std::size_t partition) const {
+        return first_block[partition + 1] - first_block[partition];
+    }
+
+    // Number of words of a row, including the padding
+    std::size_t get_row_size() const {
+        return row_size;
+    }
+
+    const Block *get_row(std::size_t vertex) const {
+        return rows.data() + vertex * row_size;
+    }
+};
+
+/*
+  Bitsets of the vertices still compatible with the partial clique at each
+  depth of the search, allocated once for the largest graph seen so far.
+*/
+struct KPartiteSearchStack {
+    std::vector<KPartiteGraph::Block> compatible;
+    std::vector<std::size_t> num_compatible;
+    std::vector<bool> is_covered;
+    std::vector<std::uint32_t> partial_clique;
+
+    void initialize(const KPartiteGraph &graph);
+};
+
+/*
+  Enumerates the k-cliques of a k-partite graph, i.e., the sets with one vertex
+  of each partition that are pairwise adjacent.
+
+  The search extends a partial clique with the vertices of the partition with
+  the fewest compatible vertices. The compatible vertices of the next depth
+  are the word-level AND of the current ones with the row of the new vertex,
+  written into the preallocated stack, and counted at the same time to choose
+  the next partition and to prune the branches where a partition has no
+  compatible vertex left. The AND and the population count use AVX2 if the CPU
+  supports it.
+
+  With more than one thread, the branches of the first partition are
+  distributed over a worker pool. The cliques are produced in the same order
+  as with a single thread, which is also the order of
+  find_all_k_cliques_in_k_partite_graph.
+*/
+class KPartiteCliqueEnumerator {
+    std::unique_ptr<utils::WorkerPool> worker_pool;
+    std::vector<KPartiteSearchStack> stacks;
+    std::vector<std::size_t> free_stacks;
+    std::mutex free_stacks_mutex;
+    std::vector<std::vector<std::vector<std::uint32_t>>> cliques_per_branch;
+
+    // Smaller graphs are not worth dispatching to the worker pool
+    static const std::size_t MIN_VERTICES_PARALLEL = 128;
+
+    std::size_t acquire_stack();
+    void release_stack(std::size_t stack);
+
+public:
+    explicit KPartiteCliqueEnumerator(unsigned num_threads = 1);
+    ~KPartiteCliqueEnumerator();
+
+    // Appends the cliques to out_cliques, listing their vertices in the order they were chosen
+    void find_all_cliques(const KPartiteGraph &graph,
+                          std::vector<std::vector<std::uint32_t>> &out_cliques);
+};
 }  // namespace algorithms
 
 #endif  // ALGORITHMS_KPKC_HPP_
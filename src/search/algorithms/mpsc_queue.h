@@ -0,0 +1,77 @@
+#ifndef ALGORITHMS_MPSC_QUEUE_H
+#define ALGORITHMS_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace mpsc_queue {
+/*
+  Unbounded lock-free multi-producer single-consumer queue.
+
+  Producers push with a single compare-and-swap on the head of a linked list.
+  The consumer takes the whole list at once with an atomic exchange and
+  processes the elements in the order they were pushed. Elements pushed by
+  different producers are not ordered with respect to each other.
+*/
+template<typename T>
+class MPSCQueue {
+    struct Node {
+        T value;
+        Node *next;
+    };
+
+    std::atomic<Node *> head;
+
+public:
+    MPSCQueue() : head(nullptr) {
+    }
+
+    ~MPSCQueue() {
+        consume_all([](T &&) {});
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    void push(T &&value) {
+        Node *node = new Node{std::move(value), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == nullptr;
+    }
+
+    /*
+      Remove all elements currently in the queue and call f on each of them,
+      oldest first. Must only be called by the consumer. Returns the number of
+      elements consumed.
+    */
+    template<typename F>
+    std::size_t consume_all(F f) {
+        Node *list = head.exchange(nullptr, std::memory_order_acquire);
+        Node *reversed = nullptr;
+        while (list) {
+            Node *next = list->next;
+            list->next = reversed;
+            reversed = list;
+            list = next;
+        }
+        std::size_t count = 0;
+        while (reversed) {
+            Node *next = reversed->next;
+            f(std::move(reversed->value));
+            delete reversed;
+            reversed = next;
+            ++count;
+        }
+        return count;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Micro-benchmark comparing hash_join(t1, t2) with the open-addressing
+ * hash_join(t1, t2, arena).
+ *
+ * The join programs are taken from real states: we run a breadth-first search
+ * from the initial state of the given task and, for each of the first N
+ * distinct states, store the precondition tables of every lifted action schema
+ * as built by the successor generator. Both implementations then replay the
+ * same join programs, in the same order, and their results are compared.
+ *
+ * Usage: hash_join_benchmark <task.lifted> [number-of-states] [repetitions]
+ */
+
+#include "../action.h"
+#include "../action_schema.h"
+#include "../parser.h"
+#include "../task.h"
+
+#include "../database/hash_join.h"
+#include "../database/join_arena.h"
+#include "../database/table.h"
+#include "../states/sparse_states.h"
+#include "../states/state.h"
+#include "../successor_generators/generic_join_successor.h"
+#include "../utils/timer.h"
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Exposes the precondition tables that GenericJoinSuccessor builds for an
+ * action schema in a given state.
+ */
+class JoinProgramCollector : public GenericJoinSuccessor {
+public:
+    explicit JoinProgramCollector(const Task &task) : GenericJoinSuccessor(task) {}
+
+    bool collect(const ActionSchema &action, const DBState &state, vector<Table> &tables) {
+        if (action.is_ground() || is_trivially_inapplicable(state, action))
+            return false;
+        return parse_precond_into_join_program(action_data[action.get_index()], state, tables);
+    }
+};
+
+struct JoinProgram {
+    vector<Table> tables;
+};
+
+static vector<JoinProgram> collect_join_programs(const Task &task, size_t max_states) {
+    JoinProgramCollector generator(task);
+    SparseStatePacker packer(task);
+    unordered_set<SparsePackedState, PackedStateHash> seen;
+    deque<DBState> queue;
+    vector<JoinProgram> programs;
+
+    queue.push_back(task.get_initial_state());
+    seen.insert(packer.pack(task.get_initial_state()));
+    size_t expanded = 0;
+    while (!queue.empty() && expanded < max_states) {
+        DBState state = std::move(queue.front());
+        queue.pop_front();
+        ++expanded;
+        for (const ActionSchema &action : task.get_action_schemas()) {
+            JoinProgram program;
+            if (generator.collect(action, state, program.tables) && program.tables.size() > 1)
+                programs.push_back(std::move(program));
+
+            for (const LiftedOperatorId &op : generator.get_applicable_actions(action, state)) {
+                DBState successor = generator.generate_successor(op, action, state);
+                if (seen.insert(packer.pack(successor)).second)
+                    queue.push_back(std::move(successor));
+            }
+        }
+    }
+    cout << "States used: " << expanded << endl;
+    return programs;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <task.lifted> [number-of-states] [repetitions]" << endl;
+        return 1;
+    }
+    size_t max_states = (argc > 2) ? stoul(argv[2]) : 1000;
+    int repetitions = (argc > 3) ? stoi(argv[3]) : 10;
+
+    ifstream task_file(argv[1]);
+    if (!task_file) {
+        cerr << "Error opening the task file: " << argv[1] << endl;
+        return 1;
+    }
+    cin.rdbuf(task_file.rdbuf());
+    string domain_name, task_name;
+    cin >> domain_name >> task_name;
+    Task task(domain_name, task_name);
+    if (!parse(task, task_file)) {
+        cerr << "Parser failed." << endl;
+        return 1;
+    }
+
+    vector<JoinProgram> programs = collect_join_programs(task, max_states);
+    cout << "Join programs: " << programs.size() << endl;
+
+    size_t tuples_unordered_map = 0;
+    utils::Timer timer_unordered_map;
+    for (int r = 0; r < repetitions; ++r) {
+        for (const JoinProgram &program : programs) {
+            Table working_table = program.tables[0];
+            for (size_t i = 1; i < program.tables.size() && !working_table.empty(); ++i)
+                hash_join(working_table, program.tables[i]);
+            tuples_unordered_map += working_table.size();
+        }
+    }
+    timer_unordered_map.stop();
+
+    // One arena per action schema would be used in the planner; a single one
+    // is equivalent here because programs are replayed sequentially.
+    JoinArena arena;
+    size_t tuples_open_addressing = 0;
+    utils::Timer timer_open_addressing;
+    for (int r = 0; r < repetitions; ++r) {
+        for (const JoinProgram &program : programs) {
+            arena.reset();
+            Table working_table = program.tables[0];
+            for (size_t i = 1; i < program.tables.size() && !working_table.empty(); ++i)
+                hash_join(working_table, program.tables[i], arena);
+            tuples_open_addressing += working_table.size();
+        }
+    }
+    timer_open_addressing.stop();
+
+    bool same_results = true;
+    for (const JoinProgram &program : programs) {
+        Table t1 = program.tables[0];
+        Table t2 = program.tables[0];
+        for (size_t i = 1; i < program.tables.size(); ++i) {
+            hash_join(t1, program.tables[i]);
+            hash_join(t2, program.tables[i], arena);
+        }
+        if (t1.values != t2.values || t1.tuple_index != t2.tuple_index)
+            same_results = false;
+    }
+
+    cout << "Repetitions: " << repetitions << endl;
+    cout << "unordered_map hash join: " << timer_unordered_map << " ("
+         << tuples_unordered_map << " tuples)" << endl;
+    cout << "open-addressing hash join: " << timer_open_addressing << " ("
+         << tuples_open_addressing << " tuples)" << endl;
+    cout << "Identical results: " << (same_results ? "yes" : "no") << endl;
+    return same_results ? 0 : 1;
+}
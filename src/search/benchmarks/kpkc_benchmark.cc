@@ -0,0 +1,187 @@
+/*
+ * Micro-benchmark comparing find_all_k_cliques_in_k_partite_graph with the
+ * bitset-parallel KPartiteCliqueEnumerator.
+ *
+ * The graphs are taken from real states: we run a breadth-first search from
+ * the initial state of the given task with the clique_kckp successor
+ * generator and, for each of the first N distinct states, store the adjacency
+ * matrix of every action schema with at least three parameters. Both
+ * implementations then enumerate the cliques of the same graphs, in the same
+ * order, and their results are compared.
+ *
+ * Usage: kpkc_benchmark <task.lifted> [number-of-states] [repetitions] [threads]
+ */
+
+#include "../action.h"
+#include "../action_schema.h"
+#include "../parser.h"
+#include "../task.h"
+
+#include "../algorithms/kpkc.h"
+#include "../states/sparse_states.h"
+#include "../states/state.h"
+#include "../successor_generators/clique_successor_generator.h"
+#include "../utils/timer.h"
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+struct CapturedGraph {
+    vector<vector<size_t>> partitions;
+    algorithms::KPartiteGraph graph;
+    vector<boost::dynamic_bitset<>> adjacency_matrix;
+};
+
+/*
+ * Reads the graphs that CliqueSuccessorGenerator builds for the action
+ * schemas in a given state.
+ */
+class CliqueGraphCollector {
+    CliqueSuccessorGenerator &generator;
+
+public:
+    explicit CliqueGraphCollector(CliqueSuccessorGenerator &generator) : generator(generator) {}
+
+    void collect(const DBState &state, vector<CapturedGraph> &graphs) {
+        generator.build_assignment_sets(state);
+        for (const ActionSchema &action : generator.task.get_action_schemas()) {
+            if (action.get_parameters().size() < 3 || !generator.test_nullary_preconditions(action, state))
+                continue;
+            const Precondition &preconds = generator.action_precondition.at(action);
+            if (!generator.consistent_literals_with_constants(preconds.dynamic_preconds_with_constants))
+                continue;
+
+            const auto &partitions = generator.action_partitions.at(action);
+            algorithms::KPartiteGraph graph(partitions);
+            generator.create_k_partite_graph(preconds, generator.action_statically_consistent_assignments.at(action), graph);
+
+            const size_t num_vertices = graph.get_num_vertices();
+            vector<boost::dynamic_bitset<>> adjacency_matrix(num_vertices, boost::dynamic_bitset<>(num_vertices));
+            for (size_t first = 0; first < num_vertices; ++first) {
+                for (size_t second = 0; second < num_vertices; ++second) {
+                    adjacency_matrix[first][second] = (first != second && graph.has_edge(first, second));
+                }
+            }
+            graphs.push_back(CapturedGraph{partitions, std::move(graph), std::move(adjacency_matrix)});
+        }
+    }
+};
+
+static vector<CapturedGraph> collect_graphs(const Task &task, size_t max_states) {
+    CliqueSuccessorGenerator generator(task, KCliqueKPartite);
+    CliqueGraphCollector collector(generator);
+    SparseStatePacker packer(task);
+    unordered_set<SparsePackedState, PackedStateHash> seen;
+    deque<DBState> queue;
+    vector<CapturedGraph> graphs;
+
+    queue.push_back(task.get_initial_state());
+    seen.insert(packer.pack(task.get_initial_state()));
+    size_t expanded = 0;
+    while (!queue.empty() && expanded < max_states) {
+        DBState state = std::move(queue.front());
+        queue.pop_front();
+        ++expanded;
+        collector.collect(state, graphs);
+        for (const LiftedOperatorId &op : generator.get_applicable_actions(task.get_action_schemas(), state)) {
+            const ActionSchema &action = task.get_action_schema_by_index(op.get_index());
+            DBState successor = generator.generate_successor(op, action, state);
+            if (seen.insert(packer.pack(successor)).second)
+                queue.push_back(std::move(successor));
+        }
+    }
+    cout << "States used: " << expanded << endl;
+    return graphs;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <task.lifted> [number-of-states] [repetitions] [threads]" << endl;
+        return 1;
+    }
+    size_t max_states = (argc > 2) ? stoul(argv[2]) : 1000;
+    int repetitions = (argc > 3) ? stoi(argv[3]) : 10;
+    unsigned num_threads = (argc > 4) ? stoul(argv[4]) : 4;
+
+    ifstream task_file(argv[1]);
+    if (!task_file) {
+        cerr << "Error opening the task file: " << argv[1] << endl;
+        return 1;
+    }
+    cin.rdbuf(task_file.rdbuf());
+    string domain_name, task_name;
+    cin >> domain_name >> task_name;
+    Task task(domain_name, task_name);
+    if (!parse(task, task_file)) {
+        cerr << "Parser failed." << endl;
+        return 1;
+    }
+
+    vector<CapturedGraph> graphs = collect_graphs(task, max_states);
+    size_t total_vertices = 0;
+    for (const CapturedGraph &captured : graphs)
+        total_vertices += captured.graph.get_num_vertices();
+    cout << "Graphs: " << graphs.size() << " (" << total_vertices << " vertices)" << endl;
+
+    vector<vector<uint32_t>> cliques;
+    size_t cliques_reference = 0;
+    utils::Timer timer_reference;
+    for (int r = 0; r < repetitions; ++r) {
+        for (const CapturedGraph &captured : graphs) {
+            cliques.clear();
+            algorithms::find_all_k_cliques_in_k_partite_graph(captured.adjacency_matrix, captured.partitions, cliques);
+            cliques_reference += cliques.size();
+        }
+    }
+    timer_reference.stop();
+
+    algorithms::KPartiteCliqueEnumerator sequential;
+    size_t cliques_sequential = 0;
+    utils::Timer timer_sequential;
+    for (int r = 0; r < repetitions; ++r) {
+        for (const CapturedGraph &captured : graphs) {
+            cliques.clear();
+            sequential.find_all_cliques(captured.graph, cliques);
+            cliques_sequential += cliques.size();
+        }
+    }
+    timer_sequential.stop();
+
+    algorithms::KPartiteCliqueEnumerator parallel(num_threads);
+    size_t cliques_parallel = 0;
+    utils::Timer timer_parallel;
+    for (int r = 0; r < repetitions; ++r) {
+        for (const CapturedGraph &captured : graphs) {
+            cliques.clear();
+            parallel.find_all_cliques(captured.graph, cliques);
+            cliques_parallel += cliques.size();
+        }
+    }
+    timer_parallel.stop();
+
+    bool same_results = true;
+    for (const CapturedGraph &captured : graphs) {
+        vector<vector<uint32_t>> reference, bitset_sequential, bitset_parallel;
+        algorithms::find_all_k_cliques_in_k_partite_graph(captured.adjacency_matrix, captured.partitions, reference);
+        sequential.find_all_cliques(captured.graph, bitset_sequential);
+        parallel.find_all_cliques(captured.graph, bitset_parallel);
+        if (reference != bitset_sequential || reference != bitset_parallel)
+            same_results = false;
+    }
+
+    cout << "Repetitions: " << repetitions << endl;
+    cout << "dynamic_bitset k-partite cliques: " << timer_reference << " ("
+         << cliques_reference << " cliques)" << endl;
+    cout << "bitset-parallel k-partite cliques: " << timer_sequential << " ("
+         << cliques_sequential << " cliques)" << endl;
+    cout << "bitset-parallel k-partite cliques, " << num_threads << " threads: " << timer_parallel << " ("
+         << cliques_parallel << " cliques)" << endl;
+    cout << "Identical results: " << (same_results ? "yes" : "no") << endl;
+    return same_results ? 0 : 1;
+}
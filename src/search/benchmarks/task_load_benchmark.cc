@@ -0,0 +1,126 @@
+/*
+ * Benchmark comparing the time to build a Task from the text task file with
+ * the time to build it from the binary task file of the same task.
+ *
+ * The binary file is written by the translator with --binary-output, or
+ * converted from the text file with src/translator/binary_task.py. Both tasks
+ * are loaded the given number of times and then compared.
+ *
+ * Usage: task_load_benchmark <task.lifted> <task.bin> [repetitions]
+ */
+
+#include "../action_schema.h"
+#include "../binary_task.h"
+#include "../parser.h"
+#include "../task.h"
+
+#include "../utils/timer.h"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// Task only keeps references to its names, so they are owned next to it
+struct LoadedTask {
+    string domain_name;
+    string task_name;
+    unique_ptr<BinaryTaskFile> binary_task;
+    unique_ptr<Task> task;
+};
+
+static unique_ptr<LoadedTask> load_text_task(const string &filename) {
+    ifstream task_file(filename);
+    if (!task_file) {
+        cerr << "Error opening the task file: " << filename << endl;
+        exit(1);
+    }
+    // The parser reads from cin, which may be at the end of the previous file
+    streambuf *stdin_buffer = cin.rdbuf(task_file.rdbuf());
+    cin.clear();
+    auto loaded = make_unique<LoadedTask>();
+    cin >> loaded->domain_name >> loaded->task_name;
+    loaded->task = make_unique<Task>(loaded->domain_name, loaded->task_name);
+    if (!parse(*loaded->task, task_file)) {
+        cerr << "Parser failed." << endl;
+        exit(1);
+    }
+    cin.rdbuf(stdin_buffer);
+    return loaded;
+}
+
+static unique_ptr<LoadedTask> load_binary_task(const string &filename) {
+    auto loaded = make_unique<LoadedTask>();
+    loaded->binary_task = make_unique<BinaryTaskFile>(filename);
+    loaded->task = make_unique<Task>(loaded->binary_task->get_domain_name(),
+                                     loaded->binary_task->get_task_name());
+    if (!loaded->binary_task->load(*loaded->task)) {
+        cerr << "Loading the binary task failed." << endl;
+        exit(1);
+    }
+    return loaded;
+}
+
+// The names of the tasks are not compared
+static bool have_same_content(const Task &t1, const Task &t2) {
+    if (t1.type_names != t2.type_names ||
+        t1.predicates.size() != t2.predicates.size() ||
+        t1.objects.size() != t2.objects.size() ||
+        t1.nullary_predicates != t2.nullary_predicates ||
+        !(t1.initial_state == t2.initial_state) ||
+        !(t1.static_info == t2.static_info) ||
+        t1.get_goal().goal.size() != t2.get_goal().goal.size() ||
+        t1.get_action_schemas().size() != t2.get_action_schemas().size())
+        return false;
+    for (size_t i = 0; i < t1.get_action_schemas().size(); ++i) {
+        const ActionSchema &a1 = t1.get_action_schemas()[i];
+        const ActionSchema &a2 = t2.get_action_schemas()[i];
+        if (a1.get_name() != a2.get_name() ||
+            a1.get_cost() != a2.get_cost() ||
+            a1.get_parameters() != a2.get_parameters() ||
+            a1.get_precondition().size() != a2.get_precondition().size() ||
+            a1.get_effects().size() != a2.get_effects().size() ||
+            a1.get_static_precondition().size() != a2.get_static_precondition().size())
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <task.lifted> <task.bin> [repetitions]" << endl;
+        return 1;
+    }
+    int repetitions = (argc > 3) ? stoi(argv[3]) : 10;
+
+    // Silence the statistics printed while loading
+    streambuf *stdout_buffer = cout.rdbuf();
+    ostringstream discarded;
+    cout.rdbuf(discarded.rdbuf());
+
+    utils::Timer timer_text;
+    for (int r = 0; r < repetitions; ++r) {
+        load_text_task(argv[1]);
+    }
+    timer_text.stop();
+
+    utils::Timer timer_binary;
+    for (int r = 0; r < repetitions; ++r) {
+        load_binary_task(argv[2]);
+    }
+    timer_binary.stop();
+
+    auto text_task = load_text_task(argv[1]);
+    auto binary_task = load_binary_task(argv[2]);
+    bool same_tasks = have_same_content(*text_task->task, *binary_task->task);
+    cout.rdbuf(stdout_buffer);
+
+    cout << "Repetitions: " << repetitions << endl;
+    cout << "Text task file: " << timer_text << endl;
+    cout << "Binary task file: " << timer_binary << endl;
+    cout << "Identical tasks: " << (same_tasks ? "yes" : "no") << endl;
+    return same_tasks ? 0 : 1;
+}
@@ -0,0 +1,367 @@
+#include "binary_task.h"
+#include "action_schema.h"
+#include "goal_condition.h"
+#include "task.h"
+
+#include "utils/system.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const char BinaryTaskFile::MAGIC[8] = {'P', 'W', 'L', 'B', 'T', 'A', 'S', 'K'};
+
+// Magic bytes, version and size of the string table
+static const size_t HEADER_BYTES = 8 + 2 * sizeof(uint32_t);
+
+enum Section {
+    TYPES = 1,
+    PREDICATES = 2,
+    OBJECTS = 3,
+    INITIAL_STATE = 4,
+    GOAL = 5,
+    ACTION_SCHEMAS = 6
+};
+
+bool BinaryTaskFile::is_binary_task_file(const string &filename)
+{
+    ifstream in(filename, ios::binary);
+    char magic[sizeof(MAGIC)];
+    return in.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+BinaryTaskFile::BinaryTaskFile(const string &filename)
+    : filename(filename), file_data(nullptr), file_size(0), position(0), failed(false)
+{
+    uint32_t one = 1;
+    if (*reinterpret_cast<unsigned char *>(&one) != 1) {
+        cerr << "Binary task files are only supported on little-endian systems." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat file_status;
+    if (fd != -1 && fstat(fd, &file_status) == 0 && file_status.st_size > 0) {
+        void *data = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            file_data = static_cast<const unsigned char *>(data);
+            file_size = file_status.st_size;
+        }
+    }
+    if (fd != -1)
+        close(fd);
+#endif
+    if (!file_data) {
+        ifstream in(filename, ios::binary);
+        file_copy.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        file_data = file_copy.data();
+        file_size = file_copy.size();
+    }
+
+    uint32_t version = 0, string_bytes = 0;
+    if (file_size >= HEADER_BYTES) {
+        memcpy(&version, file_data + sizeof(MAGIC), sizeof(version));
+        memcpy(&string_bytes, file_data + sizeof(MAGIC) + sizeof(version), sizeof(string_bytes));
+    }
+    if (file_size < HEADER_BYTES || memcmp(file_data, MAGIC, sizeof(MAGIC)) != 0) {
+        cerr << "Error reading the binary task file " << filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (version != VERSION) {
+        cerr << "Binary task file " << filename << " has version " << version
+             << ", but version " << VERSION << " is expected. Translate the task again." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    size_t words_begin = HEADER_BYTES + (string_bytes + 3) / 4 * 4;
+    if (words_begin > file_size) {
+        cerr << "Error reading the binary task file " << filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    strings = reinterpret_cast<const char *>(file_data + HEADER_BYTES);
+    strings_size = string_bytes;
+    words = reinterpret_cast<const int32_t *>(file_data + words_begin);
+    num_words = (file_size - words_begin) / sizeof(int32_t);
+
+    domain_name = next_string();
+    task_name = next_string();
+    if (failed) {
+        cerr << "Error reading the binary task file " << filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+BinaryTaskFile::~BinaryTaskFile()
+{
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (file_copy.empty() && file_data)
+        munmap(const_cast<unsigned char *>(file_data), file_size);
+#endif
+}
+
+int BinaryTaskFile::next_int()
+{
+    if (position == num_words) {
+        failed = true;
+        return 0;
+    }
+    return words[position++];
+}
+
+string BinaryTaskFile::next_string()
+{
+    size_t offset = next_int();
+    size_t length = next_int();
+    if (offset > strings_size || length > strings_size - offset) {
+        failed = true;
+        return string();
+    }
+    return string(strings + offset, length);
+}
+
+void BinaryTaskFile::copy_next_n_ints(int n, vector<int> &v)
+{
+    if (n < 0 || size_t(n) > num_words - position) {
+        failed = true;
+        return;
+    }
+    v.insert(v.end(), words + position, words + position + n);
+    position += n;
+}
+
+bool BinaryTaskFile::read_section(int expected, const string &name, int &size)
+{
+    int section = next_int();
+    size = next_int();
+    if (failed || section != expected || size < 0) {
+        cerr << "Error while reading " << name << " section." << endl;
+        return false;
+    }
+    return true;
+}
+
+bool BinaryTaskFile::load(Task &task)
+{
+    int number_types;
+    if (not read_section(TYPES, "TYPES", number_types)) {
+        return false;
+    }
+    cout << "Total number of types: " << number_types << endl;
+    load_types(task, number_types);
+
+    int number_predicates;
+    if (not read_section(PREDICATES, "PREDICATES", number_predicates)) {
+        return false;
+    }
+    cout << "Total number of predicates: " << number_predicates << endl;
+    load_predicates(task, number_predicates);
+
+    int number_objects;
+    if (not read_section(OBJECTS, "OBJECTS", number_objects)) {
+        return false;
+    }
+    cout << "Total number of objects: " << number_objects << endl;
+    load_objects(task, number_objects);
+
+    int initial_state_size;
+    if (not read_section(INITIAL_STATE, "INITIAL-STATE", initial_state_size)) {
+        return false;
+    }
+    cout << "Total number of atoms in the initial state: " << initial_state_size << endl;
+    task.create_empty_initial_state(task.predicates.size());
+    load_initial_state(task, initial_state_size);
+
+    int goal_size;
+    if (not read_section(GOAL, "GOAL", goal_size)) {
+        return false;
+    }
+    cout << "Total number of fluent atoms in the goal state: " << goal_size << endl;
+    load_goal(task, goal_size);
+
+    int number_action_schemas;
+    if (not read_section(ACTION_SCHEMAS, "ACTION-SCHEMAS", number_action_schemas)) {
+        return false;
+    }
+    cout << "Total number of action schemas: " << number_action_schemas << endl;
+    load_action_schemas(task, number_action_schemas);
+
+    if (failed) {
+        cerr << "Binary task file " << filename << " ended unexpectedly." << endl;
+        return false;
+    }
+    return true;
+}
+
+void BinaryTaskFile::load_types(Task &task, int number_types)
+{
+    for (int i = 0; i < number_types && !failed; ++i) {
+        task.add_type(next_string());
+    }
+}
+
+void BinaryTaskFile::load_predicates(Task &task, int number_predicates)
+{
+    for (int j = 0; j < number_predicates && !failed; ++j) {
+        string predicate_name = next_string();
+        int index = next_int();
+        int number_args = next_int();
+        bool static_pred = next_int();
+        if (number_args == 0) {
+            task.nullary_predicates.insert(index);
+        }
+        vector<int> types;
+        copy_next_n_ints(number_args, types);
+        task.add_predicate(predicate_name, index, number_args, static_pred, types);
+    }
+}
+
+void BinaryTaskFile::load_objects(Task &task, int number_objects)
+{
+    for (int i = 0; i < number_objects && !failed; ++i) {
+        string name = next_string();
+        int index = next_int();
+        int n = next_int();
+        vector<int> types;
+        copy_next_n_ints(n, types);
+        task.add_object(name, index, types);
+    }
+}
+
+void BinaryTaskFile::load_initial_state(Task &task, int initial_state_size)
+{
+    int number_predicates = task.predicates.size();
+    vector<int> args;
+    for (int i = 0; i < initial_state_size && !failed; ++i) {
+        next_int();  // index of the atom
+        int predicate_index = next_int();
+        next_int();  // negated
+        int number_args = next_int();
+        if (predicate_index < 0 || predicate_index >= number_predicates) {
+            failed = true;
+            return;
+        }
+        if (number_args == 0) {
+            task.initial_state.set_nullary_atom(predicate_index, true);
+        }
+        args.clear();
+        copy_next_n_ints(number_args, args);
+        if (!task.initial_state.get_nullary_atoms()[predicate_index]) {
+            if (!task.predicates[predicate_index].isStaticPredicate())
+                task.initial_state.add_tuple(predicate_index, args);
+            else
+                task.static_info.add_tuple(predicate_index, args);
+        }
+    }
+}
+
+void BinaryTaskFile::load_goal(Task &task, int goal_size)
+{
+    vector<AtomicGoal> goals;
+    unordered_set<int> positive_nullary_goals, negative_nullary_goals;
+    for (int i = 0; i < goal_size && !failed; ++i) {
+        int predicate_index = next_int();
+        bool negated = next_int();
+        int number_args = next_int();
+        if (number_args == 0) {
+            if (negated)
+                negative_nullary_goals.insert(predicate_index);
+            else
+                positive_nullary_goals.insert(predicate_index);
+            continue;
+        }
+        vector<int> args;
+        copy_next_n_ints(number_args, args);
+        goals.emplace_back(predicate_index, args, negated);
+    }
+    task.create_goal_condition(goals, positive_nullary_goals, negative_nullary_goals);
+}
+
+void BinaryTaskFile::load_action_schemas(Task &task, int number_action_schemas)
+{
+    vector<ActionSchema> actions;
+    for (int i = 0; i < number_action_schemas && !failed; ++i) {
+        string name = next_string();
+        int cost = next_int();
+        int args = next_int();
+        int precond_size = next_int();
+        int eff_size = next_int();
+        vector<Parameter> parameters;
+        vector<Atom> preconditions, static_preconditions, effects;
+        vector<bool> positive_nul_precond(task.predicates.size(), false),
+            negative_nul_precond(task.predicates.size(), false),
+            positive_nul_eff(task.predicates.size(), false),
+            negative_nul_eff(task.predicates.size(), false);
+        for (int j = 0; j < args && !failed; ++j) {
+            string param_name = next_string();
+            int index = next_int();
+            int type = next_int();
+            parameters.emplace_back(param_name, index, type);
+        }
+        // Preconditions and effects have the same layout
+        for (int j = 0; j < precond_size + eff_size && !failed; ++j) {
+            bool is_precondition = j < precond_size;
+            string atom_name = next_string();
+            int index = next_int();
+            bool negated = next_int();
+            int arguments_size = next_int();
+            vector<Argument> arguments;
+            for (int k = 0; k < arguments_size && !failed; ++k) {
+                bool is_constant = next_int();
+                int obj_index = next_int();
+                arguments.emplace_back(obj_index, is_constant);
+            }
+            if (index < 0 || size_t(index) >= task.predicates.size()) {
+                failed = true;
+                break;
+            }
+            if (arguments_size == 0) {
+                if (is_precondition) {
+                    if (!negated)
+                        positive_nul_precond[index] = true;
+                    else
+                        negative_nul_precond[index] = true;
+                }
+                else {
+                    if (!negated)
+                        positive_nul_eff[index] = true;
+                    else
+                        negative_nul_eff[index] = true;
+                }
+            }
+            else if (!is_precondition) {
+                effects.emplace_back(std::move(arguments), std::move(atom_name), index, negated);
+            }
+            else if (boost::iequals(atom_name, "=")) {
+                static_preconditions.emplace_back(std::move(arguments), std::move(atom_name),
+                                                  index, negated);
+            }
+            else {
+                preconditions.emplace_back(std::move(arguments), std::move(atom_name), index, negated);
+            }
+        }
+        ActionSchema a(name,
+                       i,
+                       cost,
+                       parameters,
+                       preconditions,
+                       effects,
+                       static_preconditions,
+                       positive_nul_precond,
+                       negative_nul_precond,
+                       positive_nul_eff,
+                       negative_nul_eff);
+        actions.push_back(a);
+    }
+    task.initialize_action_schemas(actions);
+}
@@ -0,0 +1,70 @@
+#ifndef SEARCH_BINARY_TASK_H
+#define SEARCH_BINARY_TASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Task;
+
+/**
+ * @brief Task file in the binary format written by the translator with
+ * --binary-output (see src/translator/binary_task.py for the layout).
+ *
+ * @details The file is mapped into memory and read in place: numbers are
+ * 32-bit integers in the order the tables are built, and names point into a
+ * string table, so loading the task does not tokenize anything. The text
+ * parser (parser.h) stays the default for text files.
+ */
+class BinaryTaskFile {
+    static const char MAGIC[8];
+    static const std::uint32_t VERSION = 1;
+
+    std::string filename;
+    const unsigned char *file_data;
+    std::size_t file_size;
+    // Only used if the file cannot be mapped into memory
+    std::vector<unsigned char> file_copy;
+
+    const char *strings;
+    std::size_t strings_size;
+    const std::int32_t *words;
+    std::size_t num_words;
+    std::size_t position;
+    bool failed;
+
+    std::string domain_name;
+    std::string task_name;
+
+    int next_int();
+    std::string next_string();
+    void copy_next_n_ints(int n, std::vector<int> &v);
+    bool read_section(int expected, const std::string &name, int &size);
+
+    void load_types(Task &task, int number_types);
+    void load_predicates(Task &task, int number_predicates);
+    void load_objects(Task &task, int number_objects);
+    void load_initial_state(Task &task, int initial_state_size);
+    void load_goal(Task &task, int goal_size);
+    void load_action_schemas(Task &task, int number_action_schemas);
+
+public:
+    explicit BinaryTaskFile(const std::string &filename);
+    ~BinaryTaskFile();
+
+    BinaryTaskFile(const BinaryTaskFile &) = delete;
+    BinaryTaskFile &operator=(const BinaryTaskFile &) = delete;
+
+    //! Return true if the file starts with the magic bytes of the binary format
+    static bool is_binary_task_file(const std::string &filename);
+
+    const std::string &get_domain_name() const { return domain_name; }
+
+    const std::string &get_task_name() const { return task_name; }
+
+    //! Fill the task, which must be empty. Return false if the file is malformed.
+    bool load(Task &task);
+};
+
+#endif  // SEARCH_BINARY_TASK_H
@@ -1,26 +1,28 @@
 #include "hash_join.h"
 #include "../hash_structures.h"
+#include "join_arena.h"
+#include "join_keys.h"
 #include "table.h"
 #include "utils.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <unordered_map>
 
 #include <iostream>
 
 using namespace std;
 
-std::vector<int> project_tuple(
-    const std::vector<int>& tuple,
-    const std::vector<int>& pattern)
+static void project_tuple(
+    const int *tuple,
+    const std::vector<int>& pattern,
+    std::vector<int>& projected)
 {
     auto sz = pattern.size();
-    vector<int> projected(sz);
     for (size_t i = 0; i < sz; ++i) {
         projected[i] = tuple[pattern[i]];
     }
-    return projected;
 }
 
 vector<int> ptr_project_tuple(
@@ -45,63 +47,185 @@ void hash_join(Table &t1, const Table &t2) {
      * 3. Otherwise, we loop over the first table, create a hash over the
      *    matching keys. Then, loop over the second table searching for hits
      *    in the hash table.
+     *
+     * The hash map only stores row numbers of t1, and keys are computed into
+     * a reused buffer, so no memory is allocated per tuple.
      */
     std::vector<int> matches1, matches2;
     compute_matching_columns(t1, t2, matches1, matches2);
     assert(matches1.size()==matches2.size());
 
-    vector<vector<int>> new_tuples;
+    const size_t arity1 = t1.arity();
+    const size_t arity2 = t2.arity();
+    const size_t size1 = t1.size();
+    const size_t size2 = t2.size();
+
+    vector<int> new_values;
     if (matches1.empty()) {
         /*
          * If no attribute matches, then we apply a cartesian product
          * TODO this code is duplicate from join.cc, make it an auxiliary function
          */
-        t1.tuple_index.insert(t1.tuple_index.end(), t2.tuple_index.begin(), t2.tuple_index.end());
-        for (const vector<int> &tuple_t1 : t1.tuples) {
-            for (const vector<int> &tuple_t2 : t2.tuples) {
-                vector<int> aux(tuple_t1);
-                aux.insert(aux.end(), tuple_t2.begin(), tuple_t2.end());
-                new_tuples.push_back(std::move(aux));
+        new_values.reserve(size1 * size2 * (arity1 + arity2));
+        for (size_t i = 0; i < size1; ++i) {
+            const int *tuple_t1 = t1.row(i);
+            for (size_t j = 0; j < size2; ++j) {
+                const int *tuple_t2 = t2.row(j);
+                new_values.insert(new_values.end(), tuple_t1, tuple_t1 + arity1);
+                new_values.insert(new_values.end(), tuple_t2, tuple_t2 + arity2);
             }
         }
+        t1.tuple_index.insert(t1.tuple_index.end(), t2.tuple_index.begin(), t2.tuple_index.end());
     }
     else {
-        unordered_map<vector<int>, vector<vector<int>>, TupleHash> hash_join_map;
+        unordered_map<vector<int>, vector<int>, TupleHash> hash_join_map;
+        hash_join_map.reserve(size1);
+        vector<int> key(matches1.size());
         // Build phase
-        for (const vector<int> &tuple : t1.tuples) {
-            hash_join_map[project_tuple(tuple, matches1)].push_back(tuple);
+        for (size_t i = 0; i < size1; ++i) {
+            project_tuple(t1.row(i), matches1, key);
+            hash_join_map[key].push_back(i);
         }
 
         // Remove duplicated index. Duplicate code from join.cc
-        vector<bool> to_remove(t2.tuple_index.size(), false);
+        vector<bool> to_remove(arity2, false);
         for (const auto &m : matches2) {
             to_remove[m] = true;
         }
-
-        for (size_t j = 0; j < t2.tuple_index.size(); ++j) {
+        vector<int> kept_columns;
+        for (size_t j = 0; j < arity2; ++j) {
             if (!to_remove[j]) {
-                t1.tuple_index.push_back(t2.tuple_index[j]);
+                kept_columns.push_back(j);
             }
         }
 
         // Probe phase
-        for (vector<int> tuple : t2.tuples) {
-
-            auto it = hash_join_map.find(project_tuple(tuple, matches2));
+        for (size_t j = 0; j < size2; ++j) {
+            const int *tuple = t2.row(j);
+            project_tuple(tuple, matches2, key);
+            auto it = hash_join_map.find(key);
 
             if (it != hash_join_map.end()) {
-                const auto& matching_tuples = it->second;
-                for (vector<int> t:matching_tuples) {
-                    for (unsigned j = 0; j < to_remove.size(); ++j) {
-                        if (!to_remove[j]) t.push_back(tuple[j]);
+                for (int i : it->second) {
+                    const int *t = t1.row(i);
+                    new_values.insert(new_values.end(), t, t + arity1);
+                    for (int c : kept_columns) {
+                        new_values.push_back(tuple[c]);
+                    }
+                }
+            }
+        }
+
+        for (int c : kept_columns) {
+            t1.tuple_index.push_back(t2.tuple_index[c]);
+        }
+    }
+    t1.values = std::move(new_values);
+}
+
+void hash_join(Table &t1, const Table &t2, JoinArena &arena) {
+    /*
+     * Same algorithm as hash_join(t1, t2), but the hash table uses open
+     * addressing with linear probing over integer-packed keys. Each slot
+     * points to the first row of t1 with its key; the remaining rows with the
+     * same key are chained through arena.next_row. All buffers belong to the
+     * arena, so they are reused across joins.
+     */
+    std::vector<int> matches1, matches2;
+    compute_matching_columns(t1, t2, matches1, matches2);
+    assert(matches1.size()==matches2.size());
+
+    const size_t arity1 = t1.arity();
+    const size_t arity2 = t2.arity();
+    const size_t size1 = t1.size();
+    const size_t size2 = t2.size();
+
+    vector<int> &new_values = arena.output;
+    new_values.clear();
+    if (matches1.empty()) {
+        new_values.reserve(size1 * size2 * (arity1 + arity2));
+        for (size_t i = 0; i < size1; ++i) {
+            const int *tuple_t1 = t1.row(i);
+            for (size_t j = 0; j < size2; ++j) {
+                const int *tuple_t2 = t2.row(j);
+                new_values.insert(new_values.end(), tuple_t1, tuple_t1 + arity1);
+                new_values.insert(new_values.end(), tuple_t2, tuple_t2 + arity2);
+            }
+        }
+        t1.tuple_index.insert(t1.tuple_index.end(), t2.tuple_index.begin(), t2.tuple_index.end());
+    }
+    else {
+        const bool exact_keys = is_exact_key(matches1);
+        size_t capacity = 16;
+        while (capacity < 2 * size1) {
+            capacity <<= 1;
+        }
+        const size_t mask = capacity - 1;
+        arena.slot_keys.assign(capacity, 0);
+        arena.slot_heads.assign(capacity, -1);
+        arena.next_row.assign(size1, -1);
+
+        // Build phase. Rows are inserted backwards so that every chain lists
+        // its rows in increasing order, as hash_join(t1, t2) does.
+        for (size_t i = size1; i-- > 0;) {
+            const int *tuple = t1.row(i);
+            uint64_t key = pack_key(tuple, matches1);
+            size_t slot = key_to_slot(key, mask);
+            while (true) {
+                int head = arena.slot_heads[slot];
+                if (head == -1) {
+                    arena.slot_keys[slot] = key;
+                    arena.slot_heads[slot] = i;
+                    break;
+                }
+                if (arena.slot_keys[slot] == key
+                    && (exact_keys || same_key(t1.row(head), matches1, tuple, matches1))) {
+                    arena.next_row[i] = head;
+                    arena.slot_heads[slot] = i;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        vector<bool> to_remove(arity2, false);
+        for (const auto &m : matches2) {
+            to_remove[m] = true;
+        }
+        arena.kept_columns.clear();
+        for (size_t j = 0; j < arity2; ++j) {
+            if (!to_remove[j]) {
+                arena.kept_columns.push_back(j);
+            }
+        }
+
+        // Probe phase
+        for (size_t j = 0; j < size2; ++j) {
+            const int *tuple = t2.row(j);
+            uint64_t key = pack_key(tuple, matches2);
+            size_t slot = key_to_slot(key, mask);
+            for (int head = arena.slot_heads[slot]; head != -1; head = arena.slot_heads[slot]) {
+                if (arena.slot_keys[slot] == key
+                    && (exact_keys || same_key(t1.row(head), matches1, tuple, matches2))) {
+                    for (int r = head; r != -1; r = arena.next_row[r]) {
+                        const int *t = t1.row(r);
+                        new_values.insert(new_values.end(), t, t + arity1);
+                        for (int c : arena.kept_columns) {
+                            new_values.push_back(tuple[c]);
+                        }
                     }
-                    new_tuples.push_back(std::move(t));
+                    break;
                 }
+                slot = (slot + 1) & mask;
             }
         }
 
+        for (int c : arena.kept_columns) {
+            t1.tuple_index.push_back(t2.tuple_index[c]);
+        }
     }
-    t1.tuples = std::move(new_tuples);
+    // The old buffer of t1 goes back to the arena and is reused by the next join
+    t1.values.swap(new_values);
 }
 
 void collect_indices(const PtrTable &table, const vector<int> &indices, unordered_set<shared_ptr<vector<int>>, PtrTupleHash, PtrTupleEq> &new_tuples){
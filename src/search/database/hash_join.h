@@ -3,6 +3,7 @@
 
 #include <vector>
 
+class JoinArena;
 class Table;
 class PtrTable;
 
@@ -19,6 +20,17 @@ class PtrTable;
  */
 void hash_join(Table &t1, const Table &t2);
 
+/**
+ * @brief Hash join with an open-addressing table over integer-packed join keys.
+ *
+ * @details Produces exactly the same table as hash_join(t1, t2), in the same
+ * order. The hash table, the row chains and the output buffer are taken from
+ * the arena, which keeps their capacity between calls.
+ *
+ * @see join_arena.h
+ */
+void hash_join(Table &t1, const Table &t2, JoinArena &arena);
+
 void ptr_hash_join(PtrTable &t1, const PtrTable &t2, const std::vector<int> &relevant_args);
 
 #endif //SEARCH_HASH_JOIN_H
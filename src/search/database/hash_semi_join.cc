@@ -14,41 +14,33 @@ using namespace std;
 size_t hash_semi_join(Table &t1, const Table &t2) {
     auto matches = compute_matching_columns(t1, t2);
 
-    vector<vector<int>> new_tuples;
     if (matches.empty()) {
         /*
          * If no attribute matches, then we return
          */
-        return t1.tuples.size();
+        return t1.size();
     }
     else {
         /*
          * Otherwise, we perform the join and the projection
          */
-        unordered_map<vector<int>, unordered_set<vector<int>, TupleHash>, TupleHash> hash_join_map;
+        unordered_set<vector<int>, TupleHash> hash_join_keys;
+        vector<int> key(matches.size());
         // Build phase
-        for (const vector<int> &tuple : t2.tuples) {
-            vector<int> key(matches.size());
+        for (size_t j = 0; j < t2.size(); ++j) {
+            const int *tuple = t2.row(j);
             for (size_t i = 0; i < matches.size(); i++) {
                 key[i] = tuple[matches[i].second];
             }
-            hash_join_map[key].insert(tuple);
+            hash_join_keys.insert(key);
         }
 
-        for (const vector<int> &tuple : t1.tuples) {
-            vector<int> key(matches.size());
+        t1.filter_tuples([&](const int *tuple) {
             for (size_t i = 0; i < matches.size(); i++) {
                 key[i] = tuple[matches[i].first];
             }
-            if (hash_join_map.count(key) > 0) {
-                new_tuples.push_back(tuple);
-            }
-        }
+            return hash_join_keys.count(key) > 0;
+        });
     }
-    t1.tuples = std::move(new_tuples);
-    return t1.tuples.size();
+    return t1.size();
 }
-
-
-
-
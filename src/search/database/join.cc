@@ -30,41 +30,48 @@ void join(Table &t1, Table &t2) {
      */
     auto matches = compute_matching_columns(t1, t2);
 
-    vector<vector<int>> new_tuples;
+    const size_t arity1 = t1.arity();
+    const size_t arity2 = t2.arity();
+    const size_t size1 = t1.size();
+    const size_t size2 = t2.size();
+
+    vector<int> new_values;
     if (matches.empty()) {
         /*
          * If no attribute matches, then we apply a cartesian product
          */
-        t1.tuple_index.insert(t1.tuple_index.end(), t2.tuple_index.begin(), t2.tuple_index.end());
-        for (const vector<int>& tuple_t1 : t1.tuples) {
-            for (const vector<int> &tuple_t2 : t2.tuples) {
-                vector<int> aux(tuple_t1);
-                aux.insert(aux.end(), tuple_t2.begin(), tuple_t2.end());
-                new_tuples.push_back(aux);
+        new_values.reserve(size1 * size2 * (arity1 + arity2));
+        for (size_t i = 0; i < size1; ++i) {
+            const int *tuple_t1 = t1.row(i);
+            for (size_t j = 0; j < size2; ++j) {
+                const int *tuple_t2 = t2.row(j);
+                new_values.insert(new_values.end(), tuple_t1, tuple_t1 + arity1);
+                new_values.insert(new_values.end(), tuple_t2, tuple_t2 + arity2);
             }
         }
+        t1.tuple_index.insert(t1.tuple_index.end(), t2.tuple_index.begin(), t2.tuple_index.end());
     }
     else {
         /*
          * Otherwise, we perform the join and the projection
          */
 
-
-        // We perform a reverse removal procedure so we avoid indexation problems.
-        // We also reuse the "to_remove" vector when we are removing elements from the matched arguments.
-        vector<int> to_remove;
-        to_remove.reserve(matches.size());
+        // Columns of t2 that are not joined are appended to the tuples of t1
+        vector<bool> to_remove(arity2, false);
         for (const pair<int, int> &m : matches) {
-            to_remove.push_back(m.second);
+            to_remove[m.second] = true;
         }
-        sort(to_remove.begin(), to_remove.end());
-        for (int i = to_remove.size()-1; i >= 0 ; --i) {
-            t2.tuple_index.erase(t2.tuple_index.begin()+to_remove[i]);
+        vector<int> kept_columns;
+        for (size_t j = 0; j < arity2; ++j) {
+            if (!to_remove[j]) {
+                kept_columns.push_back(j);
+            }
         }
-        t1.tuple_index.insert(t1.tuple_index.end(), t2.tuple_index.begin(), t2.tuple_index.end());
 
-        for (const vector<int> &tuple_t1 : t1.tuples) {
-            for (vector<int> tuple_t2 : t2.tuples) {
+        for (size_t i = 0; i < size1; ++i) {
+            const int *tuple_t1 = t1.row(i);
+            for (size_t j = 0; j < size2; ++j) {
+                const int *tuple_t2 = t2.row(j);
                 bool match = true;
                 for (const pair<int, int> &m : matches) {
                     if (tuple_t1[m.first] != tuple_t2[m.second]) {
@@ -73,19 +80,17 @@ void join(Table &t1, Table &t2) {
                     }
                 }
                 if (match) {
-                    // Code duplicate from the remove above
-                    for (int i = to_remove.size()-1; i >= 0 ; --i) {
-                        tuple_t2.erase(tuple_t2.begin()+to_remove[i]);
+                    new_values.insert(new_values.end(), tuple_t1, tuple_t1 + arity1);
+                    for (int c : kept_columns) {
+                        new_values.push_back(tuple_t2[c]);
                     }
-                    vector<int> aux(tuple_t1);
-                    aux.insert(aux.end(), tuple_t2.begin(), tuple_t2.end());
-                    new_tuples.push_back(aux);
                 }
             }
         }
+
+        for (int c : kept_columns) {
+            t1.tuple_index.push_back(t2.tuple_index[c]);
+        }
     }
-    t1.tuples = std::move(new_tuples);
+    t1.values = std::move(new_values);
 }
-
-
-
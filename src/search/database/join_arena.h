@@ -0,0 +1,49 @@
+#ifndef SEARCH_JOIN_ARENA_H
+#define SEARCH_JOIN_ARENA_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Scratch memory used by the open-addressing hash join and the index join.
+ *
+ * @details The buffers grow to the largest join seen so far and are never
+ * shrunk: reset() only forgets their content. Successor generators keep one
+ * arena per action schema and reset it before instantiating the schema in a
+ * new state, so joins do not allocate once the arena is warm.
+ *
+ * @see database/hash_join.h
+ * @see database/static_table_index.h
+ */
+class JoinArena {
+public:
+    /// @var slot_keys: integer-packed join key stored in each slot of the table
+    std::vector<std::uint64_t> slot_keys;
+    /// @var slot_heads: first row of the build table with the key of the slot, -1 if empty
+    std::vector<int> slot_heads;
+    /// @var next_row: next row of the build table with the same key, -1 at the end
+    std::vector<int> next_row;
+    /// @var kept_columns: columns of the probe table appended to the result
+    std::vector<int> kept_columns;
+    /// @var output: buffer receiving the joined tuples, swapped with the working table
+    std::vector<int> output;
+    /// @var matches: pairs (row of the indexed table << 32 | row of the working table) of an index join
+    std::vector<std::uint64_t> matches;
+    /// @var sorted_matches: the matches ordered by row of the indexed table
+    std::vector<std::uint64_t> sorted_matches;
+    /// @var row_offsets: position of the matches of each row of the indexed table in sorted_matches
+    std::vector<int> row_offsets;
+
+    void reset() {
+        slot_keys.clear();
+        slot_heads.clear();
+        next_row.clear();
+        kept_columns.clear();
+        output.clear();
+        matches.clear();
+        sorted_matches.clear();
+        row_offsets.clear();
+    }
+};
+
+#endif //SEARCH_JOIN_ARENA_H
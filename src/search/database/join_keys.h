@@ -0,0 +1,53 @@
+#ifndef SEARCH_JOIN_KEYS_H
+#define SEARCH_JOIN_KEYS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Integer-packed join keys shared by the open-addressing hash tables of the
+ * join operators.
+ */
+
+/*
+ * Pack the values of the given columns into a 64-bit key. Keys of up to two
+ * columns are packed exactly; wider keys are hashed, so tuples with equal keys
+ * still need to be compared column by column.
+ */
+inline std::uint64_t pack_key(const int *tuple, const std::vector<int> &columns) {
+    if (columns.size() == 1) {
+        return static_cast<std::uint32_t>(tuple[columns[0]]);
+    }
+    if (columns.size() == 2) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(tuple[columns[0]])) << 32)
+            | static_cast<std::uint32_t>(tuple[columns[1]]);
+    }
+    std::uint64_t key = 0xcbf29ce484222325ULL;
+    for (int c : columns) {
+        key = (key ^ static_cast<std::uint32_t>(tuple[c])) * 0x100000001b3ULL;
+    }
+    return key;
+}
+
+inline bool is_exact_key(const std::vector<int> &columns) {
+    return columns.size() <= 2;
+}
+
+inline std::size_t key_to_slot(std::uint64_t key, std::size_t mask) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key & mask;
+}
+
+inline bool same_key(const int *tuple1, const std::vector<int> &columns1,
+                     const int *tuple2, const std::vector<int> &columns2) {
+    for (std::size_t i = 0; i < columns1.size(); ++i) {
+        if (tuple1[columns1[i]] != tuple2[columns2[i]])
+            return false;
+    }
+    return true;
+}
+
+#endif //SEARCH_JOIN_KEYS_H
@@ -23,18 +23,12 @@ void project(Table &t, const std::unordered_set<int> &over) {
                 matches.push_back(i);
 
     unordered_set<vector<int>, TupleHash> keys;
-    vector<vector<int>> new_tuples;
+    vector<int> key(matches.size());
 
-    for (const vector<int> &tuple : t.tuples) {
-        vector<int> key(matches.size());
+    t.filter_tuples([&](const int *tuple) {
         for (size_t i = 0; i < matches.size(); i++) {
             key[i] = tuple[matches[i]];
         }
-        if (keys.count(key) == 0) {
-            keys.insert(key);
-            new_tuples.push_back(tuple);
-        }
-    }
-
-    t.tuples = new_tuples;
+        return keys.insert(key).second;
+    });
 }
@@ -27,10 +27,11 @@ size_t semi_join(Table &t1, const Table &t2) {
         return t1.tuple_index.size();
     }
 
-    // Otherwise, we perform the join and the projection
-    vector<vector<int>> new_tuples;
-    for (const vector<int> &tuple_t1 : t1.tuples) {
-        for (const vector<int> &tuple_t2 : t2.tuples) {
+    // Otherwise, we perform the semi-join keeping the surviving tuples in place
+    const size_t size2 = t2.size();
+    t1.filter_tuples([&](const int *tuple_t1) {
+        for (size_t j = 0; j < size2; ++j) {
+            const int *tuple_t2 = t2.row(j);
             bool match = true;
             for (const pair<int, int>& m : matches) {
                 if (tuple_t1[m.first] != tuple_t2[m.second]) {
@@ -40,13 +41,12 @@ size_t semi_join(Table &t1, const Table &t2) {
             }
             if (match) {
                 // If a tuple matches at least one other tuple, then it is sufficient for the semi-join
-                new_tuples.push_back(tuple_t1);
-                break;
+                return true;
             }
         }
-    }
-    t1.tuples = std::move(new_tuples);
-    return t1.tuples.size();
+        return false;
+    });
+    return t1.size();
 }
 
 
@@ -0,0 +1,154 @@
+#include "static_table_index.h"
+
+#include "join_arena.h"
+#include "join_keys.h"
+#include "table.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace std;
+
+StaticTableIndex::StaticTableIndex(const Table &table, vector<int> key_columns)
+    : key_columns(std::move(key_columns))
+{
+    const vector<int> &columns = this->key_columns;
+    assert(!columns.empty());
+    sorted_rows.resize(table.size());
+    iota(sorted_rows.begin(), sorted_rows.end(), 0);
+    stable_sort(sorted_rows.begin(), sorted_rows.end(), [&](int r1, int r2) {
+        const int *t1 = table.row(r1);
+        const int *t2 = table.row(r2);
+        for (int c : columns) {
+            if (t1[c] != t2[c])
+                return t1[c] < t2[c];
+        }
+        return false;
+    });
+
+    size_t capacity = 16;
+    while (capacity < 2 * sorted_rows.size()) {
+        capacity <<= 1;
+    }
+    mask = capacity - 1;
+    slot_keys.assign(capacity, 0);
+    slot_begin.assign(capacity, -1);
+    slot_end.assign(capacity, -1);
+
+    // Every run is inserted once, so keys are never found twice in the directory
+    size_t begin = 0;
+    while (begin < sorted_rows.size()) {
+        const int *tuple = table.row(sorted_rows[begin]);
+        size_t end = begin + 1;
+        while (end < sorted_rows.size() && same_key(table.row(sorted_rows[end]), columns, tuple, columns)) {
+            ++end;
+        }
+        uint64_t key = pack_key(tuple, columns);
+        size_t slot = key_to_slot(key, mask);
+        while (slot_begin[slot] != -1) {
+            slot = (slot + 1) & mask;
+        }
+        slot_keys[slot] = key;
+        slot_begin[slot] = begin;
+        slot_end[slot] = end;
+        begin = end;
+    }
+}
+
+pair<const int *, const int *> StaticTableIndex::find(const Table &table,
+                                                      const int *tuple,
+                                                      const vector<int> &columns) const
+{
+    assert(columns.size() == key_columns.size());
+    const bool exact_keys = is_exact_key(key_columns);
+    uint64_t key = pack_key(tuple, columns);
+    for (size_t slot = key_to_slot(key, mask); slot_begin[slot] != -1; slot = (slot + 1) & mask) {
+        if (slot_keys[slot] == key
+            && (exact_keys
+                || same_key(table.row(sorted_rows[slot_begin[slot]]), key_columns, tuple, columns))) {
+            return {sorted_rows.data() + slot_begin[slot], sorted_rows.data() + slot_end[slot]};
+        }
+    }
+    return {nullptr, nullptr};
+}
+
+void index_join(Table &t1,
+                const Table &t2,
+                const StaticTableIndex &index,
+                const vector<int> &probe_columns,
+                JoinArena &arena)
+{
+    const size_t arity1 = t1.arity();
+    const size_t size1 = t1.size();
+    const size_t size2 = t2.size();
+
+    // Probe phase
+    vector<uint64_t> &matches = arena.matches;
+    matches.clear();
+    for (size_t i = 0; i < size1; ++i) {
+        auto [first, last] = index.find(t2, t1.row(i), probe_columns);
+        for (const int *r = first; r != last; ++r) {
+            matches.push_back((static_cast<uint64_t>(*r) << 32) | i);
+        }
+    }
+
+    /*
+     * hash_join(t1, t2, arena) lists the matches by row of t2, and then by row
+     * of t1. Matches are found by row of t1, so they are sorted again: by a
+     * counting sort if t2 is not much larger than the number of matches, and
+     * by comparison otherwise.
+     */
+    if (size2 <= 16 * matches.size()) {
+        arena.row_offsets.assign(size2 + 1, 0);
+        for (uint64_t m : matches) {
+            ++arena.row_offsets[(m >> 32) + 1];
+        }
+        partial_sum(arena.row_offsets.begin(), arena.row_offsets.end(), arena.row_offsets.begin());
+        arena.sorted_matches.resize(matches.size());
+        for (uint64_t m : matches) {
+            arena.sorted_matches[arena.row_offsets[m >> 32]++] = m;
+        }
+        matches.swap(arena.sorted_matches);
+    }
+    else {
+        sort(matches.begin(), matches.end());
+    }
+
+    const vector<int> &key_columns = index.get_key_columns();
+    arena.kept_columns.clear();
+    for (size_t j = 0; j < t2.arity(); ++j) {
+        if (find(key_columns.begin(), key_columns.end(), j) == key_columns.end()) {
+            arena.kept_columns.push_back(j);
+        }
+    }
+
+    vector<int> &new_values = arena.output;
+    new_values.clear();
+    new_values.reserve(matches.size() * (arity1 + arena.kept_columns.size()));
+    for (uint64_t m : matches) {
+        const int *t = t1.row(m & 0xffffffffULL);
+        const int *tuple = t2.row(m >> 32);
+        new_values.insert(new_values.end(), t, t + arity1);
+        for (int c : arena.kept_columns) {
+            new_values.push_back(tuple[c]);
+        }
+    }
+
+    for (int c : arena.kept_columns) {
+        t1.tuple_index.push_back(t2.tuple_index[c]);
+    }
+    t1.values.swap(new_values);
+}
+
+size_t index_semi_join(Table &t1,
+                       const Table &t2,
+                       const StaticTableIndex &index,
+                       const vector<int> &probe_columns)
+{
+    t1.filter_tuples([&](const int *tuple) {
+        auto range = index.find(t2, tuple, probe_columns);
+        return range.first != range.second;
+    });
+    return t1.size();
+}
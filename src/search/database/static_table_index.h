@@ -0,0 +1,88 @@
+#ifndef SEARCH_STATIC_TABLE_INDEX_H
+#define SEARCH_STATIC_TABLE_INDEX_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class JoinArena;
+class Table;
+
+/**
+ * @brief Persistent index over some columns of a table that never changes,
+ * such as the precompiled table of a static precondition.
+ *
+ * @details The rows of the table are sorted by their values in the key
+ * columns (sorted index), so the rows sharing a key form a contiguous run in
+ * increasing row order. An open-addressing hash directory over integer-packed
+ * keys maps each key to its run (hash index). Probing a key thus costs one
+ * lookup, and neither the table nor a hash table over it is rebuilt for each
+ * join.
+ *
+ * The index does not keep a reference to the table: the methods taking a
+ * table must be given the one the index was built on.
+ *
+ * @see join_keys.h
+ */
+class StaticTableIndex {
+    std::vector<int> key_columns;
+    std::vector<int> sorted_rows;
+
+    std::vector<std::uint64_t> slot_keys;
+    //! First and last position in sorted_rows of the run of each slot; begin is -1 if empty
+    std::vector<int> slot_begin;
+    std::vector<int> slot_end;
+    std::size_t mask;
+
+public:
+    StaticTableIndex(const Table &table, std::vector<int> key_columns);
+
+    const std::vector<int> &get_key_columns() const {
+        return key_columns;
+    }
+
+    /// @return rows of the table sorted by key, ties in increasing row order
+    const std::vector<int> &get_sorted_rows() const {
+        return sorted_rows;
+    }
+
+    /**
+     * @return range [first, last) of the rows of the table whose key columns
+     * are equal to the given columns of the tuple, in increasing order.
+     */
+    std::pair<const int *, const int *> find(const Table &table,
+                                             const int *tuple,
+                                             const std::vector<int> &columns) const;
+};
+
+/**
+ * @brief Join the working table t1 with the indexed table t2.
+ *
+ * @details The columns of t1 given in probe_columns are matched with the key
+ * columns of the index, in the same order, which must be exactly the matching
+ * columns of the two tables. Each row of t1 is looked up in the index, and the
+ * matching pairs of rows are then put in the order in which hash_join(t1, t2,
+ * arena) produces them, so both joins give the same table.
+ *
+ * @see hash_join.h
+ */
+void index_join(Table &t1,
+                const Table &t2,
+                const StaticTableIndex &index,
+                const std::vector<int> &probe_columns,
+                JoinArena &arena);
+
+/**
+ * @brief Semi-join of t1 with the indexed table t2, with the same conventions
+ * as index_join.
+ *
+ * @return number of tuples left in t1
+ *
+ * @see hash_semi_join.h
+ */
+std::size_t index_semi_join(Table &t1,
+                            const Table &t2,
+                            const StaticTableIndex &index,
+                            const std::vector<int> &probe_columns);
+
+#endif //SEARCH_STATIC_TABLE_INDEX_H
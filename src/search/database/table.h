@@ -1,6 +1,8 @@
 #ifndef SEARCH_TABLE_H
 #define SEARCH_TABLE_H
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 #include <memory>
 #include <unordered_set>
@@ -10,26 +12,81 @@
 /**
  * @brief Data-structure containing a set of tuples and the indices corresponding to
  * the free variable index of each tuple position.
+ *
+ * @details Tuples are stored row by row in a single contiguous buffer. Every row has
+ * exactly arity() = tuple_index.size() values, so the i-th tuple occupies the
+ * positions [i * arity(), (i + 1) * arity()) of the buffer. This avoids one heap
+ * allocation per tuple in the join operators.
  */
 
 class Table {
 public:
     using tuple_t = std::vector<int>;
 
-    /// @var tuples: the relation corresponding to the table, encoded as a vector of tuples
-    std::vector<tuple_t> tuples;
+    /// @var values: the relation corresponding to the table, encoded row by row
+    std::vector<int> values;
     /// @var tuple_index: Indices of each variable in order
     std::vector<int> tuple_index;
-    // create table from dbstate
-    Table(std::vector<tuple_t> &&tuples, std::vector<int> &&tuple_index) :
-        tuples(std::move(tuples)),
+
+    // create table from a flat buffer of tuples
+    Table(std::vector<int> &&values, std::vector<int> &&tuple_index) :
+        values(std::move(values)),
         tuple_index(std::move(tuple_index))
-    {}
+    {
+        assert(arity() == 0 || this->values.size() % arity() == 0);
+    }
 
     bool index_is_variable(std::size_t i) const {
         return tuple_index[i] >= 0;
     }
 
+    std::size_t arity() const {
+        return tuple_index.size();
+    }
+
+    /// @return number of tuples in the table
+    std::size_t size() const {
+        return arity() == 0 ? 0 : values.size() / arity();
+    }
+
+    bool empty() const {
+        return values.empty();
+    }
+
+    const int *row(std::size_t i) const {
+        return values.data() + i * arity();
+    }
+
+    int *row(std::size_t i) {
+        return values.data() + i * arity();
+    }
+
+    tuple_t get_tuple(std::size_t i) const {
+        return tuple_t(row(i), row(i) + arity());
+    }
+
+    void add_tuple(const int *tuple) {
+        values.insert(values.end(), tuple, tuple + arity());
+    }
+
+    /// Keep only the tuples for which keep(row) holds, preserving their order.
+    template<typename Predicate>
+    void filter_tuples(Predicate keep) {
+        const std::size_t k = arity();
+        const std::size_t n = size();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const int *tuple = values.data() + i * k;
+            if (keep(tuple)) {
+                if (kept != i) {
+                    std::copy(tuple, tuple + k, values.data() + kept * k);
+                }
+                ++kept;
+            }
+        }
+        values.resize(kept * k);
+    }
+
     Table() = default;
 
     static const Table& EMPTY_TABLE();
@@ -136,6 +136,10 @@ public:
         facts[fact].set_cost(cost);
     }
 
+    void update_fact_achievers(int fact, Achievers achievers) {
+        facts[fact].update_achievers(std::move(achievers));
+    }
+
     void update_rule_indices() {
         for (size_t i = 0; i < rules.size(); ++i) {
             rules[i]->update_index(int(i));
@@ -4,7 +4,7 @@ namespace  datalog {
 
 using namespace std;
 
-int DatalogAtom::next_index = 0;
+thread_local int DatalogAtom::next_index = 0;
 
 DatalogAtom::DatalogAtom(const Atom &atom) {
     index = next_index++;
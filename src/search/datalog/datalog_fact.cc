@@ -2,6 +2,6 @@
 
 namespace  datalog {
 
-int Fact::next_fact_index = 0;
+thread_local int Fact::next_fact_index = 0;
 
 }
\ No newline at end of file
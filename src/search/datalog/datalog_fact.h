@@ -31,7 +31,9 @@ class Fact : public DatalogAtom {
     Achievers achievers;
 public:
 
-    static int next_fact_index;
+    // Thread-local so that heuristics evaluated in different threads (e.g., by
+    // the parallel search engines) do not share the fact counter.
+    static thread_local int next_fact_index;
 
     Fact(Arguments arguments, int predicate_index, bool new_pred) :
         DatalogAtom(std::move(arguments), predicate_index, new_pred) {
@@ -0,0 +1,280 @@
+#include "incremental_weighted_grounder.h"
+
+#include "../datalog.h"
+
+#include "../rules/product.h"
+
+#include <cassert>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+namespace datalog {
+
+IncrementalWeightedGrounder::IncrementalWeightedGrounder(const Datalog &lp, int h)
+    : WeightedGrounder(lp, h),
+      first_auxiliary_node(lp.get_rules().size(), -1),
+      edb_is_known(false),
+      epoch(0) {
+}
+
+void IncrementalWeightedGrounder::reset(Datalog &) {
+    // Facts, hash tables and ground rules are kept for the next state
+}
+
+int IncrementalWeightedGrounder::ground(Datalog &datalog, std::vector<Fact> &state_facts, int goal_predicate) {
+    ++epoch;
+    queue.clear();
+    // Fact indices live in the cached index space of get_or_insert_fact, so the
+    // global counter restarts there instead of growing with every evaluation
+    Fact::reset_global_fact_index(fact_cost.size());
+
+    if (!edb_is_known) {
+        for (const Fact &f : datalog.get_permanent_edb()) {
+            int index = get_or_insert_fact(f, datalog);
+            edb_facts_and_costs.emplace_back(index, f.get_cost());
+            edb_fact_indices.insert(index);
+        }
+        edb_is_known = true;
+    }
+
+    initial_fact_indices = edb_fact_indices;
+    for (const auto &edb_fact : edb_facts_and_costs) {
+        reach_fact(edb_fact.first, edb_fact.second, -1);
+    }
+    for (const Fact &f : state_facts) {
+        int index = get_or_insert_fact(f, datalog);
+        initial_fact_indices.insert(index);
+        reach_fact(index, f.get_cost(), -1);
+    }
+
+    while (!queue.empty()) {
+        pair<int, int> queue_top = queue.pop();
+        int cost = queue_top.first;
+        int fact = queue_top.second;
+        if (is_closed[fact] || fact_cost[fact] < cost) {
+            continue;
+        }
+        is_closed[fact] = true;
+
+        if (!is_auxiliary[fact] && datalog.get_fact_by_index(fact).get_predicate_index() == goal_predicate) {
+            set_achievers_of_relaxed_plan(fact, datalog);
+            datalog.backchain_from_goal(datalog.get_fact_by_index(fact), initial_fact_indices);
+            return cost;
+        }
+
+        if (!is_matched_against_rules[fact]) {
+            match_against_rules(fact, datalog);
+            continue;
+        }
+        for (int ground_rule : rules_with_fact_in_body[fact]) {
+            if (rule_epoch[ground_rule] != epoch) {
+                rule_epoch[ground_rule] = epoch;
+                unreached_conditions[ground_rule] = ground_rules[ground_rule].body_size;
+            }
+            if (--unreached_conditions[ground_rule] == 0) {
+                apply_ground_rule(ground_rule);
+            }
+        }
+    }
+    return std::numeric_limits<int>::max();
+}
+
+int IncrementalWeightedGrounder::get_or_insert_fact(const Fact &fact, Datalog &datalog) {
+    auto it = known_facts.find(fact);
+    if (it != known_facts.end()) {
+        return it->get_fact_index();
+    }
+
+    int index = fact_cost.size();
+    assert(datalog.get_number_of_facts() == index);
+    Fact new_fact = fact;
+    new_fact.update_fact_index(index);
+    known_facts.insert(new_fact);
+    datalog.insert_fact(new_fact);
+
+    rules_with_fact_in_body.emplace_back();
+    is_matched_against_rules.push_back(false);
+    is_auxiliary.push_back(false);
+    fact_epoch.push_back(0);
+    fact_cost.push_back(0);
+    first_achiever.push_back(-1);
+    is_closed.push_back(false);
+    achiever_epoch.push_back(0);
+    return index;
+}
+
+int IncrementalWeightedGrounder::insert_auxiliary_node(Datalog &datalog) {
+    int index = fact_cost.size();
+    // Placeholder keeping the indices of the Datalog facts aligned with ours
+    datalog.insert_fact(Fact(Arguments(), -1, true));
+
+    rules_with_fact_in_body.emplace_back();
+    is_matched_against_rules.push_back(true);
+    is_auxiliary.push_back(true);
+    fact_epoch.push_back(0);
+    fact_cost.push_back(0);
+    first_achiever.push_back(-1);
+    is_closed.push_back(false);
+    achiever_epoch.push_back(0);
+    return index;
+}
+
+void IncrementalWeightedGrounder::insert_ground_rule(int head,
+                                                     const std::vector<int> &body,
+                                                     int weight,
+                                                     int rule_index) {
+    int ground_rule = ground_rules.size();
+    ground_rules.push_back(GroundRule{head, weight, rule_index,
+                                      int(ground_rule_bodies.size()), int(body.size())});
+    ground_rule_bodies.insert(ground_rule_bodies.end(), body.begin(), body.end());
+
+    // The rule is new, so we count by hand how many conditions are still open
+    int unreached = 0;
+    for (int fact : body) {
+        rules_with_fact_in_body[fact].push_back(ground_rule);
+        if (fact_epoch[fact] != epoch || !is_closed[fact])
+            ++unreached;
+    }
+    rule_epoch.push_back(epoch);
+    unreached_conditions.push_back(unreached);
+    if (unreached == 0) {
+        apply_ground_rule(ground_rule);
+    }
+}
+
+void IncrementalWeightedGrounder::reach_fact(int fact, int cost, int achiever) {
+    if (fact_epoch[fact] != epoch) {
+        fact_epoch[fact] = epoch;
+        fact_cost[fact] = cost;
+        first_achiever[fact] = achiever;
+        is_closed[fact] = false;
+        queue.push(cost, fact);
+    }
+    else if (cost < fact_cost[fact]) {
+        // Same as WeightedGrounder: a cheaper path updates the cost but not the achievers
+        fact_cost[fact] = cost;
+        queue.push(cost, fact);
+    }
+}
+
+void IncrementalWeightedGrounder::apply_ground_rule(int ground_rule) {
+    const GroundRule &rule = ground_rules[ground_rule];
+    const int *body = &ground_rule_bodies[rule.body_begin];
+    int cost = fact_cost[body[0]];
+    for (int i = 1; i < rule.body_size; ++i) {
+        cost = aggregation_function(cost, fact_cost[body[i]]);
+    }
+    reach_fact(rule.head, cost + rule.weight, ground_rule);
+}
+
+/*
+ * Match a fact reached for the first time against all rules. The join hash
+ * tables and the reached facts of product rules are never cleared, so the
+ * rules derived here are all ground rules with the fact in the body whose
+ * other conditions were reached in some state before.
+ */
+void IncrementalWeightedGrounder::match_against_rules(int fact_index, Datalog &datalog) {
+    is_matched_against_rules[fact_index] = true;
+
+    // Copy: inserting new facts may reallocate the facts of the Datalog program
+    const Fact fact = datalog.get_fact_by_index(fact_index);
+    vector<int> body;
+    for (const auto &m : rule_matcher.get_matched_rules(fact.get_predicate_index())) {
+        RuleBase &rule = datalog.get_rule_by_index(m.get_rule());
+        int position = m.get_position();
+
+        derived_facts.clear();
+        if (rule.get_type() == PROJECT) {
+            project(rule, fact, derived_facts);
+        } else if (rule.get_type() == JOIN) {
+            join(rule, fact, position, derived_facts);
+        } else if (rule.head_is_ground()) {
+            match_against_product_with_ground_head(rule, fact, fact_index, position, datalog);
+        } else {
+            product(rule, fact, position, derived_facts);
+        }
+
+        for (const Fact &new_fact : derived_facts) {
+            int head = get_or_insert_fact(new_fact, datalog);
+            const Achievers &achievers = new_fact.get_achievers();
+            body.assign(achievers.begin(), achievers.end());
+            insert_ground_rule(head, body, achievers.get_achiever_rule_cost(),
+                               achievers.get_achiever_rule_index());
+        }
+    }
+}
+
+void IncrementalWeightedGrounder::match_against_product_with_ground_head(const RuleBase &rule,
+                                                                         const Fact &fact,
+                                                                         int fact_index,
+                                                                         int position,
+                                                                         Datalog &datalog) {
+    // Same check as WeightedGrounder::product
+    int c = 0;
+    for (const auto &term : rule.get_condition_arguments(position)) {
+        if (term.is_object() and term.get_index() != fact.argument(c).get_index()) {
+            return;
+        }
+        ++c;
+    }
+
+    int rule_index = rule.get_index();
+    if (first_auxiliary_node[rule_index] == -1) {
+        vector<int> auxiliary_nodes;
+        for (size_t i = 0; i < rule.get_conditions().size(); ++i) {
+            auxiliary_nodes.push_back(insert_auxiliary_node(datalog));
+        }
+        first_auxiliary_node[rule_index] = auxiliary_nodes[0];
+        int head = get_or_insert_fact(Fact(rule.get_effect_arguments(),
+                                           rule.get_effect().get_predicate_index(),
+                                           rule.get_effect().is_pred_symbol_new()),
+                                      datalog);
+        insert_ground_rule(head, auxiliary_nodes, rule.get_weight(), rule_index);
+    }
+    insert_ground_rule(first_auxiliary_node[rule_index] + position, {fact_index}, 0, -1);
+}
+
+/*
+ * Write the cost and the achievers of the facts needed to reach the goal into
+ * the Datalog program, where backchain_from_goal reads them. Auxiliary nodes
+ * of product rules are replaced by the fact that reached them, which is the
+ * cheapest fact of the condition as in WeightedGrounder::product.
+ */
+void IncrementalWeightedGrounder::set_achievers_of_relaxed_plan(int goal, Datalog &datalog) {
+    vector<int> open_facts{goal};
+    achiever_epoch[goal] = epoch;
+    while (!open_facts.empty()) {
+        int fact = open_facts.back();
+        open_facts.pop_back();
+        datalog.update_fact_cost(fact, fact_cost[fact]);
+        int ground_rule = first_achiever[fact];
+        if (ground_rule == -1) {
+            continue;
+        }
+
+        const GroundRule &rule = ground_rules[ground_rule];
+        vector<int> achievers;
+        achievers.reserve(rule.body_size);
+        for (int i = 0; i < rule.body_size; ++i) {
+            int achiever = ground_rule_bodies[rule.body_begin + i];
+            if (is_auxiliary[achiever]) {
+                achiever = ground_rule_bodies[ground_rules[first_achiever[achiever]].body_begin];
+            }
+            achievers.push_back(achiever);
+            if (achiever_epoch[achiever] != epoch) {
+                achiever_epoch[achiever] = epoch;
+                open_facts.push_back(achiever);
+            }
+        }
+        datalog.update_fact_achievers(fact, Achievers(std::move(achievers), rule.rule_index, rule.weight));
+    }
+}
+
+void IncrementalWeightedGrounder::print_statistics(const Datalog &lp) {
+    cout << known_facts.size() << " facts reached over all states" << endl;
+    cout << ground_rules.size() << " ground rules" << endl;
+}
+
+}
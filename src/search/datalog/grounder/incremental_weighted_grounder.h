@@ -0,0 +1,101 @@
+#ifndef GROUNDER_GROUNDERS_INCREMENTAL_WEIGHTED_GROUNDER_H_
+#define GROUNDER_GROUNDERS_INCREMENTAL_WEIGHTED_GROUNDER_H_
+
+#include "weighted_grounder.h"
+
+#include <vector>
+
+namespace datalog {
+
+/*
+ * Weighted grounder that keeps the ground rules it finds between states.
+ *
+ * Rule instantiations do not depend on the state: a ground rule that was
+ * found once is valid in every state. This grounder keeps the join hash
+ * tables, the reached facts of product rules and every ground rule it
+ * derived, across all calls to ground(). A fact is matched against the rules
+ * (i.e., joined with other facts) only the first time it is reached in any
+ * state. Afterwards, evaluating a state is a generalized Dijkstra search over
+ * the ground rules found so far, which only touches integers.
+ *
+ * Costs are recomputed for every state, so h^add and h^max values are exactly
+ * the ones of WeightedGrounder. As in WeightedGrounder, the achievers of a
+ * fact are the ones of the first rule that reaches it.
+ *
+ * Product rules with a ground head take the cheapest reached fact of each of
+ * their conditions. We represent each condition of these rules by an
+ * auxiliary node reached by every fact matching the condition, and the rule
+ * by a ground rule whose body are the auxiliary nodes.
+ *
+ * The memory used grows with the number of distinct facts reached over the
+ * whole search.
+ */
+class IncrementalWeightedGrounder : public WeightedGrounder {
+    struct GroundRule {
+        int head;
+        int weight;
+        // -1 for the rules linking a fact to an auxiliary node of a product rule
+        int rule_index;
+        int body_begin;
+        int body_size;
+    };
+
+    phmap::flat_hash_set<Fact> known_facts;
+
+    std::vector<GroundRule> ground_rules;
+    std::vector<int> ground_rule_bodies;
+
+    // Indexed by fact: ground rules with the fact in their body (once per occurrence)
+    std::vector<std::vector<int>> rules_with_fact_in_body;
+    std::vector<bool> is_matched_against_rules;
+    std::vector<bool> is_auxiliary;
+
+    // First auxiliary node of each product rule with ground head, -1 if none
+    std::vector<int> first_auxiliary_node;
+
+    std::vector<std::pair<int, int>> edb_facts_and_costs;
+    phmap::flat_hash_set<int> edb_fact_indices;
+    bool edb_is_known;
+
+    /*
+     * Data of the current call to ground(). An entry is only valid if its
+     * epoch is the current one, which avoids resetting these vectors.
+     */
+    int epoch;
+    std::vector<int> fact_epoch;
+    std::vector<int> fact_cost;
+    std::vector<int> first_achiever;
+    std::vector<bool> is_closed;
+    std::vector<int> rule_epoch;
+    std::vector<int> unreached_conditions;
+    std::vector<int> achiever_epoch;
+
+    priority_queues::AdaptiveQueue<int> queue;
+    phmap::flat_hash_set<int> initial_fact_indices;
+    std::vector<Fact> derived_facts;
+
+    int get_or_insert_fact(const Fact &fact, Datalog &datalog);
+    int insert_auxiliary_node(Datalog &datalog);
+    void insert_ground_rule(int head, const std::vector<int> &body, int weight, int rule_index);
+
+    void reach_fact(int fact, int cost, int achiever);
+    void apply_ground_rule(int ground_rule);
+    void match_against_rules(int fact, Datalog &datalog);
+    void match_against_product_with_ground_head(const RuleBase &rule, const Fact &fact, int fact_index,
+                                                int position, Datalog &datalog);
+
+    void set_achievers_of_relaxed_plan(int goal, Datalog &datalog);
+
+public:
+    IncrementalWeightedGrounder(const Datalog &lp, int h);
+
+    int ground(Datalog &datalog, std::vector<Fact> &state_facts, int goal_predicate) override;
+
+    void reset(Datalog &datalog) override;
+
+    void print_statistics(const Datalog &lp) override;
+};
+
+}
+
+#endif //GROUNDER_GROUNDERS_INCREMENTAL_WEIGHTED_GROUNDER_H_
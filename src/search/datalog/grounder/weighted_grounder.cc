@@ -15,9 +15,6 @@ using namespace std;
 namespace datalog {
 
 int WeightedGrounder::ground(Datalog &datalog, std::vector<Fact> &state_facts, int goal_predicate) {
-    phmap::flat_hash_set<Fact> reached_facts;
-    std::vector<Fact> newfacts;
-
     queue_pushes = 0;
     atoms_produced = 0;
 
@@ -27,6 +24,7 @@ int WeightedGrounder::ground(Datalog &datalog, std::vector<Fact> &state_facts, i
     q.clear();
     best_achievers.clear();
     initial_facts.clear();
+    reached_facts.clear();
 
     for (const Fact &f : datalog.get_permanent_edb()) {
         Fact f2 = f;
@@ -87,7 +85,7 @@ int WeightedGrounder::ground(Datalog &datalog, std::vector<Fact> &state_facts, i
             // Note: using for loop for performance reasons, this is a heavily used loop
             for (unsigned i=0, sz=newfacts.size(); i < sz; ++i) {
                 auto& new_fact = newfacts[i];
-                int id = is_cheapest_path_to_achieve_fact(new_fact, reached_facts, datalog);
+                int id = is_cheapest_path_to_achieve_fact(new_fact, datalog);
                 //datalog.output_atom(new_fact);
                 //std::cout << std::endl << std::flush;
                 if (id!=HAS_CHEAPER_PATH) {
@@ -100,9 +98,13 @@ int WeightedGrounder::ground(Datalog &datalog, std::vector<Fact> &state_facts, i
     return std::numeric_limits<int>::max();
 }
 
-int WeightedGrounder::is_cheapest_path_to_achieve_fact(Fact &new_fact,
-                                                       phmap::flat_hash_set<Fact> &reached_facts,
-                                                       Datalog &lp) {
+void WeightedGrounder::reset(Datalog &datalog) {
+    datalog.reset_facts();
+    for (const auto &r : datalog.get_rules())
+        r->clean_up();
+}
+
+int WeightedGrounder::is_cheapest_path_to_achieve_fact(Fact &new_fact, Datalog &lp) {
     const auto& it = reached_facts.find(new_fact);
     atoms_produced++;
     if (it == reached_facts.end()) {  // The fact wasn't reached yet
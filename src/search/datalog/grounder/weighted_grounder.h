@@ -23,13 +23,14 @@ const int HAS_CHEAPER_PATH = -2;
 enum {H_ADD, H_MAX};
 
 class WeightedGrounder : public Grounder {
-    int is_cheapest_path_to_achieve_fact(Fact &new_fact,
-                                         phmap::flat_hash_set<Fact> &reached_facts,
-                                         Datalog &lp);
+    int is_cheapest_path_to_achieve_fact(Fact &new_fact, Datalog &lp);
 
     priority_queues::AdaptiveQueue<int> q;
 
     phmap::flat_hash_set<int> initial_facts;
+    // Kept between calls so that their memory is reused
+    phmap::flat_hash_set<Fact> reached_facts;
+    std::vector<Fact> newfacts;
     std::vector<int> best_achievers;
 
     int queue_pushes;
@@ -64,6 +65,12 @@ public:
 
     int ground(Datalog &datalog, std::vector<Fact> &state_facts, int goal_predicate) override;
 
+    /*
+     * Forget the facts of the last call to ground(). Must be called once the
+     * heuristic has read everything it needs from the Datalog program.
+     */
+    virtual void reset(Datalog &datalog);
+
     void print_statistics(const Datalog &lp) override {
         std::cout << lp.get_number_of_facts() << " final number of facts" << std::endl;
         std::cout << atoms_produced << " total atoms produced" << std::endl;
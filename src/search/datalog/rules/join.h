@@ -53,6 +53,11 @@ class JoinHashTable {
 public:
     JoinHashTable() = default;
 
+    void clear() {
+        hash_table_1.clear();
+        hash_table_2.clear();
+    }
+
     void insert(const Fact &f, const JoinHashKey &key, int position) {
         assert (valid_position(position));
         if (position==0) {
@@ -134,7 +139,7 @@ public:
     }
 
     void clean_up() override {
-        hash_table_indices = JoinHashTable();
+        hash_table_indices.clear();
     }
 
     int get_type() const override {
@@ -0,0 +1,187 @@
+#ifndef SEARCH_FLAT_TUPLE_SET_H
+#define SEARCH_FLAT_TUPLE_SET_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Read-only view of a tuple stored in a FlatTupleSet.
+ *
+ * @details It offers the part of the interface of GroundAtom used when
+ * iterating over relations, and it converts to a GroundAtom where a copy is
+ * needed.
+ */
+class TupleView {
+    const int *first;
+    std::size_t arity;
+
+public:
+    TupleView(const int *first, std::size_t arity) : first(first), arity(arity) {}
+
+    std::size_t size() const { return arity; }
+    bool empty() const { return arity == 0; }
+    const int *data() const { return first; }
+    const int *begin() const { return first; }
+    const int *end() const { return first + arity; }
+    int operator[](std::size_t i) const { return first[i]; }
+
+    operator std::vector<int>() const { return std::vector<int>(begin(), end()); }
+
+    bool operator==(const TupleView &other) const {
+        return arity == other.arity && std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator==(const std::vector<int> &other) const {
+        return arity == other.size() && std::equal(begin(), end(), other.begin());
+    }
+
+    friend bool operator==(const std::vector<int> &lhs, const TupleView &rhs) {
+        return rhs == lhs;
+    }
+};
+
+/**
+ * @brief Set of tuples of the same arity, stored one after the other in a
+ * single int array in lexicographic order.
+ *
+ * @details Alternative to std::unordered_set<GroundAtom, TupleHash> for the
+ * tuples of a Relation (see the FLAT_RELATIONS build option). It has the same
+ * interface for the operations used on relations. Copying a set copies one
+ * array, iteration does not touch the heap and membership tests are binary
+ * searches. Adding or removing a tuple moves the tuples after it, which is a
+ * single memmove of the array.
+ *
+ * The arity is fixed by the first tuple inserted.
+ */
+class FlatTupleSet {
+    std::vector<int> tuples;
+    std::size_t arity;
+    std::size_t num_tuples;
+
+    const int *get_tuple(std::size_t i) const { return tuples.data() + i * arity; }
+
+    bool is_less(const int *lhs, const int *rhs) const {
+        return std::lexicographical_compare(lhs, lhs + arity, rhs, rhs + arity);
+    }
+
+    bool is_equal(const int *lhs, const int *rhs) const {
+        return std::equal(lhs, lhs + arity, rhs);
+    }
+
+    // Index of the first tuple that is not smaller than `tuple`
+    std::size_t lower_bound(const int *tuple) const {
+        // Tuples are often inserted in order, so we check the last one first
+        if (num_tuples == 0 || is_less(get_tuple(num_tuples - 1), tuple))
+            return num_tuples;
+        std::size_t begin = 0, end = num_tuples - 1;
+        while (begin < end) {
+            std::size_t middle = begin + (end - begin) / 2;
+            if (is_less(get_tuple(middle), tuple))
+                begin = middle + 1;
+            else
+                end = middle;
+        }
+        return begin;
+    }
+
+public:
+    class const_iterator {
+        const int *base;
+        std::size_t arity;
+        std::size_t index;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = TupleView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = TupleView;
+
+        const_iterator(const int *base, std::size_t arity, std::size_t index)
+            : base(base), arity(arity), index(index) {}
+
+        TupleView operator*() const { return TupleView(base + index * arity, arity); }
+
+        const_iterator &operator++() {
+            ++index;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++index;
+            return previous;
+        }
+
+        bool operator==(const const_iterator &other) const { return index == other.index; }
+        bool operator!=(const const_iterator &other) const { return index != other.index; }
+    };
+
+    using iterator = const_iterator;
+    using value_type = TupleView;
+
+    FlatTupleSet() : arity(0), num_tuples(0) {}
+
+    std::size_t size() const { return num_tuples; }
+    bool empty() const { return num_tuples == 0; }
+
+    const_iterator begin() const { return const_iterator(tuples.data(), arity, 0); }
+    const_iterator end() const { return const_iterator(tuples.data(), arity, num_tuples); }
+
+    void clear() {
+        tuples.clear();
+        num_tuples = 0;
+    }
+
+    // Tuple is any sequence of ints with data() and size(), e.g., GroundAtom or TupleView
+    template<typename Tuple>
+    const_iterator find(const Tuple &tuple) const {
+        if (num_tuples == 0 || tuple.size() != arity)
+            return end();
+        std::size_t i = lower_bound(tuple.data());
+        if (i < num_tuples && is_equal(get_tuple(i), tuple.data()))
+            return const_iterator(tuples.data(), arity, i);
+        return end();
+    }
+
+    template<typename Tuple>
+    std::size_t count(const Tuple &tuple) const {
+        return find(tuple) == end() ? 0 : 1;
+    }
+
+    template<typename Tuple>
+    std::pair<const_iterator, bool> insert(const Tuple &tuple) {
+        if (num_tuples == 0)
+            arity = tuple.size();
+        assert(tuple.size() == arity);
+        std::size_t i = lower_bound(tuple.data());
+        if (i < num_tuples && is_equal(get_tuple(i), tuple.data()))
+            return {const_iterator(tuples.data(), arity, i), false};
+        tuples.insert(tuples.begin() + i * arity, tuple.data(), tuple.data() + arity);
+        ++num_tuples;
+        return {const_iterator(tuples.data(), arity, i), true};
+    }
+
+    template<typename Tuple>
+    std::size_t erase(const Tuple &tuple) {
+        if (num_tuples == 0 || tuple.size() != arity)
+            return 0;
+        std::size_t i = lower_bound(tuple.data());
+        if (i == num_tuples || !is_equal(get_tuple(i), tuple.data()))
+            return 0;
+        auto first = tuples.begin() + i * arity;
+        tuples.erase(first, first + arity);
+        --num_tuples;
+        return 1;
+    }
+
+    bool operator==(const FlatTupleSet &other) const {
+        return num_tuples == other.num_tuples && tuples == other.tuples;
+    }
+};
+
+#endif //SEARCH_FLAT_TUPLE_SET_H
@@ -12,14 +12,23 @@
 class AdditiveHeuristic : public Heuristic{
 
     datalog::Datalog datalog;
-    datalog::WeightedGrounder grounder;
+    std::unique_ptr<datalog::WeightedGrounder> grounder;
+    DatalogTransformationOptions transformation_options;
+    bool incremental_grounding;
 
     datalog::AnnotationGenerator get_annotation_generator();
 
+protected:
+    std::unique_ptr<Heuristic> create_batch_evaluator(const Task &task) const override;
+
 public:
     AdditiveHeuristic(const Task &task) : AdditiveHeuristic(task, DatalogTransformationOptions()){};
 
-    AdditiveHeuristic(const Task &task, DatalogTransformationOptions opts);
+    /**
+     * @param incremental_grounding: keep the ground rules between states, see
+     * datalog::IncrementalWeightedGrounder
+     */
+    AdditiveHeuristic(const Task &task, DatalogTransformationOptions opts, bool incremental_grounding = false);
 
     int compute_heuristic(const DBState &s, const Task &task) override;
 };
@@ -15,16 +15,25 @@ typedef std::pair<int, std::vector<int>> GroundAction;
 class FFHeuristic : public Heuristic{
 
     datalog::Datalog datalog;
-    datalog::WeightedGrounder grounder;
+    std::unique_ptr<datalog::WeightedGrounder> grounder;
+    DatalogTransformationOptions transformation_options;
+    bool incremental_grounding;
 
     std::vector<GroundAction> pi_ff;
 
     datalog::AnnotationGenerator get_annotation_generator();
 
+protected:
+    std::unique_ptr<Heuristic> create_batch_evaluator(const Task &task) const override;
+
 public:
     FFHeuristic(const Task &task) : FFHeuristic(task, DatalogTransformationOptions()) {}
 
-    FFHeuristic(const Task &task, DatalogTransformationOptions opts);
+    /**
+     * @param incremental_grounding: keep the ground rules between states, see
+     * datalog::IncrementalWeightedGrounder
+     */
+    FFHeuristic(const Task &task, DatalogTransformationOptions opts, bool incremental_grounding = false);
 
     int compute_heuristic(const DBState &s, const Task &task) override;
 };
@@ -15,21 +15,23 @@ int Goalcount::compute_heuristic(const DBState &s, const Task &task) {
                                             task.get_goal().negative_nullary_goals,
                                             nullary_atoms);
 
+    const AtomTable &table = task.get_atom_table();
+    const TupleIndices &tuples = s.get_tuple_indices(table);
     for (const AtomicGoal &atomicGoal : task.get_goal().goal) {
         assert(atomicGoal.get_predicate_index()==
             s.get_relations()[atomicGoal.get_predicate_index()].predicate_symbol);
-        h += atom_not_satisfied(s, atomicGoal);
+        h += atom_not_satisfied(table, tuples, atomicGoal);
     }
     return h;
 }
 
 
-bool Goalcount::atom_not_satisfied(const DBState &s,
+bool Goalcount::atom_not_satisfied(const AtomTable &table,
+                                   const TupleIndices &tuples,
                                    const AtomicGoal &atomicGoal) const {
-    const auto &tuples = s.get_relations()[atomicGoal.get_predicate_index()].tuples;
-    const auto it = tuples.find(atomicGoal.get_arguments());
-    const auto end = tuples.end();
-    return (!atomicGoal.is_negated() && it==end) || (atomicGoal.is_negated() && it!=end);
+    int pred = atomicGoal.get_predicate_index();
+    bool found = tuples.contains(pred, table.get_index(pred, atomicGoal.get_arguments()));
+    return (!atomicGoal.is_negated() && !found) || (atomicGoal.is_negated() && found);
 }
 
 int
@@ -8,6 +8,8 @@
 
 
 class AtomicGoal;
+class AtomTable;
+class TupleIndices;
 
 /**
  * @brief Compute hamming distance between goal condition and state s.
@@ -24,7 +26,9 @@ private:
   static int compute_unreached_nullary_atoms(const std::unordered_set<int> &positive,
                                              const std::unordered_set<int> &negative,
                                              const std::vector<bool> &nullary_atoms);
-  bool atom_not_satisfied(const DBState &s, const AtomicGoal &atomicGoal) const;
+  bool atom_not_satisfied(const AtomTable &table,
+                          const TupleIndices &tuples,
+                          const AtomicGoal &atomicGoal) const;
 };
 
 #endif //SEARCH_GOALCOUNT_H
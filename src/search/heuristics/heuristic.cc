@@ -0,0 +1,59 @@
+#include "heuristic.h"
+
+#include "../states/state.h"
+#include "../utils/worker_pool.h"
+
+#include <atomic>
+
+using namespace std;
+
+Heuristic::Heuristic() = default;
+
+Heuristic::~Heuristic() = default;
+
+void Heuristic::set_num_threads(unsigned num_threads, const Task &task)
+{
+    worker_pool.reset();
+    batch_evaluators.clear();
+    for (unsigned i = 1; i < num_threads; ++i) {
+        unique_ptr<Heuristic> evaluator = create_batch_evaluator(task);
+        if (!evaluator)
+            return;
+        batch_evaluators.push_back(std::move(evaluator));
+    }
+    if (!batch_evaluators.empty()) {
+        cout << "Evaluating successors with " << num_threads << " threads" << endl;
+        worker_pool = make_unique<utils::WorkerPool>(num_threads);
+    }
+}
+
+void Heuristic::compute_heuristic_batch(const vector<DBState> &states,
+                                        const Task &task,
+                                        vector<int> &h_values)
+{
+    size_t num_states = states.size();
+    h_values.resize(num_states);
+    batch_useful_atoms.resize(num_states);
+
+    if (!worker_pool || num_states < 2) {
+        for (size_t i = 0; i < num_states; ++i) {
+            h_values[i] = compute_heuristic(states[i], task);
+            batch_useful_atoms[i].swap(useful_atoms);
+        }
+        return;
+    }
+
+    /*
+     * Job t evaluates states with the t-th instance of the heuristic. States
+     * are taken from a shared counter, so a job does not wait for the others
+     * when its states are cheaper to evaluate.
+     */
+    atomic<size_t> next_state(0);
+    worker_pool->run(batch_evaluators.size() + 1, [&](size_t t) {
+        Heuristic &evaluator = (t == 0) ? *this : *batch_evaluators[t - 1];
+        for (size_t i = next_state++; i < num_states; i = next_state++) {
+            h_values[i] = evaluator.compute_heuristic(states[i], task);
+            batch_useful_atoms[i].swap(evaluator.useful_atoms);
+        }
+    });
+}
@@ -7,12 +7,18 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <vector>
 
 const int UNSOLVABLE_STATE = std::numeric_limits<int>::max();
 
 class DBState;
 class Task;
 
+namespace utils {
+class WorkerPool;
+}
+
 class Heuristic {
 protected:
     // TODO This could be a simpler std::vector<std::vector<GroundAtom>>
@@ -21,8 +27,25 @@ protected:
 protected:
     std::vector<bool> useful_nullary_atoms;
 
+    /// @var batch_useful_atoms: useful atoms of each state of the last batch
+    std::vector<std::vector<std::vector<GroundAtom>>> batch_useful_atoms;
+
+    /**
+     * @brief Create an independent instance of the heuristic, used by one
+     * thread of a parallel batch evaluation.
+     * @return nullptr if the heuristic cannot be evaluated in parallel.
+     */
+    virtual std::unique_ptr<Heuristic> create_batch_evaluator(const Task &) const {
+        return nullptr;
+    }
+
+private:
+    std::unique_ptr<utils::WorkerPool> worker_pool;
+    std::vector<std::unique_ptr<Heuristic>> batch_evaluators;
+
 public:
-    virtual ~Heuristic() = default;
+    Heuristic();
+    virtual ~Heuristic();
 
     /**
      * @brief Virtual implementation of a heuristic function
@@ -32,10 +55,43 @@ public:
      */
     virtual int compute_heuristic(const DBState &s, const Task &task) = 0;
 
+    /**
+     * @brief Evaluate a batch of states, usually all successors of an expanded
+     * node.
+     *
+     * @details h_values[i] receives the heuristic value of states[i] and
+     * get_batch_useful_atoms(i) its useful atoms. The values are the same as
+     * the ones of compute_heuristic. If the heuristic uses several threads,
+     * each thread evaluates part of the batch with its own instance of the
+     * heuristic, which keeps its Datalog program and grounder between states.
+     */
+    void compute_heuristic_batch(const std::vector<DBState> &states,
+                                 const Task &task,
+                                 std::vector<int> &h_values);
+
+    /**
+     * @brief Use up to num_threads threads in compute_heuristic_batch.
+     * Heuristics that cannot be evaluated in parallel ignore the request.
+     * Only the search engines that evaluate batches (GBFS and lazy search)
+     * ask for more than one thread.
+     */
+    void set_num_threads(unsigned num_threads, const Task &task);
+
+    /**
+     * @brief Number of states that can be evaluated at the same time.
+     */
+    unsigned get_batch_size() const {
+        return batch_evaluators.size() + 1;
+    }
+
     const std::vector<std::vector<GroundAtom>> &get_useful_atoms() const {
         return useful_atoms;
     }
 
+    const std::vector<std::vector<GroundAtom>> &get_batch_useful_atoms(size_t i) const {
+        return batch_useful_atoms[i];
+    }
+
     const std::vector<bool> &get_useful_nullary_atoms() const {
         return useful_nullary_atoms;
     }
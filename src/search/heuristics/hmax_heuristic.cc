@@ -4,9 +4,11 @@
 
 using namespace std;
 
-HMaxHeuristic::HMaxHeuristic(const Task &task, DatalogTransformationOptions opts) :
+HMaxHeuristic::HMaxHeuristic(const Task &task, DatalogTransformationOptions opts, bool incremental_grounding) :
     datalog(initialize_datalog(task, get_annotation_generator(), opts)),
-    grounder(datalog, datalog::H_MAX) {}
+    grounder(create_grounder(datalog, datalog::H_MAX, incremental_grounding)),
+    transformation_options(opts),
+    incremental_grounding(incremental_grounding) {}
 
 datalog::AnnotationGenerator HMaxHeuristic::get_annotation_generator() {
     return [&](int action_schema_id, const Task &task) -> unique_ptr<datalog::Annotation> {
@@ -20,12 +22,9 @@ int HMaxHeuristic::compute_heuristic(const DBState &s, const Task &task) {
 
     std::vector<datalog::Fact> state_facts = get_datalog_facts_from_state(s, task);
 
-    int h = grounder.ground(datalog, state_facts, datalog.get_goal_atom_idx());
+    int h = grounder->ground(datalog, state_facts, datalog.get_goal_atom_idx());
     //grounder.print_statistics(datalog);
-    datalog.reset_facts();
-
-    for (const auto &r : datalog.get_rules())
-        r->clean_up();
+    grounder->reset(datalog);
     if (h == std::numeric_limits<int>::max())
         return UNSOLVABLE_STATE;
 
@@ -34,3 +33,7 @@ int HMaxHeuristic::compute_heuristic(const DBState &s, const Task &task) {
     return h;
 
 }
+
+unique_ptr<Heuristic> HMaxHeuristic::create_batch_evaluator(const Task &task) const {
+    return make_unique<HMaxHeuristic>(task, transformation_options, incremental_grounding);
+}
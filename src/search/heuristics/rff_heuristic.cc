@@ -30,7 +30,8 @@ public:
 
 RFFHeuristic::RFFHeuristic(const Task &task, DatalogTransformationOptions opts) :
     datalog(initialize_datalog(task, get_annotation_generator(), opts)),
-    grounder(datalog, datalog::H_ADD) {}
+    grounder(datalog, datalog::H_ADD),
+    transformation_options(opts) {}
 
 int RFFHeuristic::compute_heuristic(const DBState &s, const Task &task) {
     if (task.is_goal((s))) return 0;
@@ -63,3 +64,6 @@ datalog::AnnotationGenerator RFFHeuristic::get_annotation_generator() {
     return annotation_generator;
 }
 
+unique_ptr<Heuristic> RFFHeuristic::create_batch_evaluator(const Task &task) const {
+    return make_unique<RFFHeuristic>(task, transformation_options);
+}
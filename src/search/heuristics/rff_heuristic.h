@@ -11,11 +11,15 @@ class RFFHeuristic : public Heuristic {
 
     datalog::Datalog datalog;
     datalog::WeightedGrounder grounder;
+    DatalogTransformationOptions transformation_options;
 
     int rff_cost;
 
     datalog::AnnotationGenerator get_annotation_generator();
 
+protected:
+    std::unique_ptr<Heuristic> create_batch_evaluator(const Task &task) const override;
+
 
 public:
     RFFHeuristic(const Task &task) : RFFHeuristic(task, DatalogTransformationOptions()){};
@@ -1,5 +1,8 @@
 #include "utils.h"
 
+#include "../datalog/annotations/annotation.h"
+#include "../datalog/grounder/incremental_weighted_grounder.h"
+
 datalog::Datalog initialize_datalog(const Task &task,
                                     datalog::AnnotationGenerator annotation_generator,
                                     const DatalogTransformationOptions &opts) {
@@ -27,6 +30,14 @@ datalog::Datalog initialize_datalog(const Task &task,
     return dl;
 }
 
+std::unique_ptr<datalog::WeightedGrounder> create_grounder(const datalog::Datalog &datalog,
+                                                          int heuristic_type,
+                                                          bool incremental) {
+    if (incremental)
+        return std::make_unique<datalog::IncrementalWeightedGrounder>(datalog, heuristic_type);
+    return std::make_unique<datalog::WeightedGrounder>(datalog, heuristic_type);
+}
+
 std::vector<datalog::Fact> get_datalog_facts_from_state(const DBState &s, const Task &task) {
     std::vector<datalog::Fact> facts;
     for (const auto &r: s.get_relations()) {
@@ -45,3 +56,33 @@ std::vector<datalog::Fact> get_datalog_facts_from_state(const DBState &s, const
     }
     return facts;
 }
+
+std::vector<std::vector<GroundAtom>> compute_relaxed_reachable_atoms(const Task &task) {
+    datalog::AnnotationGenerator no_annotations = [](int, const Task &) -> std::unique_ptr<datalog::Annotation> {
+        return nullptr;
+    };
+    datalog::Datalog dl = initialize_datalog(task, no_annotations, DatalogTransformationOptions());
+    std::unique_ptr<datalog::WeightedGrounder> grounder = create_grounder(dl, datalog::H_ADD, false);
+
+    // No fact has predicate -1, so the grounder does not stop at the goal
+    std::vector<datalog::Fact> state_facts = get_datalog_facts_from_state(task.initial_state, task);
+    grounder->ground(dl, state_facts, -1);
+
+    std::vector<std::vector<GroundAtom>> atoms(task.predicates.size());
+    for (int i = 0; i < dl.get_number_of_facts(); ++i) {
+        const datalog::Fact &f = dl.get_fact_by_index(i);
+        if (f.is_pred_symbol_new())
+            continue;
+        // Static nullary atoms are kept, as they are stored in the states
+        const Predicate &predicate = task.predicates[f.get_predicate_index()];
+        if (predicate.isStaticPredicate() && predicate.getArity() > 0)
+            continue;
+        GroundAtom atom;
+        for (const datalog::Term &t : f.get_arguments()) {
+            atom.push_back(t.get_index());
+        }
+        atoms[f.get_predicate_index()].push_back(std::move(atom));
+    }
+    grounder->reset(dl);
+    return atoms;
+}
@@ -7,10 +7,24 @@
 
 #include "../datalog/grounder/weighted_grounder.h"
 
+#include <memory>
+
 datalog::Datalog initialize_datalog(const Task &task,
                                     datalog::AnnotationGenerator annotation_generator,
                                     const DatalogTransformationOptions &opts);
 
+std::unique_ptr<datalog::WeightedGrounder> create_grounder(const datalog::Datalog &datalog,
+                                                          int heuristic_type,
+                                                          bool incremental);
+
 std::vector<datalog::Fact> get_datalog_facts_from_state(const DBState &s, const Task &task);
 
+/*
+ * Atoms of the fluent predicates reachable from the initial state in the
+ * delete relaxation, indexed by predicate. Nullary atoms are empty tuples.
+ * They are found by grounding the Datalog program of the task until its
+ * fixpoint.
+ */
+std::vector<std::vector<GroundAtom>> compute_relaxed_reachable_atoms(const Task &task);
+
 #endif //SEARCH_HEURISTICS_UTILS_H_
@@ -1,3 +1,4 @@
+#include "binary_task.h"
 #include "options.h"
 #include "parser.h"
 #include "plan_manager.h"
@@ -7,6 +8,7 @@
 #include "heuristics/heuristic_factory.h"
 #include "search_engines/search.h"
 #include "search_engines/search_factory.h"
+#include "search_engines/search_space.h"
 #include "successor_generators/successor_generator.h"
 #include "successor_generators/successor_generator_factory.h"
 #include "fact_layer/fact_layer_generator.h"
@@ -31,16 +33,25 @@ int main(int argc, char *argv[]) {
         exit(-1);
     }
 
-    cout << "Reading task description file." << endl;
-    cin.rdbuf(task_file.rdbuf());
-
-    // Parse file
+    // Binary task files are read in place, text files are parsed
+    unique_ptr<BinaryTaskFile> binary_task;
     string domain_name, task_name;
-    cin >> domain_name >> task_name;
+    if (BinaryTaskFile::is_binary_task_file(opt.get_filename())) {
+        cout << "Reading binary task file." << endl;
+        binary_task = make_unique<BinaryTaskFile>(opt.get_filename());
+        domain_name = binary_task->get_domain_name();
+        task_name = binary_task->get_task_name();
+    }
+    else {
+        cout << "Reading task description file." << endl;
+        cin.rdbuf(task_file.rdbuf());
+        cin >> domain_name >> task_name;
+    }
     Task task(domain_name, task_name);
     cout << task.get_domain_name() << " " << task.get_task_name() << endl;
 
-    bool parsed = parse(task, task_file);
+    bool parsed = binary_task ? binary_task->load(task) : parse(task, task_file);
+    binary_task.reset();
     if (!parsed) {
         cerr << "Parser failed." << endl;
         exit(-1);
@@ -49,12 +60,19 @@ int main(int argc, char *argv[]) {
     cout << "IMPORTANT: Assuming that negative effects are always listed first. "
             "(This is guaranteed by the default translator.)" << endl;
 
+    SearchSpaceMemory::set_memory_budget_mb(opt.get_memory_budget());
+    SearchSpaceMemory::set_spill_directory(opt.get_spill_directory());
+
     // Let's create a couple unique_ptr's that deal with mem allocation themselves
     std::unique_ptr<SearchBase> search(SearchFactory::create(opt, opt.get_search_engine(), opt.get_state_representation()));
     std::unique_ptr<Heuristic> heuristic(HeuristicFactory::create(opt, task));
+    // Engines with their own worker threads do not share them with the generator
+    unsigned generator_threads = search->runs_worker_threads() ? 1 : opt.get_threads();
     std::unique_ptr<SuccessorGenerator> sgen(SuccessorGeneratorFactory::create(opt.get_successor_generator(),
                                                                                opt.get_seed(),
-                                                                               task));
+                                                                               generator_threads,
+                                                                               task,
+                                                                               opt.get_incremental_successors()));
     
     std::unique_ptr<FactLayerGenerator> forward_reachability = make_unique<FactLayerGenerator>(task);
 
@@ -75,6 +93,7 @@ int main(int argc, char *argv[]) {
         }else{
             auto exitcode = search->search(task, *sgen, *heuristic);
             search->print_statistics();
+            sgen->print_statistics();
             utils::report_exit_code_reentrant(exitcode);
             return static_cast<int>(exitcode);
         }
@@ -1,11 +1,20 @@
 #ifndef SEARCH_NOVELTY_ACHIEVED_GROUND_ATOMS_H_
 #define SEARCH_NOVELTY_ACHIEVED_GROUND_ATOMS_H_
 
+#include "bloom_filter.h"
+
 #include "../task.h"
 
 #include "../parallel_hashmap/phmap.h"
 #include "../parallel_hashmap/phmap_utils.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
 class AchievedGroundAtoms {
 
     // TODO Check small vector optimizations.
@@ -16,22 +25,120 @@ class AchievedGroundAtoms {
 
     std::vector<phmap::flat_hash_set<std::pair<int, int>>> ground_atoms_k2;
 
+    /*
+     * Dense tables, used when every atom has an id in [0, number_atoms): a
+     * bitmap of the atoms and a triangular bit matrix of the unordered pairs of
+     * atoms, including the pair of an atom with itself. They are allocated on
+     * the first insertion, as most <#g, #r> buckets are never reached.
+     *
+     * The bytes of pair matrices that can still be allocated are shared by
+     * all the buckets of an evaluator. A bucket reached once they are used up
+     * keeps its pairs of atoms in a hash set instead.
+     */
+    bool dense;
+    std::size_t number_atoms;
+    std::vector<std::uint64_t> dense_k1;
+    std::vector<std::uint64_t> dense_k2;
+    std::shared_ptr<std::size_t> dense_k2_budget;
+    bool dense_k2_over_budget;
+    phmap::flat_hash_set<std::uint64_t> dense_k2_overflow;
+
+    /*
+     * Approximate, bounded table of the pairs of atoms: a pair taken for one
+     * already seen makes the evaluator miss that the state has novelty 2.
+     */
+    bool approximate_k2;
+    BloomFilter k2_filter;
+
+    static bool test_and_set(std::vector<std::uint64_t> &bits, std::size_t i) {
+        std::uint64_t mask = std::uint64_t(1) << (i & 63);
+        std::uint64_t &word = bits[i >> 6];
+        bool is_new = !(word & mask);
+        word |= mask;
+        return is_new;
+    }
+
+    void allocate_dense_k2() {
+        std::size_t number_words = (number_atoms * (number_atoms + 1) / 2 + 63) / 64;
+        std::size_t number_bytes = number_words * sizeof(std::uint64_t);
+        if (dense_k2_budget && *dense_k2_budget < number_bytes) {
+            dense_k2_over_budget = true;
+            return;
+        }
+        if (dense_k2_budget)
+            *dense_k2_budget -= number_bytes;
+        dense_k2.resize(number_words);
+    }
+
 public:
 
-    AchievedGroundAtoms() = default;
+    AchievedGroundAtoms() : dense(false), number_atoms(0), dense_k2_over_budget(false), approximate_k2(false) {}
 
     AchievedGroundAtoms(const Task &task, size_t number_combinations) :
-        ground_atoms_k1(task.initial_state.get_relations().size()) {
+        ground_atoms_k1(task.initial_state.get_relations().size()), dense(false), number_atoms(0),
+        dense_k2_over_budget(false), approximate_k2(false) {
         // TODO Initialize only if width=2
         ground_atoms_k2.resize(number_combinations);
     }
 
+    /*
+     * Dense tables over number_atoms atoms. The pair matrix is allocated only
+     * if it fits in the remaining budget (in bytes), which is decreased then;
+     * no budget means no limit.
+     */
+    AchievedGroundAtoms(size_t number_atoms, std::shared_ptr<std::size_t> dense_k2_budget) :
+        dense(true), number_atoms(number_atoms), dense_k2_budget(std::move(dense_k2_budget)),
+        dense_k2_over_budget(false), approximate_k2(false) {}
+
+    /*
+     * Keep the pairs of atoms in a copy of the given (unallocated) filter
+     * instead of the exact tables. Atom ids must be unique across predicates.
+     */
+    void use_approximate_k2(const BloomFilter &filter) {
+        approximate_k2 = true;
+        k2_filter = filter;
+        ground_atoms_k2.clear();
+    }
+
+    const BloomFilter &get_k2_filter() const {
+        return k2_filter;
+    }
+
+    bool has_dense_k2() const {
+        return !dense_k2.empty();
+    }
+
+    bool is_dense_k2_over_budget() const {
+        return dense_k2_over_budget;
+    }
+
     bool try_to_insert_atom_in_k1(int i, int idx) {
+        if (dense) {
+            assert(idx >= 0 && size_t(idx) < number_atoms);
+            if (dense_k1.empty())
+                dense_k1.resize((number_atoms + 63) / 64);
+            return test_and_set(dense_k1, idx);
+        }
         auto it = ground_atoms_k1[i].insert(idx);
         return it.second;
     }
 
     bool try_to_insert_atom_in_k2(int idx, int idx_ga1, int idx_ga2) {
+        if (approximate_k2) {
+            std::uint32_t low = std::min(idx_ga1, idx_ga2);
+            std::uint32_t high = std::max(idx_ga1, idx_ga2);
+            return k2_filter.insert((std::uint64_t(high) << 32) | low);
+        }
+        if (dense) {
+            size_t low = std::min(idx_ga1, idx_ga2);
+            size_t high = std::max(idx_ga1, idx_ga2);
+            assert(high < number_atoms);
+            if (dense_k2.empty() && !dense_k2_over_budget)
+                allocate_dense_k2();
+            if (dense_k2_over_budget)
+                return dense_k2_overflow.insert((std::uint64_t(high) << 32) | low).second;
+            return test_and_set(dense_k2, high * (high + 1) / 2 + low);
+        }
         auto it = ground_atoms_k2[idx].insert({idx_ga1, idx_ga2});
         return it.second;
     }
@@ -2,6 +2,9 @@
 #define SEARCH_NOVELTY_ATOM_COUNTER_H_
 
 #include "../structures.h"
+#include "../task.h"
+
+#include "../states/atom_table.h"
 
 /*
  * This class simply stores a set of atoms and, given a state, checks how many of these atoms
@@ -13,7 +16,8 @@
  */
 class AtomCounter {
 
-    std::vector<std::vector<GroundAtom>> atoms;
+    // Indices in the AtomTable of the atoms of each predicate
+    std::vector<std::vector<long>> atoms;
     std::unordered_set<int> positive_nullary;
     std::unordered_set<int> negative_nullary;
 
@@ -21,10 +25,17 @@ class AtomCounter {
 public:
     AtomCounter() = default;
 
-    AtomCounter(const std::vector<std::vector<GroundAtom>> &atoms,
+    AtomCounter(const AtomTable &table,
+                const std::vector<std::vector<GroundAtom>> &atoms,
                 const std::unordered_set<int> &positive,
                 const std::unordered_set<int> &negative) :
-        atoms(atoms), positive_nullary(positive), negative_nullary(negative) {}
+        atoms(atoms.size()), positive_nullary(positive), negative_nullary(negative) {
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            for (const GroundAtom &atom : atoms[i]) {
+                this->atoms[i].push_back(table.get_index(i, atom));
+            }
+        }
+    }
 
     int compute_unreached_nullary_atoms(const std::vector<bool> &nullary_atoms) const {
         int h = 0;
@@ -46,9 +57,10 @@ public:
 
         count += compute_unreached_nullary_atoms(state.get_nullary_atoms());
 
+        const TupleIndices &tuples = state.get_tuple_indices(task.get_atom_table());
         for (size_t i = 0; i < atoms.size(); ++i) {
-            for (const auto &tuple : atoms[i]) {
-                if (state.get_tuples_of_relation(i).count(tuple) == 0)
+            for (long index : atoms[i]) {
+                if (!tuples.contains(i, index))
                     ++count;
             }
         }
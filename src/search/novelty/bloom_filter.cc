@@ -0,0 +1,83 @@
+#include "bloom_filter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+static uint64_t mix(uint64_t key) {
+    // Finalizer of splitmix64
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+BloomFilter::BloomFilter(size_t number_bytes, double false_positive_rate)
+    : number_bits(0), number_hashes(0), bits_set(0), insertions(0), new_keys(0) {
+    if (number_bytes == 0)
+        return;
+    assert(0 < false_positive_rate && false_positive_rate < 1);
+    number_bits = 64;
+    while (number_bits * 2 <= number_bytes * 8)
+        number_bits *= 2;
+    number_hashes = max(1, static_cast<int>(ceil(-log2(false_positive_rate))));
+}
+
+bool BloomFilter::insert(uint64_t key) {
+    if (words.empty())
+        words.resize(number_bits / 64, 0);
+    ++insertions;
+    /*
+     * Register-blocked filter: all the bits of a key are in the same 64-bit
+     * word, so an insertion is a single read and write of the table. The low
+     * bits of the hash of the key choose the word, and the high bits of a
+     * multiple of it the bits in the word, 6 bits at a time.
+     */
+    uint64_t h1 = mix(key);
+    uint64_t h2 = h1 * 0x9e3779b97f4a7c15ULL;
+    uint64_t pattern = 0;
+    for (int i = 0; i < number_hashes; ++i) {
+        if (i > 0 && i % 10 == 0)
+            h2 = mix(h1 + i);
+        pattern |= uint64_t(1) << (h2 >> 58);
+        h2 <<= 6;
+    }
+    uint64_t &word = words[(h1 & (number_bits - 1)) >> 6];
+    uint64_t new_bits = pattern & ~word;
+    if (!new_bits)
+        return false;
+    word |= new_bits;
+    bits_set += __builtin_popcountll(new_bits);
+    ++new_keys;
+    return true;
+}
+
+size_t BloomFilter::get_capacity() const {
+    if (number_hashes == 0)
+        return 0;
+    // Optimal number of keys for k hash functions: m ln 2 / k
+    return static_cast<size_t>(number_bits * log(2.0) / number_hashes);
+}
+
+double BloomFilter::get_saturation() const {
+    if (number_bits == 0)
+        return 0.0;
+    return static_cast<double>(bits_set) / number_bits;
+}
+
+double BloomFilter::estimate_false_positive_rate() const {
+    if (words.empty())
+        return 0.0;
+    /*
+     * A key never inserted is a false positive if all its bits are set in the
+     * one word it maps to, so the rate is the average over the words of their
+     * fill to the power k. This is higher than the saturation to the power k
+     * of a standard filter when the words are unevenly filled.
+     */
+    double total = 0.0;
+    for (uint64_t word : words)
+        total += pow(__builtin_popcountll(word) / 64.0, number_hashes);
+    return total / words.size();
+}
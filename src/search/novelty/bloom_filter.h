@@ -0,0 +1,80 @@
+#ifndef SEARCH_NOVELTY_BLOOM_FILTER_H_
+#define SEARCH_NOVELTY_BLOOM_FILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Bloom filter over 64-bit keys with a fixed size. Inserting a key that was
+ * never inserted before may wrongly report it as already present (false
+ * positive), but a key that was inserted is always reported as present.
+ *
+ * All the bits of a key are in one 64-bit word of the filter, which makes
+ * insertions much cheaper than spreading them over the whole filter, for a
+ * somewhat higher false positive rate at the same load.
+ *
+ * The bits are allocated on the first insertion, so filters that are never
+ * used cost nothing and copying an unused filter is cheap.
+ */
+class BloomFilter {
+    std::vector<std::uint64_t> words;
+    std::size_t number_bits;
+    int number_hashes;
+    std::size_t bits_set;
+    std::size_t insertions;
+    std::size_t new_keys;
+
+public:
+    BloomFilter() : BloomFilter(0, 0.0) {}
+
+    /*
+     * The number of bits is the largest power of two that fits in
+     * number_bytes, but at least 64, and the number of hash functions is
+     * the one for which a standard Bloom filter has the given false positive
+     * rate once it holds as many keys as it was designed for (see
+     * get_capacity).
+     */
+    BloomFilter(std::size_t number_bytes, double false_positive_rate);
+
+    /*
+     * Return true only if the key sets at least one new bit. A key never
+     * inserted whose bits are all set already (a false positive) returns false.
+     */
+    bool insert(std::uint64_t key);
+
+    bool is_allocated() const {
+        return !words.empty();
+    }
+
+    std::size_t get_number_bytes() const {
+        return number_bits / 8;
+    }
+
+    int get_number_hashes() const {
+        return number_hashes;
+    }
+
+    /*
+     * Number of keys a standard Bloom filter of the same size holds at the
+     * designed false positive rate. Keeping the bits of a key in one word
+     * gives a somewhat higher rate at that load, so this is an upper bound.
+     */
+    std::size_t get_capacity() const;
+
+    std::size_t get_insertions() const {
+        return insertions;
+    }
+
+    std::size_t get_new_keys() const {
+        return new_keys;
+    }
+
+    // Fraction of the bits that are set
+    double get_saturation() const;
+
+    // Probability that a key never inserted is reported as present, from the fill of each word
+    double estimate_false_positive_rate() const;
+};
+
+#endif //SEARCH_NOVELTY_BLOOM_FILTER_H_
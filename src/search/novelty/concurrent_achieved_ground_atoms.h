@@ -0,0 +1,146 @@
+#ifndef SEARCH_NOVELTY_CONCURRENT_ACHIEVED_GROUND_ATOMS_H_
+#define SEARCH_NOVELTY_CONCURRENT_ACHIEVED_GROUND_ATOMS_H_
+
+#include "../parallel_hashmap/phmap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/*
+ * Version of AchievedGroundAtoms that several threads can update at once.
+ *
+ * Atoms are identified by a single id, unique across predicates, and a pair
+ * of atoms by its two ids in increasing order, so there is one table for the
+ * atoms and one for the pairs, instead of one per predicate (pair). The tables
+ * are either bitmaps updated with atomic or-operations (dense mode, when every
+ * atom has an id in [0, number_atoms)) or hash sets with one lock per submap.
+ *
+ * Tables are allocated on the first insertion by whichever thread gets there
+ * first. In dense mode, the bit matrix of the pairs is only allocated if it
+ * fits in a budget of bytes shared by the buckets; otherwise the pairs go to
+ * a hash set as in the other mode.
+ */
+class ConcurrentAchievedGroundAtoms {
+    class Bitmap {
+        std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+
+    public:
+        explicit Bitmap(std::size_t number_bits)
+            : words(new std::atomic<std::uint64_t>[(number_bits + 63) / 64]()) {}
+
+        bool test_and_set(std::size_t i) {
+            std::uint64_t mask = std::uint64_t(1) << (i & 63);
+            std::atomic<std::uint64_t> &word = words[i >> 6];
+            // Most bits are already set after a while: avoid writing the cache line then
+            if (word.load(std::memory_order_relaxed) & mask)
+                return false;
+            return !(word.fetch_or(mask, std::memory_order_relaxed) & mask);
+        }
+    };
+
+    using HashSet = phmap::parallel_flat_hash_set<std::uint64_t,
+                                                  phmap::priv::hash_default_hash<std::uint64_t>,
+                                                  phmap::priv::hash_default_eq<std::uint64_t>,
+                                                  phmap::priv::Allocator<std::uint64_t>,
+                                                  4,
+                                                  std::mutex>;
+
+    bool dense;
+    std::size_t number_atoms;
+    std::atomic<Bitmap *> dense_k1;
+    std::atomic<Bitmap *> dense_k2;
+    std::atomic<HashSet *> k1;
+    std::atomic<HashSet *> k2;
+    std::atomic<std::size_t> *dense_k2_budget;
+    std::once_flag dense_k2_allocation;
+
+    template<class T, class... Args>
+    static T &get_or_allocate(std::atomic<T *> &table, Args... args) {
+        T *current = table.load(std::memory_order_acquire);
+        if (current)
+            return *current;
+        T *allocated = new T(args...);
+        if (table.compare_exchange_strong(current, allocated, std::memory_order_acq_rel)) {
+            return *allocated;
+        }
+        // Another thread allocated the table in the meantime
+        delete allocated;
+        return *current;
+    }
+
+    // Called once per bucket, leaves dense_k2 null if the budget is used up
+    void allocate_dense_k2() {
+        std::size_t number_bits = number_atoms * (number_atoms + 1) / 2;
+        std::size_t number_bytes = (number_bits + 63) / 64 * sizeof(std::uint64_t);
+        if (dense_k2_budget) {
+            std::size_t remaining = dense_k2_budget->load(std::memory_order_relaxed);
+            do {
+                if (remaining < number_bytes)
+                    return;
+            } while (!dense_k2_budget->compare_exchange_weak(remaining, remaining - number_bytes,
+                                                             std::memory_order_relaxed));
+        }
+        dense_k2.store(new Bitmap(number_bits), std::memory_order_release);
+    }
+
+    static std::uint64_t get_pair_key(std::uint32_t low, std::uint32_t high) {
+        return (std::uint64_t(high) << 32) | low;
+    }
+
+public:
+    ConcurrentAchievedGroundAtoms()
+        : dense(false), number_atoms(0), dense_k1(nullptr), dense_k2(nullptr), k1(nullptr), k2(nullptr),
+          dense_k2_budget(nullptr) {}
+
+    ~ConcurrentAchievedGroundAtoms() {
+        delete dense_k1.load();
+        delete dense_k2.load();
+        delete k1.load();
+        delete k2.load();
+    }
+
+    ConcurrentAchievedGroundAtoms(const ConcurrentAchievedGroundAtoms &) = delete;
+    ConcurrentAchievedGroundAtoms &operator=(const ConcurrentAchievedGroundAtoms &) = delete;
+
+    /*
+     * Must be called before any insertion. The budget, in bytes, is decreased
+     * by the size of every bit matrix of pairs allocated; null means no limit.
+     */
+    void use_dense_tables(std::size_t atoms, std::atomic<std::size_t> *pair_budget) {
+        dense = true;
+        number_atoms = atoms;
+        dense_k2_budget = pair_budget;
+    }
+
+    bool try_to_insert_atom_in_k1(int idx) {
+        assert(idx >= 0);
+        if (dense) {
+            assert(std::size_t(idx) < number_atoms);
+            return get_or_allocate(dense_k1, number_atoms).test_and_set(idx);
+        }
+        return get_or_allocate(k1).insert(idx).second;
+    }
+
+    bool try_to_insert_atom_in_k2(int idx_ga1, int idx_ga2) {
+        std::size_t low = std::min(idx_ga1, idx_ga2);
+        std::size_t high = std::max(idx_ga1, idx_ga2);
+        if (dense) {
+            assert(high < number_atoms);
+            Bitmap *bitmap = dense_k2.load(std::memory_order_acquire);
+            if (!bitmap) {
+                std::call_once(dense_k2_allocation, [this]() { allocate_dense_k2(); });
+                bitmap = dense_k2.load(std::memory_order_acquire);
+            }
+            if (bitmap)
+                return bitmap->test_and_set(high * (high + 1) / 2 + low);
+        }
+        return get_or_allocate(k2).insert(get_pair_key(low, high)).second;
+    }
+};
+
+#endif //SEARCH_NOVELTY_CONCURRENT_ACHIEVED_GROUND_ATOMS_H_
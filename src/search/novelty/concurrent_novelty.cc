@@ -0,0 +1,146 @@
+#include "concurrent_novelty.h"
+
+#include <iostream>
+
+using namespace std;
+
+ConcurrentNovelty::ConcurrentNovelty(const Task &task,
+                                     size_t number_goal_atoms,
+                                     size_t number_relevant_atoms,
+                                     int width,
+                                     bool dense_tables) : number_goal_atoms(number_goal_atoms),
+                                                          width(width),
+                                                          dense_tables(dense_tables),
+                                                          table(task.get_atom_table()),
+                                                          atom_counter(0),
+                                                          dense_pair_budget(MAX_DENSE_PAIR_BYTES) {
+    cout << "Total number of goal atoms: " << number_goal_atoms << endl;
+    cout << "Total number of relevant atoms: " << number_relevant_atoms << endl;
+
+    size_t number_layers = (number_relevant_atoms + 1) * (number_goal_atoms + 1);
+    achieved_atoms.reset(new ConcurrentAchievedGroundAtoms[number_layers]);
+
+    if (dense_tables) {
+        if (number_relaxed_reachable_atoms(task, width, true, dense_atom_mapping)) {
+            atom_counter = dense_atom_mapping.size();
+            for (size_t i = 0; i < number_layers; ++i)
+                achieved_atoms[i].use_dense_tables(atom_counter, &dense_pair_budget);
+        }
+        else {
+            this->dense_tables = false;
+            dense_atom_mapping.clear();
+        }
+    }
+}
+
+int ConcurrentNovelty::get_atom_id(long table_id) {
+    if (dense_tables) {
+        // Relaxed reachability is sound, so the dense ids should cover every atom
+        auto it = dense_atom_mapping.find(table_id);
+        if (it == dense_atom_mapping.end())
+            exit_with_missing_dense_atom(table_id);
+        return it->second;
+    }
+    int id = -1;
+    // Most atoms are known after a while, and a shared lock suffices to find them
+    if (atom_mapping.if_contains(table_id, [&id](const ConcurrentNoveltySet::value_type &entry) { id = entry.second; }))
+        return id;
+    atom_mapping.lazy_emplace_l(table_id,
+                           [&id](const ConcurrentNoveltySet::value_type &entry) { id = entry.second; },
+                           [&](const auto &ctor) {
+                               id = atom_counter++;
+                               ctor(table_id, id);
+                           });
+    return id;
+}
+
+void ConcurrentNovelty::map_state_atoms(const DBState &state, AtomIds &ids) {
+    ids.state.clear();
+    ids.predicates.clear();
+    const vector<Relation> &relations = state.get_relations();
+    const TupleIndices &tuples = state.get_tuple_indices(table);
+    for (size_t i = 0; i < relations.size(); ++i) {
+        long first_id = table.get_first_id(relations[i].predicate_symbol);
+        for (const long *tuple = tuples.begin(i); tuple != tuples.end(i); ++tuple) {
+            ids.state.push_back(get_atom_id(first_id + *tuple));
+            ids.predicates.push_back(relations[i].predicate_symbol);
+        }
+    }
+    ids.first_nullary = ids.state.size();
+    const vector<bool> &nullary_atoms = state.get_nullary_atoms();
+    for (size_t i = 0; i < nullary_atoms.size(); ++i) {
+        if (nullary_atoms[i]) {
+            ids.state.push_back(get_atom_id(table.get_first_id(i)));
+            ids.predicates.push_back(i);
+        }
+    }
+}
+
+int ConcurrentNovelty::compute_novelty(const DBState &state,
+                                       int number_unsatisfied_goals,
+                                       int number_unsatisfied_relevant_atoms,
+                                       AtomIds &ids) {
+    if (number_unsatisfied_goals == 0) {
+        return StandardNovelty::GOAL_STATE;
+    }
+    ConcurrentAchievedGroundAtoms &achieved_atoms_in_layer = get_layer(number_unsatisfied_goals,
+                                                                       number_unsatisfied_relevant_atoms);
+    map_state_atoms(state, ids);
+
+    int novelty = StandardNovelty::NOVELTY_GREATER_THAN_TWO;
+    for (int atom_id : ids.state) {
+        if (achieved_atoms_in_layer.try_to_insert_atom_in_k1(atom_id))
+            novelty = 1;
+    }
+    if (width == 1) return novelty;
+
+    /*
+     * The pairs are inserted even if the state has novelty 1. As in
+     * StandardNovelty, these are all the pairs of n-ary atoms and all the
+     * pairs of nullary atoms, including the ones of an atom with itself, but a
+     * nullary atom is only paired with the n-ary atoms of predicates with a
+     * smaller index.
+     */
+    for (size_t i = 0; i < ids.state.size(); ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            if (i >= ids.first_nullary && j < ids.first_nullary && ids.predicates[j] > ids.predicates[i])
+                continue;
+            bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k2(ids.state[i], ids.state[j]);
+            if (is_new and novelty != 1)
+                novelty = 2;
+        }
+    }
+    return novelty;
+}
+
+int ConcurrentNovelty::compute_novelty_from_operator(const DBState &state,
+                                                     int number_unsatisfied_goals,
+                                                     int number_unsatisfied_relevant_atoms,
+                                                     const vector<pair<int, GroundAtom>> &added_atoms,
+                                                     AtomIds &ids) {
+    if (number_unsatisfied_goals == 0) {
+        return StandardNovelty::GOAL_STATE;
+    }
+    ConcurrentAchievedGroundAtoms &achieved_atoms_in_layer = get_layer(number_unsatisfied_goals,
+                                                                       number_unsatisfied_relevant_atoms);
+
+    int novelty = StandardNovelty::NOVELTY_GREATER_THAN_TWO;
+    ids.added.clear();
+    for (const pair<int, GroundAtom> &atom : added_atoms) {
+        ids.added.push_back(get_atom_id(table.get_id(atom.first, atom.second)));
+        if (achieved_atoms_in_layer.try_to_insert_atom_in_k1(ids.added.back()))
+            novelty = 1;
+    }
+    if (width == 1) return novelty;
+
+    // Only pairs with an added atom can be new; as in StandardNovelty, they are paired with every atom
+    map_state_atoms(state, ids);
+    for (int added_id : ids.added) {
+        for (int atom_id : ids.state) {
+            bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k2(added_id, atom_id);
+            if (is_new and novelty != 1)
+                novelty = 2;
+        }
+    }
+    return novelty;
+}
@@ -0,0 +1,96 @@
+#ifndef SEARCH_NOVELTY_CONCURRENT_NOVELTY_H_
+#define SEARCH_NOVELTY_CONCURRENT_NOVELTY_H_
+
+#include "concurrent_achieved_ground_atoms.h"
+#include "standard_novelty.h"
+
+#include "../task.h"
+
+#include "../parallel_hashmap/phmap.h"
+#include "../states/state.h"
+#include "../structures.h"
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+/*
+ * Novelty evaluator checking the same atoms and pairs of atoms as
+ * StandardNovelty, but whose tables are shared by several threads evaluating states at the same time.
+ *
+ * Each thread passes its own AtomIds to the evaluation functions; everything
+ * else is shared. If two threads evaluate states with the same new atom at the
+ * same time, only one of them finds it new, as with a serial evaluation in
+ * some order.
+ */
+class ConcurrentNovelty {
+public:
+    /*
+     * Scratch space of one thread: the ids of the atoms of the evaluated
+     * state, the n-ary atoms first, and the predicate of each of them.
+     */
+    struct AtomIds {
+        std::vector<int> state;
+        std::vector<int> predicates;
+        std::size_t first_nullary = 0;
+        std::vector<int> added;
+    };
+
+private:
+    using ConcurrentNoveltySet = phmap::parallel_flat_hash_map<long, int,
+                                                               phmap::priv::hash_default_hash<long>,
+                                                               phmap::priv::hash_default_eq<long>,
+                                                               phmap::priv::Allocator<
+                                                                   phmap::priv::Pair<const long, int>>,
+                                                               4,
+                                                               std::shared_mutex>;
+
+    int number_goal_atoms;
+    int width;
+    bool dense_tables;
+    std::unique_ptr<ConcurrentAchievedGroundAtoms[]> achieved_atoms;
+    const AtomTable &table;
+
+    // Ids of the atoms of the AtomTable, fixed before the search with dense tables
+    NoveltySet dense_atom_mapping;
+    ConcurrentNoveltySet atom_mapping;
+    std::atomic<int> atom_counter;
+    // Bytes of bit matrices of atom pairs the buckets can still allocate
+    std::atomic<std::size_t> dense_pair_budget;
+
+    int get_atom_id(long table_id);
+
+    void map_state_atoms(const DBState &state, AtomIds &ids);
+
+    ConcurrentAchievedGroundAtoms &get_layer(int unreached_goal_atoms, int unreached_relevant_atoms) {
+        return achieved_atoms[unreached_relevant_atoms * (number_goal_atoms + 1) + unreached_goal_atoms];
+    }
+
+public:
+    /*
+     * With dense_tables, the atoms reachable from the initial state in the
+     * delete relaxation get consecutive ids before the search and the tables
+     * are bitmaps, as in StandardNovelty, including the budget of
+     * MAX_DENSE_PAIR_BYTES for the bit matrices of atom pairs.
+     */
+    ConcurrentNovelty(const Task &task,
+                      size_t number_goal_atoms,
+                      size_t number_relevant_atoms,
+                      int width,
+                      bool dense_tables);
+
+    int compute_novelty(const DBState &state,
+                        int number_unsatisfied_goals,
+                        int number_unsatisfied_relevant_atoms,
+                        AtomIds &ids);
+
+    int compute_novelty_from_operator(const DBState &state,
+                                      int number_unsatisfied_goals,
+                                      int number_unsatisfied_relevant_atoms,
+                                      const std::vector<std::pair<int, GroundAtom>> &added_atoms,
+                                      AtomIds &ids);
+};
+
+#endif //SEARCH_NOVELTY_CONCURRENT_NOVELTY_H_
@@ -1,7 +1,144 @@
 #include "standard_novelty.h"
 
+#include "../heuristics/utils.h"
+#include "../utils/system.h"
+
 using namespace std;
 
+void exit_with_missing_dense_atom(long table_id) {
+    cerr << "Atom " << table_id << " of a state is not relaxed reachable and has no id"
+         << " in the dense novelty tables." << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+bool number_relaxed_reachable_atoms(const Task &task, int width, bool exact_pairs, NoveltySet &ids) {
+    const AtomTable &table = task.get_atom_table();
+    vector<vector<GroundAtom>> reachable_atoms = compute_relaxed_reachable_atoms(task);
+    int number_atoms = 0;
+    for (size_t i = 0; i < reachable_atoms.size(); ++i) {
+        for (GroundAtom &atom : reachable_atoms[i]) {
+            ids.insert({table.get_id(i, atom), number_atoms++});
+        }
+    }
+    cout << "Relaxed reachable atoms: " << number_atoms << endl;
+    if (width == 2 && exact_pairs && size_t(number_atoms) * (number_atoms + 1) / 2 > MAX_DENSE_PAIR_BITS) {
+        cout << "Too many atoms for dense novelty tables of width 2, using hash tables" << endl;
+        return false;
+    }
+    cout << "Using dense novelty tables" << endl;
+    return true;
+}
+
+StandardNovelty::StandardNovelty(const Task &task,
+                                 size_t number_goal_atoms,
+                                 size_t number_relevant_atoms,
+                                 int width,
+                                 const NoveltyTableOptions &tables) : atom_counter(0),
+                                                                      number_goal_atoms(number_goal_atoms),
+                                                                      number_relevant_atoms(number_relevant_atoms),
+                                                                      width(width),
+                                                                      dense_tables(tables.dense_tables),
+                                                                      approximate_pairs(width == 2
+                                                                          && tables.bloom_filter_bytes > 0),
+                                                                      table(task.get_atom_table()) {
+    cout << "Total number of goal atoms: " << number_goal_atoms << endl;
+    cout << "Total number of relevant atoms: " << number_relevant_atoms << endl;
+
+    size_t n_relations = task.initial_state.get_relations().size();
+
+    if (dense_tables) {
+        if (number_relaxed_reachable_atoms(task, width, !approximate_pairs, atom_mapping)) {
+            atom_counter = atom_mapping.size();
+        }
+        else {
+            dense_tables = false;
+            atom_mapping.clear();
+        }
+    }
+
+    AchievedGroundAtoms empty_bucket;
+    if (dense_tables) {
+        empty_bucket = AchievedGroundAtoms(atom_counter, make_shared<size_t>(MAX_DENSE_PAIR_BYTES));
+    }
+    else {
+        int max_position = compute_position_of_predicate_indices_pair(n_relations - 1, n_relations);
+        empty_bucket = AchievedGroundAtoms(task, max_position);
+    }
+    if (approximate_pairs) {
+        BloomFilter filter(tables.bloom_filter_bytes, tables.false_positive_rate);
+        cout << "Using Bloom filters of " << filter.get_number_bytes() << " bytes and "
+             << filter.get_number_hashes() << " hash functions for the pairs of atoms (at most "
+             << filter.get_capacity() << " pairs per bucket at a false positive rate of "
+             << tables.false_positive_rate << ")" << endl;
+        empty_bucket.use_approximate_k2(filter);
+    }
+    achieved_atoms.resize((number_relevant_atoms + 1) * (number_goal_atoms + 1), empty_bucket);
+}
+
+void StandardNovelty::print_statistics() const {
+    if (dense_tables && width == 2 && !approximate_pairs) {
+        size_t dense_pair_tables = 0;
+        size_t hashed_pair_tables = 0;
+        for (const AchievedGroundAtoms &bucket : achieved_atoms) {
+            dense_pair_tables += bucket.has_dense_k2();
+            hashed_pair_tables += bucket.is_dense_k2_over_budget();
+        }
+        cout << "Novelty buckets with dense pair tables: " << dense_pair_tables
+             << ", with hashed pairs past the memory budget: " << hashed_pair_tables << endl;
+    }
+    if (!approximate_pairs)
+        return;
+    size_t number_filters = 0;
+    size_t number_bytes = 0;
+    size_t insertions = 0;
+    size_t new_pairs = 0;
+    double total_saturation = 0.0, max_saturation = 0.0;
+    double total_false_positive_rate = 0.0, max_false_positive_rate = 0.0;
+    for (const AchievedGroundAtoms &bucket : achieved_atoms) {
+        const BloomFilter &filter = bucket.get_k2_filter();
+        if (!filter.is_allocated())
+            continue;
+        ++number_filters;
+        number_bytes += filter.get_number_bytes();
+        insertions += filter.get_insertions();
+        new_pairs += filter.get_new_keys();
+        total_saturation += filter.get_saturation();
+        max_saturation = max(max_saturation, filter.get_saturation());
+        total_false_positive_rate += filter.estimate_false_positive_rate();
+        max_false_positive_rate = max(max_false_positive_rate, filter.estimate_false_positive_rate());
+    }
+    cout << "Novelty Bloom filters allocated: " << number_filters << " (" << number_bytes << " bytes)" << endl;
+    if (number_filters == 0)
+        return;
+    cout << "Novelty pairs of atoms checked: " << insertions << ", found new: " << new_pairs << endl;
+    cout << "Novelty Bloom filter saturation: average " << total_saturation / number_filters
+         << ", maximum " << max_saturation << endl;
+    // Chance that a pair never seen is taken for a seen one, i.e., that novelty 2 is missed
+    cout << "Novelty Bloom filter estimated false positive rate: average "
+         << total_false_positive_rate / number_filters
+         << ", maximum " << max_false_positive_rate << endl;
+}
+
+void StandardNovelty::map_state_atoms(const DBState &state) {
+    const vector<Relation> &relations = state.get_relations();
+    const TupleIndices &tuples = state.get_tuple_indices(table);
+    state_atom_ids.resize(relations.size());
+    for (size_t i = 0; i < relations.size(); ++i) {
+        long first_id = table.get_first_id(relations[i].predicate_symbol);
+        vector<int> &ids = state_atom_ids[i];
+        ids.clear();
+        for (const long *tuple = tuples.begin(i); tuple != tuples.end(i); ++tuple) {
+            ids.push_back(get_atom_id(first_id + *tuple));
+        }
+    }
+    const vector<bool> &nullary_atoms = state.get_nullary_atoms();
+    nullary_atom_ids.assign(nullary_atoms.size(), -1);
+    for (size_t i = 0; i < nullary_atoms.size(); ++i) {
+        if (nullary_atoms[i])
+            nullary_atom_ids[i] = get_atom_id(table.get_first_id(i));
+    }
+}
+
 int StandardNovelty::compute_novelty_k1(const Task &task,
                                         const DBState &state,
                                         int number_unsatisfied_goals,
@@ -13,6 +150,7 @@ int StandardNovelty::compute_novelty_k1(const Task &task,
 
     auto &achieved_atoms_in_layer = achieved_atoms[idx];
 
+    map_state_atoms(state);
 
     bool has_n_ary_novelty, has_nullary_novelty;
 
@@ -32,9 +170,7 @@ bool StandardNovelty::compute_k1_novelty_of_nullary_atoms(const DBState &state,
     const vector<bool>& nullary_atoms = state.get_nullary_atoms();
     for (size_t i = 0; i < nullary_atoms.size(); ++i) {
         if (nullary_atoms[i]) {
-            auto it = atom_mapping[i].insert({GroundAtom(), atom_counter + 1});
-            if (it.second) atom_counter++;
-            bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k1(i, it.first->second);
+            bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k1(i, nullary_atom_ids[i]);
             if (is_new) {
                 has_novel_atom = true;
             }
@@ -46,12 +182,11 @@ bool StandardNovelty::compute_k1_novelty_of_nullary_atoms(const DBState &state,
 bool StandardNovelty::compute_k1_novelty_of_n_ary_atoms(const DBState &state,
                                                         AchievedGroundAtoms &achieved_atoms_in_layer) {
     bool has_novel_atom = false;
-    for (const Relation &relation : state.get_relations()) {
-        int pred_symbol_idx = relation.predicate_symbol;
-        for (const GroundAtom& tuple : relation.tuples) {
-            auto it = atom_mapping[pred_symbol_idx].insert({tuple, atom_counter + 1});
-            if (it.second) atom_counter++;
-            bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k1(pred_symbol_idx, it.first->second);
+    const vector<Relation> &relations = state.get_relations();
+    for (size_t r = 0; r < relations.size(); ++r) {
+        int pred_symbol_idx = relations[r].predicate_symbol;
+        for (int atom_id : state_atom_ids[r]) {
+            bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k1(pred_symbol_idx, atom_id);
             if (is_new) {
                 has_novel_atom = true;
             }
@@ -90,16 +225,16 @@ int StandardNovelty::compute_k2_novelty_of_nullary_atoms(const DBState &state,
                                                          bool has_k1_novelty,
                                                          AchievedGroundAtoms &achieved_atoms_in_layer) {
     int novelty = NOVELTY_GREATER_THAN_TWO;
+    const vector<Relation> &relations = state.get_relations();
     const vector<bool>& nullary_atoms = state.get_nullary_atoms();
     for (size_t i = 0; i < nullary_atoms.size(); ++i) {
         if (nullary_atoms[i]) {
             int pred_symbol_idx1 = i;
-            int t1_idx = atom_mapping[pred_symbol_idx1][GroundAtom()];
-            for (const Relation &r2 : state.get_relations()) {
-                int pred_symbol_idx2 = r2.predicate_symbol;
+            int t1_idx = nullary_atom_ids[pred_symbol_idx1];
+            for (size_t r2 = 0; r2 < relations.size(); ++r2) {
+                int pred_symbol_idx2 = relations[r2].predicate_symbol;
                 if (pred_symbol_idx2 > pred_symbol_idx1) continue;
-                for (const GroundAtom &t2 : r2.tuples) {
-                    int t2_idx = atom_mapping[pred_symbol_idx2][t2];
+                for (int t2_idx : state_atom_ids[r2]) {
                     // We do not have the check if pred_symbol_idx2 == pred_symbol_idx1 because we always
                     // use the same empty tuple GroundAtom() for the nullary atoms.
                     bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k2(
@@ -116,7 +251,7 @@ int StandardNovelty::compute_k2_novelty_of_nullary_atoms(const DBState &state,
                     int pred_symbol_idx2 = j;
                     if (pred_symbol_idx2 > pred_symbol_idx1) continue;
                     // See comment above about the pred_symbol_idx2 == pred_symbol_idx1 check.
-                    int t2_idx = atom_mapping[pred_symbol_idx2][GroundAtom()];
+                    int t2_idx = nullary_atom_ids[pred_symbol_idx2];
                     bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k2(
                         compute_position_of_predicate_indices_pair(pred_symbol_idx1,
                                                                    pred_symbol_idx2),
@@ -135,16 +270,15 @@ int StandardNovelty::compute_k2_novelty_of_n_ary_atoms(const DBState &state,
                                                        bool has_k1_novelty,
                                                        AchievedGroundAtoms &achieved_atoms_in_layer) {
     int novelty = NOVELTY_GREATER_THAN_TWO;
-    for (const Relation &r1 : state.get_relations()) {
-        int pred_symbol_idx1 = r1.predicate_symbol;
-        for (const GroundAtom &t1 : r1.tuples) {
-            int t1_idx = atom_mapping[pred_symbol_idx1][t1];
-            for (const Relation &r2 : state.get_relations()) {
-                int pred_symbol_idx2 = r2.predicate_symbol;
+    const vector<Relation> &relations = state.get_relations();
+    for (size_t r1 = 0; r1 < relations.size(); ++r1) {
+        int pred_symbol_idx1 = relations[r1].predicate_symbol;
+        for (int t1_idx : state_atom_ids[r1]) {
+            for (size_t r2 = 0; r2 < relations.size(); ++r2) {
+                int pred_symbol_idx2 = relations[r2].predicate_symbol;
                 // We do this check so we do not insert each atom 2x in the set.
                 if (pred_symbol_idx2 > pred_symbol_idx1) continue;
-                for (const GroundAtom &t2 : r2.tuples) {
-                    int t2_idx = atom_mapping[pred_symbol_idx2][t2];
+                for (int t2_idx : state_atom_ids[r2]) {
                     bool is_new = false;
                     // This case split exists so we always check things in a given cannonical order.
                     // If pred_symbol_idx2 > pred_symbol_id1, the check in the lines above already
@@ -200,6 +334,7 @@ int StandardNovelty::compute_novelty_from_operator(const Task &task,
 
     bool has_k1_novelty = (novelty == 1);
 
+    map_state_atoms(state);
     novelty = std::min(novelty,
                        compute_k2_novelty_from_operators(state,
                                                          added_atoms,
@@ -216,12 +351,12 @@ int StandardNovelty::compute_k2_novelty_from_operators(const DBState &state,
                                                        const vector<bool> &nullary_atoms,
                                                        bool has_k1_novelty) {
     int novelty = NOVELTY_GREATER_THAN_TWO;
-    for (const pair<int, GroundAtom> &r1 : added_atoms) {
-        int pred_symbol_idx1 = r1.first;
-        const GroundAtom &t1 = r1.second;
-        int t1_idx = atom_mapping[pred_symbol_idx1][t1];
-        for (const Relation &r2 : state.get_relations()) {
-            int pred_symbol_idx2 = r2.predicate_symbol;
+    const vector<Relation> &relations = state.get_relations();
+    for (size_t a = 0; a < added_atoms.size(); ++a) {
+        int pred_symbol_idx1 = added_atoms[a].first;
+        int t1_idx = added_atom_ids[a];
+        for (size_t r2 = 0; r2 < relations.size(); ++r2) {
+            int pred_symbol_idx2 = relations[r2].predicate_symbol;
 
             // We cannot skip if pred_symbol_idx2 > pred_symbol_idx1, because added_atoms only has a subset
             // of the atoms. So, for example if added_atoms = {P(a)} and idx[P] = 1; we would never compare it
@@ -229,8 +364,7 @@ int StandardNovelty::compute_k2_novelty_from_operators(const DBState &state,
             // be done while looping through relation with idx 0. (See implementation of the original
             // functions without the optimization).
 
-            for (const GroundAtom &t2 : r2.tuples) {
-                int t2_idx = atom_mapping[pred_symbol_idx2][t2];
+            for (int t2_idx : state_atom_ids[r2]) {
                 bool is_new = check_tuple_novelty(achieved_atoms_in_layer,
                                                   pred_symbol_idx1,
                                                   t1_idx,
@@ -246,7 +380,7 @@ int StandardNovelty::compute_k2_novelty_from_operators(const DBState &state,
             if (nullary_atoms[i]) {
                 int pred_symbol_idx2 = i;
                 // See above why we cannot skip the case where pred_symbol_idx2 > pred_symbol_idx1.
-                int t2_idx = atom_mapping[pred_symbol_idx2][GroundAtom()];
+                int t2_idx = nullary_atom_ids[pred_symbol_idx2];
                 bool is_new = check_tuple_novelty(achieved_atoms_in_layer,
                                                   pred_symbol_idx1,
                                                   t1_idx,
@@ -266,12 +400,11 @@ int StandardNovelty::compute_k1_novelty_from_operators(const vector<std::pair<in
                                                                               GroundAtom>> &added_atoms,
                                                        AchievedGroundAtoms &achieved_atoms_in_layer) {
     int novelty = NOVELTY_GREATER_THAN_TWO;
+    added_atom_ids.clear();
     for (const pair<int, GroundAtom> &r1 : added_atoms) {
         int pred_symbol_idx = r1.first;
-        const GroundAtom &tuple = r1.second;
-        auto it = atom_mapping[pred_symbol_idx].insert({tuple, atom_counter + 1});
-        if (it.second) atom_counter++;
-        bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k1(pred_symbol_idx, it.first->second);
+        added_atom_ids.push_back(get_atom_id(table.get_id(pred_symbol_idx, r1.second)));
+        bool is_new = achieved_atoms_in_layer.try_to_insert_atom_in_k1(pred_symbol_idx, added_atom_ids.back());
         if (is_new) {
             novelty = 1;
         }
@@ -1,6 +1,7 @@
 #ifndef SEARCH_NOVELTY_STANDARD_NOVELTY_H_
 #define SEARCH_NOVELTY_STANDARD_NOVELTY_H_
 
+#include <cassert>
 #include <utility>
 
 #include <boost/functional/hash.hpp>
@@ -15,10 +16,51 @@
 #include "../structures.h"
 #include "../action.h"
 
+#include "../options.h"
 #include "../parallel_hashmap/phmap.h"
 #include "../utils/hash.h"
 
-typedef phmap::flat_hash_map<GroundAtom, int, utils::Hash<GroundAtom>> NoveltySet;
+// Maps the id of an atom in the AtomTable of the task to its id in the novelty tables
+typedef phmap::flat_hash_map<long, int> NoveltySet;
+
+/*
+ * Abort the search when an atom of a state has no id in dense novelty tables,
+ * which would otherwise be written out of the bounds of the tables.
+ */
+[[noreturn]] void exit_with_missing_dense_atom(long table_id);
+
+// Largest triangular bit matrix of atom pairs allocated per <#g, #r> bucket
+const std::size_t MAX_DENSE_PAIR_BITS = std::size_t(1) << 25;
+// Total size of the bit matrices of atom pairs of all the buckets of an evaluator
+const std::size_t MAX_DENSE_PAIR_BYTES = std::size_t(256) << 20;
+
+/*
+ * Give the atoms reachable from the initial state in the delete relaxation
+ * consecutive ids, mapped from their ids in the AtomTable of the task, for
+ * the dense novelty tables. Return false if the tables would be too large,
+ * i.e., if width 2 keeps exact pairs and the bit matrix of the pairs of a
+ * bucket would exceed MAX_DENSE_PAIR_BITS.
+ */
+bool number_relaxed_reachable_atoms(const Task &task, int width, bool exact_pairs, NoveltySet &ids);
+
+/*
+ * How StandardNovelty stores the atoms and pairs of atoms seen in each
+ * <#g, #r> bucket.
+ */
+struct NoveltyTableOptions {
+    // Number the relaxed reachable atoms before the search and use bitmaps
+    bool dense_tables;
+    // Size of the Bloom filter of the pairs of atoms of a bucket (0 = exact tables)
+    std::size_t bloom_filter_bytes;
+    double false_positive_rate;
+
+    NoveltyTableOptions() : dense_tables(false), bloom_filter_bytes(0), false_positive_rate(0.01) {}
+
+    explicit NoveltyTableOptions(const Options &opt)
+        : dense_tables(opt.get_dense_novelty_tables()),
+          bloom_filter_bytes(opt.get_novelty_bloom_filter_bytes()),
+          false_positive_rate(opt.get_novelty_false_positive_rate()) {}
+};
 
 /*
  *
@@ -32,8 +74,33 @@ class StandardNovelty {
     int number_goal_atoms;
     int number_relevant_atoms;
     int width;
+    bool dense_tables;
+    bool approximate_pairs;
     std::vector<AchievedGroundAtoms> achieved_atoms;
-    std::vector<NoveltySet> atom_mapping;
+    const AtomTable &table;
+    NoveltySet atom_mapping;
+
+    // Ids of the atoms of the state being evaluated, by relation and by nullary predicate
+    std::vector<std::vector<int>> state_atom_ids;
+    std::vector<int> nullary_atom_ids;
+    std::vector<int> added_atom_ids;
+
+    int get_atom_id(long table_id) {
+        if (dense_tables) {
+            // Relaxed reachability is sound, so the dense ids should cover every atom
+            auto it = atom_mapping.find(table_id);
+            if (it == atom_mapping.end())
+                exit_with_missing_dense_atom(table_id);
+            return it->second;
+        }
+        auto it = atom_mapping.insert({table_id, atom_counter + 1});
+        if (it.second) {
+            atom_counter++;
+        }
+        return it.first->second;
+    }
+
+    void map_state_atoms(const DBState &state);
 
     int compute_position_of_predicate_indices_pair(int idx_1, int idx_2);
 
@@ -86,24 +153,23 @@ public:
     static const int IW = 2;
     static const int IW_G = 3;
 
+    /*
+     * With dense_tables, the atoms reachable from the initial state in the
+     * delete relaxation get consecutive ids before the search, and the
+     * achieved atoms and pairs of atoms are kept in bitmaps instead of hash
+     * sets. Hash sets are still used if width 2 would need too large a bit
+     * matrix of pairs, and for the pairs of the buckets reached once the bit
+     * matrices of MAX_DENSE_PAIR_BYTES have been allocated.
+     *
+     * With a Bloom filter size, the pairs of atoms of width 2 are kept in a
+     * Bloom filter of that size per bucket instead. Memory is then bounded,
+     * but a state may be wrongly found not to have novelty 2.
+     */
     StandardNovelty(const Task &task,
                     size_t number_goal_atoms,
                     size_t number_relevant_atoms,
-                    int width) : atom_counter(0),
-                                                    number_goal_atoms(number_goal_atoms),
-                                                    number_relevant_atoms(number_relevant_atoms),
-                                                    width(width) {
-        std::cout << "Total number of goal atoms: " << number_goal_atoms << std::endl;
-        std:: cout << "Total number of relevant atoms: " << number_relevant_atoms << std::endl;
-
-        size_t n_relations = task.initial_state.get_relations().size();
-
-        atom_mapping.resize(n_relations);
-
-        int max_position = compute_position_of_predicate_indices_pair(n_relations - 1, n_relations);
-        achieved_atoms.resize((number_relevant_atoms+1) * (number_goal_atoms+1),
-                              AchievedGroundAtoms(task, max_position));
-    }
+                    int width,
+                    const NoveltyTableOptions &tables = NoveltyTableOptions());
 
     int compute_novelty(const Task &task,
                         const DBState &state,
@@ -120,6 +186,8 @@ public:
         return number_relevant_atoms;
     }
 
+    void print_statistics() const;
+
 };
 
 #endif //SEARCH_NOVELTY_STANDARD_NOVELTY_H_
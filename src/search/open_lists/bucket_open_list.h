@@ -0,0 +1,217 @@
+#ifndef SEARCH_OPEN_LISTS_BUCKET_OPEN_LIST_H_
+#define SEARCH_OPEN_LISTS_BUCKET_OPEN_LIST_H_
+
+#include "../search_engines/nodes.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+/*
+  FIFO queue stored in a contiguous buffer whose capacity is a power of two.
+  Buckets release it once they are drained (see DenseBucketLevel and
+  SparseBucketLevel), so it only holds memory while it holds entries.
+*/
+template<typename T>
+class RingBuffer {
+    std::vector<T> buffer;
+    std::size_t head;
+    std::size_t count;
+
+    void grow(const T &fill) {
+        std::vector<T> larger(buffer.empty() ? 4 : 2 * buffer.size(), fill);
+        for (std::size_t i = 0; i < count; ++i)
+            larger[i] = buffer[(head + i) & (buffer.size() - 1)];
+        buffer.swap(larger);
+        head = 0;
+    }
+
+public:
+    RingBuffer() : head(0), count(0) {}
+
+    void push_back(const T &value) {
+        if (count == buffer.size())
+            grow(value);
+        buffer[(head + count) & (buffer.size() - 1)] = value;
+        ++count;
+    }
+
+    T pop_front() {
+        assert(count > 0);
+        T value = buffer[head];
+        head = (head + 1) & (buffer.size() - 1);
+        --count;
+        return value;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+};
+
+/*
+  Inner level of a BucketOpenList: the entries are split by the first of the
+  remaining Levels keys, and each bucket orders its entries by the other keys.
+
+  Inner keys (g-values, goal counts) can span a range as large as the outer
+  ones, but a single bucket of the level above usually holds only a few of
+  them, so indexing them directly would cost memory in the product of the key
+  ranges. The buckets are instead kept in a vector sorted by decreasing key,
+  with only the keys that have entries: the minimum is at the back, and a
+  bucket is erased, with its memory, as soon as it is drained.
+*/
+template<std::size_t Levels>
+class SparseBucketLevel {
+    using Child = SparseBucketLevel<Levels - 1>;
+
+    std::vector<std::pair<int, Child>> buckets;
+
+public:
+    void push(const int *key, const StateID &entry) {
+        // First bucket whose key is not larger than key[0]
+        auto it = std::lower_bound(
+            buckets.begin(), buckets.end(), key[0],
+            [](const std::pair<int, Child> &bucket, int k) { return bucket.first > k; });
+        if (it == buckets.end() || it->first != key[0])
+            it = buckets.insert(it, std::make_pair(key[0], Child()));
+        it->second.push(key + 1, entry);
+    }
+
+    StateID pop() {
+        assert(!buckets.empty());
+        StateID result = buckets.back().second.pop();
+        if (buckets.back().second.empty())
+            buckets.pop_back();
+        return result;
+    }
+
+    bool empty() const {
+        return buckets.empty();
+    }
+};
+
+template<>
+class SparseBucketLevel<0> {
+    RingBuffer<StateID> queue;
+
+public:
+    void push(const int *, const StateID &entry) {
+        queue.push_back(entry);
+    }
+
+    StateID pop() {
+        return queue.pop_front();
+    }
+
+    bool empty() const {
+        return queue.empty();
+    }
+};
+
+/*
+  Outermost level of a BucketOpenList, split by its first key.
+
+  Keys are expected to be small non-negative integers (heuristic values,
+  novelty) and index a vector of buckets directly. The first non-empty bucket
+  can only move backwards on insertion, so the search for it on removal
+  resumes where the last one stopped. The few keys that are too large for a
+  vector, such as UNSOLVABLE_STATE, and negative keys are kept in a map, which
+  is checked before the buckets for negative keys and after them otherwise.
+  Drained buckets are reset, so only the bucket vector itself outlives the
+  entries.
+*/
+template<std::size_t Levels>
+class DenseBucketLevel {
+    using Child = SparseBucketLevel<Levels - 1>;
+
+    static const int MAX_DENSE_KEY = 1 << 16;
+
+    std::vector<Child> buckets;
+    std::map<int, Child> overflow;
+    // No bucket before first_candidate is non-empty
+    std::size_t first_candidate;
+    std::size_t size;
+
+    StateID pop_overflow(typename std::map<int, Child>::iterator it) {
+        StateID result = it->second.pop();
+        if (it->second.empty())
+            overflow.erase(it);
+        return result;
+    }
+
+public:
+    DenseBucketLevel() : first_candidate(0), size(0) {}
+
+    void push(const int *key, const StateID &entry) {
+        if (key[0] >= 0 && key[0] < MAX_DENSE_KEY) {
+            std::size_t k = key[0];
+            if (k >= buckets.size())
+                buckets.resize(k + 1);
+            buckets[k].push(key + 1, entry);
+            if (k < first_candidate)
+                first_candidate = k;
+        }
+        else {
+            overflow[key[0]].push(key + 1, entry);
+        }
+        ++size;
+    }
+
+    StateID pop() {
+        assert(size > 0);
+        --size;
+        auto it = overflow.begin();
+        if (it != overflow.end() && it->first < 0)
+            return pop_overflow(it);
+        while (first_candidate < buckets.size() && buckets[first_candidate].empty())
+            ++first_candidate;
+        if (first_candidate < buckets.size()) {
+            Child &bucket = buckets[first_candidate];
+            StateID result = bucket.pop();
+            if (bucket.empty())
+                bucket = Child();
+            return result;
+        }
+        assert(it != overflow.end());
+        return pop_overflow(it);
+    }
+
+    bool empty() const {
+        return size == 0;
+    }
+};
+
+/*
+  Open list ordered lexicographically by a fixed number of integer keys, and
+  in insertion order among entries with the same keys.
+
+  Any int is a valid key, but only first keys in [0, 2^16) are stored in
+  buckets; the others go through a std::map. Search engines should therefore
+  pass non-negative keys. Memory grows with the range of the first key and
+  with the number of entries, not with the range of the other keys.
+*/
+template<std::size_t Levels>
+class BucketOpenList {
+    DenseBucketLevel<Levels> buckets;
+
+public:
+    using Key = std::array<int, Levels>;
+
+    void do_insertion(const StateID &entry, const Key &key) {
+        buckets.push(key.data(), entry);
+    }
+
+    StateID remove_min() {
+        return buckets.pop();
+    }
+
+    bool empty() const {
+        return buckets.empty();
+    }
+};
+
+#endif //SEARCH_OPEN_LISTS_BUCKET_OPEN_LIST_H_
@@ -1,6 +1,7 @@
 #ifndef SEARCH_OPTIONS_H
 #define SEARCH_OPTIONS_H
 
+#include <algorithm>
 #include <iostream>
 
 #include <boost/program_options.hpp>
@@ -16,8 +17,18 @@ class Options {
     std::string plan_file;
     bool only_effects_opt;
     bool novelty_early_stop;
+    bool dense_novelty_tables;
+    unsigned novelty_bloom_filter_bytes;
+    double novelty_false_positive_rate;
+    bool stop_expansion_early;
+    unsigned expansion_budget;
     unsigned seed;
+    unsigned threads;
     bool forward_reachability;
+    bool incremental_grounding;
+    bool incremental_successors;
+    unsigned memory_budget;
+    std::string spill_directory;
 
 public:
     Options(int argc, char** argv) {
@@ -26,6 +37,7 @@ public:
             ("filename,f", po::value<std::string>()->default_value("output.lifted"), "Lifted task file name.")
             ("help,h", "Display this help message.")
             ("seed", po::value<unsigned>()->default_value(1), "Random seed.")
+            ("threads", po::value<unsigned>()->default_value(1), "Number of threads used for successor generation, batch heuristic evaluation or by the parallel search engines.")
             ("evaluator,e", po::value<std::string>()->required(), "Heuristic evaluator.")
             ("generator,g", po::value<std::string>()->required(), "Successor generator method.")
             ("search,s", po::value<std::string>()->required(), "Search engine.")
@@ -33,7 +45,16 @@ public:
             ("plan-file", po::value<std::string>()->default_value("FilePathUndefined"), "Plan file.")
             ("only-effects-novelty-check", po::value<bool>()->default_value(false), "Check only effects of applied actions when evaluation novelty of a state.")
             ("novelty-early-stop", po::value<bool>()->default_value(false), "Stop evaluating novelty as soon as w-value is defined.")
+            ("novelty-bloom-filter-bytes", po::value<unsigned>()->default_value(0), "Keep the pairs of atoms seen by the width-2 novelty evaluator in a Bloom filter of this size per <#g, #r> bucket, instead of exact tables (0 = exact tables).")
+            ("novelty-false-positive-rate", po::value<double>()->default_value(0.01), "False positive rate the novelty Bloom filters are designed for; sets their number of hash functions (strictly between 0 and 1).")
+            ("dense-novelty-tables", po::value<bool>()->default_value(false), "Number the atoms reachable in the delete relaxation before the search and keep the atoms and pairs of atoms seen by the novelty evaluator in bitmaps. At most 256 MiB of pair bitmaps are allocated in total; the buckets reached afterwards keep their pairs in hash sets.")
+            ("stop-expansion-early", po::value<bool>()->default_value(false), "Stop expanding a state in lazy search and BFWS at its first child reached by a useful operator (lazy search) or of novelty 1 (BFWS), and reopen it to generate the other children later.")
+            ("expansion-budget", po::value<unsigned>()->default_value(0), "Number of children opened by lazy search and BFWS before the expansion of a state is stopped and the state reopened (0 = no limit).")
             ("forward-reachability", po::value<bool>()->default_value(false), "Generate all fact layers")
+            ("incremental-grounding", po::value<bool>()->default_value(false), "Keep the ground rules of the add, hmax and ff heuristics between states.")
+            ("incremental-successors", po::value<bool>()->default_value(false), "Derive the applicable actions of a state from those of its parent with the join successor generators, and the assignment sets of the clique successor generators.")
+            ("memory-budget", po::value<unsigned>()->default_value(0), "Memory (in MiB) above which the search space moves its oldest states and nodes to a file (0 = keep everything in memory).")
+            ("spill-directory", po::value<std::string>()->default_value("."), "Directory of the file used by --memory-budget.")
             ;
 
         po::variables_map vm;
@@ -60,8 +81,23 @@ public:
         plan_file = vm["plan-file"].as<std::string>();
         only_effects_opt = vm["only-effects-novelty-check"].as<bool>();
         novelty_early_stop = vm["novelty-early-stop"].as<bool>();
+        dense_novelty_tables = vm["dense-novelty-tables"].as<bool>();
+        novelty_bloom_filter_bytes = vm["novelty-bloom-filter-bytes"].as<unsigned>();
+        novelty_false_positive_rate = vm["novelty-false-positive-rate"].as<double>();
+        if (!(novelty_false_positive_rate > 0 && novelty_false_positive_rate < 1)) {
+            std::cout << "Error with command-line options: --novelty-false-positive-rate must be "
+                      << "strictly between 0 and 1." << std::endl;
+            exit(1);
+        }
+        stop_expansion_early = vm["stop-expansion-early"].as<bool>();
+        expansion_budget = vm["expansion-budget"].as<unsigned>();
         seed = vm["seed"].as<unsigned>();
+        threads = std::max(1u, vm["threads"].as<unsigned>());
         forward_reachability = vm["forward-reachability"].as<bool>();
+        incremental_grounding = vm["incremental-grounding"].as<bool>();
+        incremental_successors = vm["incremental-successors"].as<bool>();
+        memory_budget = vm["memory-budget"].as<unsigned>();
+        spill_directory = vm["spill-directory"].as<std::string>();
 
     }
 
@@ -97,14 +133,54 @@ public:
         return novelty_early_stop;
     }
 
+    bool get_dense_novelty_tables() const {
+        return dense_novelty_tables;
+    }
+
+    unsigned get_novelty_bloom_filter_bytes() const {
+        return novelty_bloom_filter_bytes;
+    }
+
+    double get_novelty_false_positive_rate() const {
+        return novelty_false_positive_rate;
+    }
+
+    bool get_stop_expansion_early() const {
+        return stop_expansion_early;
+    }
+
+    unsigned get_expansion_budget() const {
+        return expansion_budget;
+    }
+
     unsigned get_seed() const {
         return seed;
     }
 
+    unsigned get_threads() const {
+        return threads;
+    }
+
     bool get_forward_reachability() const {
         return forward_reachability;
     }
 
+    bool get_incremental_grounding() const {
+        return incremental_grounding;
+    }
+
+    bool get_incremental_successors() const {
+        return incremental_successors;
+    }
+
+    unsigned get_memory_budget() const {
+        return memory_budget;
+    }
+
+    const std::string &get_spill_directory() const {
+        return spill_directory;
+    }
+
 
 };
 
@@ -23,10 +23,11 @@
 using namespace std;
 
 class AlternatedOpenListManager {
-    TieBreakingOpenList novelty_regular_open_list;
-    TieBreakingOpenList novelty_preferred_open_list;
-    GreedyOpenList hadd_preferred_open_list;
-    GreedyOpenList hadd_regular_open_list;
+    // Keys <novelty, #g, g> and <h, g>, all non-negative as BucketOpenList expects
+    BucketOpenList<3> novelty_regular_open_list;
+    BucketOpenList<3> novelty_preferred_open_list;
+    BucketOpenList<2> hadd_preferred_open_list;
+    BucketOpenList<2> hadd_regular_open_list;
 
     int counter;
     int priority;
@@ -107,7 +108,8 @@ utils::ExitCode AlternatedBFWS<PackedStateT>::search(const Task &task,
                                                               LiftedOperatorId::no_operator, StateID::no_state);
     utils::Timer t;
 
-    StandardNovelty novelty_evaluator(task, number_goal_conditions, number_relevant_atoms, width);
+    novelty = std::make_unique<StandardNovelty>(task, number_goal_conditions, number_relevant_atoms, width, novelty_tables);
+    StandardNovelty &novelty_evaluator = *novelty;
 
     int gc_h0 = gc.compute_heuristic(task.initial_state, task);
 
@@ -233,6 +235,8 @@ utils::ExitCode AlternatedBFWS<PackedStateT>::search(const Task &task,
 template <class PackedStateT>
 void AlternatedBFWS<PackedStateT>::print_statistics() const {
     statistics.print_detailed_statistics();
+    if (novelty)
+        novelty->print_statistics();
     space.print_statistics();
 }
 
@@ -250,7 +254,7 @@ AtomCounter AlternatedBFWS<PackedStateT>::initialize_counter_with_gc(const Task
         atoms[pred_idx].push_back(atomic_goal.get_arguments());
     }
 
-    return AtomCounter(atoms, positive, negative);
+    return AtomCounter(task.get_atom_table(), atoms, positive, negative);
 }
 
 
@@ -284,7 +288,7 @@ AtomCounter AlternatedBFWS<PackedStateT>::initialize_counter_with_useful_atoms(c
         ++pred_idx;
     }
 
-    return AtomCounter(atoms, positive, negative);
+    return AtomCounter(task.get_atom_table(), atoms, positive, negative);
 }
 
 // explicit template instantiations
@@ -10,16 +10,19 @@
 #include "../novelty/node_novelty.h"
 #include "../novelty/standard_novelty.h"
 
-#include "../open_lists/tiebreaking_open_list.h"
-#include "../open_lists/greedy_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 
 #include "../options.h"
 
+#include <memory>
+
 template <class PackedStateT>
 class AlternatedBFWS : public SearchBase {
     AtomCounter atom_counter;
     int width;
     bool only_effects_opt;
+    NoveltyTableOptions novelty_tables;
+    std::unique_ptr<StandardNovelty> novelty;
 
     std::string heuristic_type;
 
@@ -31,7 +34,8 @@ protected:
     AtomCounter initialize_counter_with_gc(const Task &task);
 
 public:
-    explicit AlternatedBFWS(int width, const Options &opt) : width(width) {
+    explicit AlternatedBFWS(int width, const Options &opt)
+        : width(width), novelty_tables(opt) {
         std::cout << "Using Dual-Queue BFWS" << std::endl;
         // By default we use h-add as heuristic, unless explicitly asked to use FF
         heuristic_type = opt.get_evaluator();
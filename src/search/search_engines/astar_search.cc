@@ -2,7 +2,7 @@
 #include "search.h"
 #include "utils.h"
 
-#include "../open_lists/greedy_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 #include "../states/extensional_states.h"
 #include "../states/sparse_states.h"
 #include "../successor_generators/successor_generator.h"
@@ -24,7 +24,8 @@ utils::ExitCode AStarSearch<PackedStateT>::search(const Task &task,
     const auto action_schemas = task.get_action_schemas();
     StatePackerT packer(task);
 
-    GreedyOpenList queue;
+    // Keys <f, h>, both non-negative as BucketOpenList expects
+    BucketOpenList<2> queue;
 
     SearchNode& root_node = space.insert_or_get_previous_node(packer.pack(task.initial_state), LiftedOperatorId::no_operator, StateID::no_state);
     utils::Timer t;
@@ -39,7 +40,7 @@ utils::ExitCode AStarSearch<PackedStateT>::search(const Task &task,
     statistics.inc_evaluations();
     cout << "Initial heuristic value " << heuristic_layer << endl;
     statistics.report_f_value_progress(heuristic_layer);
-    queue.do_insertion(root_node.state_id, make_pair(heuristic_layer+0, heuristic_layer));
+    queue.do_insertion(root_node.state_id, {heuristic_layer+0, heuristic_layer});
 
     if (check_goal(task, generator, timer_start, task.initial_state, root_node, space)) return utils::ExitCode::SUCCESS;
 
@@ -89,13 +90,13 @@ utils::ExitCode AStarSearch<PackedStateT>::search(const Task &task,
                 // Inserted for the first time in the map
                 child_node.open(dist, new_h);
                 statistics.inc_evaluated_states();
-                queue.do_insertion(child_node.state_id, make_pair(new_h+dist, new_h));
+                queue.do_insertion(child_node.state_id, {new_h+dist, new_h});
             }
             else {
                 if (dist < child_node.g) {
                     child_node.open(dist, new_h); // Reopening
                     statistics.inc_reopened();
-                    queue.do_insertion(child_node.state_id, make_pair(new_h+dist, new_h));
+                    queue.do_insertion(child_node.state_id, {new_h+dist, new_h});
                 }
             }
         }
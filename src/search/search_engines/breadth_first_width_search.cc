@@ -2,7 +2,7 @@
 #include "search.h"
 #include "utils.h"
 
-#include "../open_lists/tiebreaking_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 
 #include "../heuristics/ff_heuristic.h"
 
@@ -10,6 +10,7 @@
 #include "../states/sparse_states.h"
 
 #include "../parallel_hashmap/phmap.h"
+#include "../successor_generators/applicable_action_iterator.h"
 #include "../successor_generators/successor_generator.h"
 
 #include <iostream>
@@ -24,7 +25,11 @@ BreadthFirstWidthSearch<PackedStateT>::BreadthFirstWidthSearch(int width,
                                                                int method) : width(width),
                                                                              method(method),
                                                                              only_effects_opt(opt.get_only_effects_opt()),
-                                                                             early_stop(opt.get_novelty_early_stop()) {
+                                                                             early_stop(opt.get_novelty_early_stop()),
+                                                                             novelty_tables(opt),
+                                                                             stop_expansion_early(opt.get_stop_expansion_early()),
+                                                                             expansion_budget(opt.get_expansion_budget()),
+                                                                             stopped_expansions(0) {
     if ((method == StandardNovelty::IW) || (method == StandardNovelty::IW_G)) {
         prune_states = true;
     }
@@ -61,9 +66,10 @@ utils::ExitCode BreadthFirstWidthSearch<PackedStateT>::search(const Task &task,
         number_relevant_atoms = 0;
     }
 
-    // We use a GreedyOpenList (ordered by the novelty value) for now. This is done to make the
+    // We use an open list ordered by the novelty value for now. This is done to make the
     // search algorithm complete.
-    TieBreakingOpenList queue;
+    // Keys <novelty, #g, g>, all non-negative as BucketOpenList expects
+    BucketOpenList<3> queue;
 
     phmap::flat_hash_map<int, NodeNovelty> map_state_to_evaluators;
 
@@ -71,7 +77,8 @@ utils::ExitCode BreadthFirstWidthSearch<PackedStateT>::search(const Task &task,
         LiftedOperatorId::no_operator, StateID::no_state);
     utils::Timer t;
 
-    StandardNovelty novelty_evaluator(task, number_goal_conditions, number_relevant_atoms, width);
+    novelty = std::make_unique<StandardNovelty>(task, number_goal_conditions, number_relevant_atoms, width, novelty_tables);
+    StandardNovelty &novelty_evaluator = *novelty;
 
     int gc_h0 = gc.compute_heuristic(task.initial_state, task);
 
@@ -113,10 +120,20 @@ utils::ExitCode BreadthFirstWidthSearch<PackedStateT>::search(const Task &task,
         int unsatisfied_goal_parent = map_state_to_evaluators.at(sid.id()).unsatisfied_goals;
         int unsatisfied_relevant_atoms_parent = map_state_to_evaluators.at(sid.id()).unsatisfied_relevant_atoms;
 
-        const auto applicable = generator.get_applicable_actions(action_schemas, state);
-        statistics.inc_generated(applicable.size());
-
-        for (const LiftedOperatorId& op_id:applicable) {
+        /*
+         * The applicable actions are instantiated as the children are
+         * generated, so the expansion can stop at a goal, or at a novelty-1
+         * child or once the budget is spent if requested. The state is then
+         * reopened: when it is expanded again, the children generated so far
+         * are duplicates and the expansion goes on with the other ones.
+         */
+        ApplicableActionIterator applicable(generator, action_schemas, state);
+        unsigned opened_children = 0;
+        bool stopped = false;
+
+        while (const LiftedOperatorId *op = applicable.next()) {
+            const LiftedOperatorId &op_id = *op;
+            statistics.inc_generated();
             const auto &action = action_schemas[op_id.get_index()];
             DBState s = generator.generate_successor(op_id, action, state);
             auto& child_node = space.insert_or_get_previous_node(packer.pack(s), op_id, node.state_id);
@@ -161,6 +178,20 @@ utils::ExitCode BreadthFirstWidthSearch<PackedStateT>::search(const Task &task,
             if (check_goal(task, generator, timer_start, s, child_node, space)) return utils::ExitCode::SUCCESS;
             queue.do_insertion(child_node.state_id, {novelty_value, unsatisfied_goals, dist});
             map_state_to_evaluators.insert({child_node.state_id.id(), NodeNovelty(unsatisfied_goals, unsatisfied_relevant_atoms)});
+
+            ++opened_children;
+            if ((stop_expansion_early and novelty_value == 1)
+                or (expansion_budget > 0 and opened_children >= expansion_budget)) {
+                // Nothing is left to expand if this was the last applicable action
+                stopped = not applicable.done();
+                break;
+            }
+        }
+
+        if (stopped) {
+            ++stopped_expansions;
+            node.open(g, node.h);
+            queue.do_insertion(sid, {node.h, unsatisfied_goal_parent, g});
         }
     }
 
@@ -174,6 +205,10 @@ utils::ExitCode BreadthFirstWidthSearch<PackedStateT>::search(const Task &task,
 template <class PackedStateT>
 void BreadthFirstWidthSearch<PackedStateT>::print_statistics() const {
     statistics.print_detailed_statistics();
+    if (novelty)
+        novelty->print_statistics();
+    if (stop_expansion_early or expansion_budget > 0)
+        cout << "Expansions stopped early: " << stopped_expansions << endl;
     space.print_statistics();
 }
 
@@ -190,7 +225,7 @@ AtomCounter BreadthFirstWidthSearch<PackedStateT>::initialize_counter_with_gc(co
          atoms[pred_idx].push_back(atomic_goal.get_arguments());
      }
 
-    return AtomCounter(atoms, positive, negative);
+    return AtomCounter(task.get_atom_table(), atoms, positive, negative);
 }
 
 
@@ -225,7 +260,7 @@ AtomCounter BreadthFirstWidthSearch<PackedStateT>::initialize_counter_with_usefu
         ++pred_idx;
     }
 
-    return AtomCounter(atoms, positive, negative);
+    return AtomCounter(task.get_atom_table(), atoms, positive, negative);
 }
 
 // explicit template instantiations
@@ -10,6 +10,8 @@
 
 #include "../options.h"
 
+#include <memory>
+
 template <class PackedStateT>
 class BreadthFirstWidthSearch : public SearchBase {
     AtomCounter atom_counter;
@@ -18,6 +20,11 @@ class BreadthFirstWidthSearch : public SearchBase {
     bool prune_states;
     bool only_effects_opt;
     bool early_stop;
+    NoveltyTableOptions novelty_tables;
+    std::unique_ptr<StandardNovelty> novelty;
+    bool stop_expansion_early;
+    unsigned expansion_budget;
+    int stopped_expansions;
 
 protected:
     SearchSpace<PackedStateT> space;
@@ -35,10 +35,11 @@ utils::ExitCode DualQueueBFWS<PackedStateT>::search(const Task &task,
     atom_counter = initialize_counter_with_useful_atoms(task, delete_free_h);
     number_relevant_atoms = atom_counter.get_total_number_of_atoms();
 
-    // We use a GreedyOpenList (ordered by the novelty value) for now. This is done to make the
+    // We use an open list ordered by the novelty value for now. This is done to make the
     // search algorithm complete.
-    TieBreakingOpenList regular_open_list;
-    TieBreakingOpenList preferred_open_list;
+    // Keys <novelty, #g, g>, all non-negative as BucketOpenList expects
+    BucketOpenList<3> regular_open_list;
+    BucketOpenList<3> preferred_open_list;
 
     phmap::flat_hash_map<int, NodeNovelty> map_state_to_evaluators;
 
@@ -46,7 +47,8 @@ utils::ExitCode DualQueueBFWS<PackedStateT>::search(const Task &task,
                                                               LiftedOperatorId::no_operator, StateID::no_state);
     utils::Timer t;
 
-    StandardNovelty novelty_evaluator(task, number_goal_conditions, number_relevant_atoms, width);
+    novelty = std::make_unique<StandardNovelty>(task, number_goal_conditions, number_relevant_atoms, width, novelty_tables);
+    StandardNovelty &novelty_evaluator = *novelty;
 
     int gc_h0 = gc.compute_heuristic(task.initial_state, task);
 
@@ -146,6 +148,8 @@ utils::ExitCode DualQueueBFWS<PackedStateT>::search(const Task &task,
 template <class PackedStateT>
 void DualQueueBFWS<PackedStateT>::print_statistics() const {
     statistics.print_detailed_statistics();
+    if (novelty)
+        novelty->print_statistics();
     space.print_statistics();
 }
 
@@ -163,7 +167,7 @@ AtomCounter DualQueueBFWS<PackedStateT>::initialize_counter_with_gc(const Task &
         atoms[pred_idx].push_back(atomic_goal.get_arguments());
     }
 
-    return AtomCounter(atoms, positive, negative);
+    return AtomCounter(task.get_atom_table(), atoms, positive, negative);
 }
 
 
@@ -197,7 +201,7 @@ AtomCounter DualQueueBFWS<PackedStateT>::initialize_counter_with_useful_atoms(co
         ++pred_idx;
     }
 
-    return AtomCounter(atoms, positive, negative);
+    return AtomCounter(task.get_atom_table(), atoms, positive, negative);
 }
 
 template<class PackedStateT>
@@ -10,16 +10,20 @@
 #include "../novelty/node_novelty.h"
 #include "../novelty/standard_novelty.h"
 
-#include "../open_lists/tiebreaking_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 
 #include "../options.h"
 
+#include <memory>
+
 
 template <class PackedStateT>
 class DualQueueBFWS : public SearchBase {
     AtomCounter atom_counter;
     int width;
     bool only_effects_opt;
+    NoveltyTableOptions novelty_tables;
+    std::unique_ptr<StandardNovelty> novelty;
 
     int priority_preferred;
     int priority_regular;
@@ -28,7 +32,7 @@ class DualQueueBFWS : public SearchBase {
 
     void boost_priority_queue();
 
-    StateID get_top_node(TieBreakingOpenList &preferred, TieBreakingOpenList &other) {
+    StateID get_top_node(BucketOpenList<3> &preferred, BucketOpenList<3> &other) {
         if ((priority_preferred > priority_regular) and (not preferred.empty())) {
             priority_preferred--;
             return preferred.remove_min();
@@ -45,7 +49,8 @@ protected:
     AtomCounter initialize_counter_with_gc(const Task &task);
 
 public:
-    explicit DualQueueBFWS(int width, const Options &opt) : width(width) {
+    explicit DualQueueBFWS(int width, const Options &opt)
+        : width(width), novelty_tables(opt) {
         std::cout << "Using Dual-Queue BFWS" << std::endl;
         priority_preferred = BOOST_PREF_OPEN_LIST;
         priority_regular = 0;
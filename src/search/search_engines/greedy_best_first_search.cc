@@ -5,7 +5,7 @@
 #include "../action.h"
 
 #include "../heuristics/heuristic.h"
-#include "../open_lists/greedy_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 #include "../states/extensional_states.h"
 #include "../states/sparse_states.h"
 #include "../successor_generators/successor_generator.h"
@@ -27,8 +27,14 @@ utils::ExitCode GreedyBestFirstSearch<PackedStateT>::search(const Task &task,
     clock_t timer_start = clock();
     const auto action_schemas = task.get_action_schemas();
     StatePackerT packer(task);
+    heuristic.set_num_threads(num_threads, task);
 
-    GreedyOpenList queue;
+    // Keys <h, g>, both non-negative as BucketOpenList expects
+    BucketOpenList<2> queue;
+
+    vector<DBState> successors;
+    vector<StateID> child_ids;
+    vector<int> h_values;
 
     SearchNode& root_node = space.insert_or_get_previous_node(packer.pack(task.initial_state), LiftedOperatorId::no_operator, StateID::no_state);
     utils::Timer t;
@@ -43,7 +49,7 @@ utils::ExitCode GreedyBestFirstSearch<PackedStateT>::search(const Task &task,
     statistics.inc_evaluations();
     cout << "Initial heuristic value " << heuristic_layer << endl;
     statistics.report_f_value_progress(heuristic_layer);
-    queue.do_insertion(root_node.state_id, make_pair(heuristic_layer, 0));
+    queue.do_insertion(root_node.state_id, {heuristic_layer, 0});
 
     if (check_goal(task, generator, timer_start, task.initial_state, root_node, space)) return utils::ExitCode::SUCCESS;
 
@@ -75,13 +81,26 @@ utils::ExitCode GreedyBestFirstSearch<PackedStateT>::search(const Task &task,
         const auto applicable = generator.get_applicable_actions(action_schemas, state);
         statistics.inc_generated(applicable.size());
 
+        /*
+         * All successors are registered first and then evaluated together, so
+         * the heuristic can spread the evaluations over several threads.
+         */
+        successors.clear();
+        child_ids.clear();
         for (const LiftedOperatorId& op_id:applicable) {
             const auto &action = action_schemas[op_id.get_index()];
             DBState s = generator.generate_successor(op_id, action, state);
-            auto& child_node = space.insert_or_get_previous_node(packer.pack(s), op_id, node.state_id);
-            int dist = g + action.get_cost();
-            int new_h = heuristic.compute_heuristic(s, task);
-            statistics.inc_evaluations();
+            auto& child_node = space.insert_or_get_previous_node(packer.pack(s), op_id, sid);
+            child_ids.push_back(child_node.state_id);
+            successors.push_back(std::move(s));
+        }
+        heuristic.compute_heuristic_batch(successors, task, h_values);
+        statistics.inc_evaluations(successors.size());
+
+        for (size_t i = 0; i < successors.size(); ++i) {
+            auto& child_node = space.get_node(child_ids[i]);
+            int dist = g + action_schemas[applicable[i].get_index()].get_cost();
+            int new_h = h_values[i];
             if (new_h == UNSOLVABLE_STATE) {
                 if (child_node.status == SearchNode::Status::NEW) {
                     // Only increase statistics for new dead-ends
@@ -96,13 +115,13 @@ utils::ExitCode GreedyBestFirstSearch<PackedStateT>::search(const Task &task,
                 // Inserted for the first time in the map
                 child_node.open(dist, new_h);
                 statistics.inc_evaluated_states();
-                queue.do_insertion(child_node.state_id, make_pair(new_h, dist));
+                queue.do_insertion(child_node.state_id, {new_h, dist});
             }
             else {
                 if (dist < child_node.g) {
                     child_node.open(dist, new_h); // Reopening
                     statistics.inc_reopened();
-                    queue.do_insertion(child_node.state_id, make_pair(new_h, dist));
+                    queue.do_insertion(child_node.state_id, {new_h, dist});
                 }
             }
         }
@@ -4,6 +4,7 @@
 
 #include "search.h"
 #include "search_space.h"
+#include "../options.h"
 
 template <class PackedStateT>
 class GreedyBestFirstSearch : public SearchBase {
@@ -11,7 +12,11 @@ protected:
     SearchSpace<PackedStateT> space;
 
     int heuristic_layer{};
+    // Threads evaluating the successors of an expanded state
+    unsigned num_threads;
 public:
+    explicit GreedyBestFirstSearch(const Options &opt) : num_threads(opt.get_threads()) {}
+
     using StatePackerT = typename PackedStateT::StatePackerT;
 
     utils::ExitCode search(const Task &task, SuccessorGenerator &generator, Heuristic &heuristic) override;
@@ -0,0 +1,315 @@
+#include "hash_distributed_search.h"
+#include "search.h"
+#include "utils.h"
+
+#include "../action.h"
+#include "../task.h"
+
+#include "../heuristics/heuristic.h"
+#include "../heuristics/heuristic_factory.h"
+#include "../states/extensional_states.h"
+#include "../states/sparse_states.h"
+#include "../successor_generators/successor_generator.h"
+#include "../successor_generators/successor_generator_factory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+template <class PackedStateT>
+HashDistributedSearch<PackedStateT>::HashDistributedSearch(Mode mode, const Options &opt)
+    : mode(mode),
+      opt(opt),
+      pending_work(0),
+      stop(false),
+      best_heuristic_value(numeric_limits<int>::max()),
+      incumbent_cost(numeric_limits<int>::max()),
+      goal_node(nullptr),
+      goal_shard(-1)
+{
+}
+
+template <class PackedStateT>
+HashDistributedSearch<PackedStateT>::~HashDistributedSearch() = default;
+
+template <class PackedStateT>
+int HashDistributedSearch<PackedStateT>::get_shard(const PackedStateT &state) const
+{
+    /*
+     * Scramble the hash before taking the remainder. The shards use the same
+     * hash function in their hash sets, which would otherwise only see keys
+     * with identical low bits.
+     */
+    uint64_t h = typename PackedStateT::HashT()(state);
+    h *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<int>((h >> 32) % workers.size());
+}
+
+template <class PackedStateT>
+array<int, 2> HashDistributedSearch<PackedStateT>::get_key(int g, int h) const
+{
+    if (mode == Mode::ASTAR)
+        return {g + h, h};
+    return {h, g};
+}
+
+template <class PackedStateT>
+void HashDistributedSearch<PackedStateT>::insert_state(const Task &task,
+                                                       int shard,
+                                                       PackedStateT &&state,
+                                                       const LiftedOperatorId &op,
+                                                       StateID parent,
+                                                       int parent_shard,
+                                                       int g)
+{
+    Worker &worker = *workers[shard];
+    SearchNode &node = worker.space.insert_or_get_previous_node(std::move(state), op, parent);
+    size_t id = node.state_id.id();
+
+    if (node.status == SearchNode::Status::NEW) {
+        if (worker.parent_shard.size() <= id)
+            worker.parent_shard.resize(id + 1, -1);
+        worker.parent_shard[id] = parent_shard;
+
+        DBState s = worker.packer->unpack(worker.space.get_state(node.state_id));
+        int h = worker.heuristic->compute_heuristic(s, task);
+        worker.statistics.inc_evaluations();
+        node.open(g, h);
+        if (h == UNSOLVABLE_STATE) {
+            worker.statistics.inc_dead_ends();
+            worker.statistics.inc_pruned_states();
+            return;
+        }
+        worker.statistics.inc_evaluated_states();
+        if (mode == Mode::ASTAR && g + h >= incumbent_cost.load(memory_order_relaxed))
+            return;
+        worker.open_list.do_insertion(node.state_id, get_key(g, h));
+    }
+    else if (g < node.g && node.h != UNSOLVABLE_STATE) {
+        // Reopening: the new path is cheaper, so it also becomes the path of the plan
+        node.open(g, node.h);
+        worker.space.set_parent(node, op, parent);
+        worker.parent_shard[id] = parent_shard;
+        worker.statistics.inc_reopened();
+        if (mode == Mode::ASTAR && g + node.h >= incumbent_cost.load(memory_order_relaxed))
+            return;
+        worker.open_list.do_insertion(node.state_id, get_key(g, node.h));
+    }
+}
+
+template <class PackedStateT>
+void HashDistributedSearch<PackedStateT>::expand(const Task &task, int shard, StateID sid)
+{
+    Worker &worker = *workers[shard];
+    SearchNode &node = worker.space.get_node(sid);
+    if (node.status == SearchNode::Status::CLOSED)
+        return;
+    node.close();
+    int g = node.g;
+    int h = node.h;
+    if (mode == Mode::ASTAR && g + h >= incumbent_cost.load(memory_order_relaxed))
+        return;
+
+    worker.statistics.inc_expanded();
+
+    int best_h = best_heuristic_value.load(memory_order_relaxed);
+    while (h < best_h) {
+        if (best_heuristic_value.compare_exchange_weak(best_h, h)) {
+            lock_guard<mutex> lock(output_mutex);
+            cout << "New heuristic value expanded: h=" << h
+                 << " [worker: " << shard
+                 << ", expansions: " << worker.statistics.get_expanded()
+                 << ", evaluations: " << worker.statistics.get_evaluations()
+                 << ", generations: " << worker.statistics.get_generated() << "]" << '\n';
+            break;
+        }
+    }
+
+    DBState state = worker.packer->unpack(worker.space.get_state(sid));
+    if (task.is_goal(state)) {
+        lock_guard<mutex> lock(goal_mutex);
+        if (g < incumbent_cost.load(memory_order_relaxed)) {
+            incumbent_cost.store(g, memory_order_relaxed);
+            goal_node = &node;
+            goal_shard = shard;
+        }
+        if (mode == Mode::GBFS)
+            stop.store(true, memory_order_relaxed);
+        return;
+    }
+
+    const auto &action_schemas = task.get_action_schemas();
+    const auto applicable = worker.generator->get_applicable_actions(action_schemas, state);
+    worker.statistics.inc_generated(applicable.size());
+
+    for (const LiftedOperatorId &op_id : applicable) {
+        const auto &action = action_schemas[op_id.get_index()];
+        DBState s = worker.generator->generate_successor(op_id, action, state);
+        PackedStateT packed = worker.packer->pack(s);
+        int dist = g + action.get_cost();
+        int owner = get_shard(packed);
+        if (owner == shard) {
+            insert_state(task, shard, std::move(packed), op_id, sid, shard, dist);
+        }
+        else {
+            // Count the message before it becomes visible to the receiver
+            pending_work.fetch_add(1);
+            workers[owner]->inbox.push(StateMessage{std::move(packed), op_id, sid, shard, dist});
+        }
+    }
+}
+
+template <class PackedStateT>
+void HashDistributedSearch<PackedStateT>::run_worker(const Task &task, int shard)
+{
+    Worker &worker = *workers[shard];
+    bool active = true;
+    while (!stop.load(memory_order_relaxed)) {
+        if (!worker.inbox.empty()) {
+            if (!active) {
+                pending_work.fetch_add(1);
+                active = true;
+            }
+            size_t received = worker.inbox.consume_all([&](StateMessage &&m) {
+                insert_state(task, shard, std::move(m.state), m.op, m.parent, m.parent_shard, m.g);
+            });
+            pending_work.fetch_sub(received);
+        }
+
+        if (!worker.open_list.empty()) {
+            expand(task, shard, worker.open_list.remove_min());
+            continue;
+        }
+
+        if (active) {
+            active = false;
+            pending_work.fetch_sub(1);
+        }
+        if (pending_work.load() == 0)
+            break;
+        this_thread::yield();
+    }
+}
+
+template <class PackedStateT>
+vector<LiftedOperatorId> HashDistributedSearch<PackedStateT>::extract_plan() const
+{
+    vector<LiftedOperatorId> plan;
+    const SearchNode *node = goal_node;
+    int shard = goal_shard;
+    while (node->op != OperatorHandle::no_operator) {
+        plan.push_back(workers[shard]->space.get_operator(*node));
+        int parent_shard = workers[shard]->parent_shard[node->state_id.id()];
+        node = &workers[parent_shard]->space.get_node(node->parent_state_id);
+        shard = parent_shard;
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+template <class PackedStateT>
+utils::ExitCode HashDistributedSearch<PackedStateT>::search(const Task &task,
+                                                            SuccessorGenerator &generator,
+                                                            Heuristic &heuristic)
+{
+    unsigned num_workers = opt.get_threads();
+    cout << "Starting hash-distributed "
+         << (mode == Mode::ASTAR ? "A*" : "greedy best first search")
+         << " with " << num_workers << " threads" << endl;
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&start]() {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+
+    /*
+     * Heuristics and successor generators keep internal state, so every
+     * worker gets its own. The first worker reuses the heuristic and the
+     * generator of the caller. Generators are created single-threaded, and
+     * the one of the caller is too (see runs_worker_threads): the workers
+     * already use all threads. For the same reason the heuristic of the
+     * caller evaluates states one at a time.
+     */
+    for (unsigned i = 0; i < num_workers; ++i) {
+        auto worker = make_unique<Worker>();
+        worker->packer = make_unique<StatePackerT>(task);
+        if (i == 0) {
+            worker->generator = &generator;
+            heuristic.set_num_threads(1, task);
+            worker->heuristic = &heuristic;
+        }
+        else {
+            worker->owned_generator.reset(SuccessorGeneratorFactory::create(
+                opt.get_successor_generator(), opt.get_seed(), 1, task,
+                opt.get_incremental_successors()));
+            worker->generator = worker->owned_generator.get();
+            worker->owned_heuristic.reset(HeuristicFactory::create(opt, task));
+            worker->heuristic = worker->owned_heuristic.get();
+        }
+        workers.push_back(std::move(worker));
+    }
+
+    PackedStateT initial_state = workers[0]->packer->pack(task.initial_state);
+    int root_shard = get_shard(initial_state);
+    insert_state(task, root_shard, std::move(initial_state), LiftedOperatorId::no_operator,
+                 StateID::no_state, -1, 0);
+    if (workers[root_shard]->open_list.empty()) {
+        cerr << "Initial state is unsolvable!" << endl;
+        exit(1);
+    }
+
+    pending_work.store(num_workers);
+    vector<thread> threads;
+    threads.reserve(num_workers);
+    for (unsigned i = 0; i < num_workers; ++i) {
+        threads.emplace_back(&HashDistributedSearch::run_worker, this, cref(task), i);
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    for (const auto &worker : workers) {
+        statistics.inc_expanded(worker->statistics.get_expanded());
+        statistics.inc_evaluated_states(worker->statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker->statistics.get_evaluations());
+        statistics.inc_generated(worker->statistics.get_generated());
+        statistics.inc_reopened(worker->statistics.get_reopened());
+        statistics.inc_dead_ends(worker->statistics.get_dead_ends());
+        statistics.inc_pruned_states(worker->statistics.get_pruned_states());
+    }
+
+    if (!goal_node) {
+        cerr << "No solution found!" << endl;
+        cout << "Total time: " << elapsed() << endl;
+        return utils::ExitCode::SEARCH_UNSOLVABLE;
+    }
+
+    cout << "Goal found at: " << elapsed() << endl;
+    cout << "Total time: " << elapsed() << endl;
+    print_plan(extract_plan(), task);
+    return utils::ExitCode::SUCCESS;
+}
+
+template <class PackedStateT>
+void HashDistributedSearch<PackedStateT>::print_statistics() const
+{
+    statistics.print_detailed_statistics();
+    size_t registered = 0;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        cout << "Number of registered states in shard " << i << ": "
+             << workers[i]->space.size() << endl;
+        if (const utils::MappedArena *arena = workers[i]->space.get_arena())
+            arena->print_statistics();
+        registered += workers[i]->space.size();
+    }
+    cout << "Number of registered states: " << registered << endl;
+}
+
+// explicit template instantiations
+template class HashDistributedSearch<SparsePackedState>;
+template class HashDistributedSearch<ExtensionalPackedState>;
@@ -0,0 +1,109 @@
+#ifndef SEARCH_HASH_DISTRIBUTED_SEARCH_H
+#define SEARCH_HASH_DISTRIBUTED_SEARCH_H
+
+#include "search.h"
+#include "search_space.h"
+
+#include "../options.h"
+#include "../algorithms/mpsc_queue.h"
+#include "../open_lists/bucket_open_list.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Parallel best-first search with hash-distributed duplicate detection,
+ * in the style of HDA* (Kishimoto, Fukunaga and Botea, 2013).
+ *
+ * @details Each worker thread owns one shard of the search space, an open list,
+ * a successor generator and a heuristic. A state belongs to the shard given by
+ * its packed-state hash. Workers expand their own states and send every
+ * successor owned by another worker to that worker's lock-free inbox. The owner
+ * does the duplicate detection and evaluates the state.
+ *
+ * Nodes keep the state id of their parent inside the parent's shard. The shard
+ * of the parent is stored next to the node, so plans are reconstructed across
+ * shards.
+ *
+ * The search ends when a goal is expanded (greedy mode) or, in A* mode, when no
+ * node with f smaller than the best plan found remains. Termination is detected
+ * with a single counter holding the number of active workers plus the number
+ * of messages in flight.
+ */
+template <class PackedStateT>
+class HashDistributedSearch : public SearchBase {
+public:
+    enum class Mode { GBFS, ASTAR };
+
+    using StatePackerT = typename PackedStateT::StatePackerT;
+
+    HashDistributedSearch(Mode mode, const Options &opt);
+    ~HashDistributedSearch() override;
+
+    utils::ExitCode search(const Task &task, SuccessorGenerator &generator, Heuristic &heuristic) override;
+
+    void print_statistics() const override;
+
+    bool runs_worker_threads() const override {
+        return true;
+    }
+
+private:
+    struct StateMessage {
+        PackedStateT state;
+        LiftedOperatorId op;
+        StateID parent;
+        int parent_shard;
+        int g;
+    };
+
+    struct Worker {
+        SearchSpace<PackedStateT> space;
+        // Keys <h, g> or <f, h>, all non-negative as BucketOpenList expects
+        BucketOpenList<2> open_list;
+        mpsc_queue::MPSCQueue<StateMessage> inbox;
+        //! Shard of the parent of each node, indexed by state id
+        std::vector<int> parent_shard;
+        std::unique_ptr<StatePackerT> packer;
+        std::unique_ptr<SuccessorGenerator> owned_generator;
+        SuccessorGenerator *generator = nullptr;
+        std::unique_ptr<Heuristic> owned_heuristic;
+        Heuristic *heuristic = nullptr;
+        SearchStatistics statistics;
+    };
+
+    const Mode mode;
+    const Options &opt;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    //! Number of active workers plus the number of messages not yet processed
+    std::atomic<long> pending_work;
+    std::atomic<bool> stop;
+    std::atomic<int> best_heuristic_value;
+    //! Cost of the best plan found so far (A* mode)
+    std::atomic<int> incumbent_cost;
+
+    std::mutex goal_mutex;
+    const SearchNode *goal_node;
+    int goal_shard;
+
+    std::mutex output_mutex;
+
+    int get_shard(const PackedStateT &state) const;
+
+    std::array<int, 2> get_key(int g, int h) const;
+
+    void insert_state(const Task &task, int shard, PackedStateT &&state, const LiftedOperatorId &op,
+                      StateID parent, int parent_shard, int g);
+
+    void expand(const Task &task, int shard, StateID sid);
+
+    void run_worker(const Task &task, int shard);
+
+    std::vector<LiftedOperatorId> extract_plan() const;
+};
+
+#endif //SEARCH_HASH_DISTRIBUTED_SEARCH_H
@@ -7,10 +7,11 @@
 #include "../task.h"
 
 #include "../heuristics/heuristic.h"
-#include "../open_lists/greedy_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 #include "../states/extensional_states.h"
 #include "../states/sparse_states.h"
 
+#include "../successor_generators/applicable_action_iterator.h"
 #include "../successor_generators/successor_generator.h"
 
 #include <algorithm>
@@ -30,9 +31,11 @@ utils::ExitCode LazySearch<PackedStateT>::search(const Task &task,
     clock_t timer_start = clock();
     const auto action_schemas = task.get_action_schemas();
     StatePackerT packer(task);
+    heuristic.set_num_threads(num_threads, task);
 
-    GreedyOpenList preferred_open_list;
-    GreedyOpenList regular_open_list;
+    // Keys <h, g>, both non-negative as BucketOpenList expects
+    BucketOpenList<2> preferred_open_list;
+    BucketOpenList<2> regular_open_list;
 
     //cout << "@ Initial state: \n\t";
     //task.dump_state(task.initial_state);
@@ -47,76 +50,136 @@ utils::ExitCode LazySearch<PackedStateT>::search(const Task &task,
     statistics.inc_evaluations();
     cout << "Initial heuristic value " << heuristic_layer << endl;
     statistics.report_f_value_progress(heuristic_layer);
-    regular_open_list.do_insertion(root_node.state_id, make_pair(heuristic_layer, 0));
+    regular_open_list.do_insertion(root_node.state_id, {heuristic_layer, 0});
 
     if (check_goal(task, generator, timer_start, task.initial_state, root_node, space)) return utils::ExitCode::SUCCESS;
 
+    /*
+     * States are evaluated when they are expanded. If the heuristic can
+     * evaluate several states at the same time, we take that many open states
+     * from the open lists and evaluate them together before expanding them in
+     * the order they were removed.
+     */
+    const size_t batch_size = heuristic.get_batch_size();
+    vector<StateID> batch_ids;
+    vector<DBState> batch_states;
+    vector<int> h_values;
+
     while ((not regular_open_list.empty()) or (not preferred_open_list.empty())) {
-        StateID sid = get_top_node(preferred_open_list, regular_open_list); //regular_open_list.remove_min();
-        SearchNode &node = space.get_node(sid);
-        DBState state = packer.unpack(space.get_state(sid));
-        if (node.status == SearchNode::Status::CLOSED) {
-            continue;
-        }
-        node.close();
-        int h = heuristic.compute_heuristic(state, task);
-        statistics.inc_evaluations();
-        statistics.inc_evaluated_states();
-        if (h == UNSOLVABLE_STATE) {
-            statistics.inc_dead_ends();
-            statistics.inc_pruned_states();
-            node.mark_as_unsolvable();
-            continue;
-        }
-        int g = node.g;
-        node.update_h(h);
-        statistics.report_f_value_progress(h); // In GBFS f = h.
-        statistics.inc_expanded();
-
-        if (h < heuristic_layer) {
-            heuristic_layer = h;
-            boost_priority_preferred();
-            cout << "New heuristic value expanded: h=" << h
-                 << " [expansions: " << statistics.get_expanded()
-                 << ", evaluations: " << statistics.get_evaluations()
-                 << ", generations: " << statistics.get_generated()
-                 << ", time: " << double(clock() - timer_start) / CLOCKS_PER_SEC << "]" << '\n';
+        batch_ids.clear();
+        batch_states.clear();
+        while (batch_ids.size() < batch_size
+               and ((not regular_open_list.empty()) or (not preferred_open_list.empty()))) {
+            StateID sid = get_top_node(preferred_open_list, regular_open_list); //regular_open_list.remove_min();
+            SearchNode &node = space.get_node(sid);
+            if (node.status == SearchNode::Status::CLOSED) {
+                continue;
+            }
+            node.close();
+            batch_ids.push_back(sid);
+            batch_states.push_back(packer.unpack(space.get_state(sid)));
         }
-        assert(sid.id() >= 0 && (unsigned) sid.id() < space.size());
-
-        if (check_goal(task, generator, timer_start, state, node, space)) return utils::ExitCode::SUCCESS;
-
-        const auto applicable = generator.get_applicable_actions(action_schemas, state);
-        statistics.inc_generated(applicable.size());
-
-        for (const LiftedOperatorId& op_id:applicable) {
-            const auto &action = action_schemas[op_id.get_index()];
-            DBState s = generator.generate_successor(op_id, action, state);
-            int dist = g + action.get_cost();
-            auto &child_node =
-                space.insert_or_get_previous_node(packer.pack(s), op_id, node.state_id);
-            bool is_preferred = is_useful_operator(task, s, heuristic.get_useful_atoms());
-            if (child_node.status==SearchNode::Status::NEW) {
-                // Inserted for the first time in the map
-                child_node.open(dist, h);
-                if (check_goal(task, generator, timer_start, state, node, space))
-                    return utils::ExitCode::SUCCESS;
-
-                if (all_operators_preferred or is_preferred) {
-                    preferred_open_list.do_insertion(child_node.state_id, make_pair(h, dist));
-                } else if (not is_preferred and not prune_relaxed_useless_operators) {
-                    regular_open_list.do_insertion(child_node.state_id, make_pair(h, dist));
-                }
-            } else {
-                if (dist < child_node.g) {
-                    child_node.open(dist, h); // Reopening
-                    statistics.inc_reopened();
+        heuristic.compute_heuristic_batch(batch_states, task, h_values);
+
+        for (size_t i = 0; i < batch_ids.size(); ++i) {
+            StateID sid = batch_ids[i];
+            SearchNode &node = space.get_node(sid);
+            if (node.status != SearchNode::Status::CLOSED) {
+                // Reopened by an earlier state of the batch: expanded from the open lists with its better g
+                continue;
+            }
+            const DBState &state = batch_states[i];
+            int h = h_values[i];
+            statistics.inc_evaluations();
+            statistics.inc_evaluated_states();
+            if (h == UNSOLVABLE_STATE) {
+                statistics.inc_dead_ends();
+                statistics.inc_pruned_states();
+                node.mark_as_unsolvable();
+                continue;
+            }
+            int g = node.g;
+            node.update_h(h);
+            statistics.report_f_value_progress(h); // In GBFS f = h.
+            statistics.inc_expanded();
+
+            if (h < heuristic_layer) {
+                heuristic_layer = h;
+                boost_priority_preferred();
+                cout << "New heuristic value expanded: h=" << h
+                     << " [expansions: " << statistics.get_expanded()
+                     << ", evaluations: " << statistics.get_evaluations()
+                     << ", generations: " << statistics.get_generated()
+                     << ", time: " << double(clock() - timer_start) / CLOCKS_PER_SEC << "]" << '\n';
+            }
+            assert(sid.id() >= 0 && (unsigned) sid.id() < space.size());
+
+            if (check_goal(task, generator, timer_start, state, node, space)) return utils::ExitCode::SUCCESS;
+
+            /*
+             * The applicable actions are instantiated as the children are
+             * generated, so the expansion can stop at a goal, at a child
+             * reached by a useful operator or once the budget is spent if
+             * requested. The state is then reopened: when it is expanded
+             * again, the children generated so far are duplicates and the
+             * expansion goes on with the other ones.
+             */
+            ApplicableActionIterator applicable(generator, action_schemas, state);
+            const auto &useful_atoms = heuristic.get_batch_useful_atoms(i);
+            unsigned opened_children = 0;
+            bool stopped = false;
+
+            while (const LiftedOperatorId *op = applicable.next()) {
+                const LiftedOperatorId &op_id = *op;
+                statistics.inc_generated();
+                const auto &action = action_schemas[op_id.get_index()];
+                DBState s = generator.generate_successor(op_id, action, state);
+                int dist = g + action.get_cost();
+                auto &child_node =
+                    space.insert_or_get_previous_node(packer.pack(s), op_id, sid);
+                bool is_preferred = is_useful_operator(task, s, useful_atoms);
+                if (child_node.status==SearchNode::Status::NEW) {
+                    // Inserted for the first time in the map
+                    child_node.open(dist, h);
+                    if (check_goal(task, generator, timer_start, state, node, space))
+                        return utils::ExitCode::SUCCESS;
+                    if (stop_expansion_early and check_goal(task, generator, timer_start, s, child_node, space))
+                        return utils::ExitCode::SUCCESS;
+
                     if (all_operators_preferred or is_preferred) {
-                        preferred_open_list.do_insertion(child_node.state_id, make_pair(h, dist));
+                        preferred_open_list.do_insertion(child_node.state_id, {h, dist});
                     } else if (not is_preferred and not prune_relaxed_useless_operators) {
-                        regular_open_list.do_insertion(child_node.state_id, make_pair(h, dist));
+                        regular_open_list.do_insertion(child_node.state_id, {h, dist});
+                    }
+                } else {
+                    if (dist < child_node.g) {
+                        child_node.open(dist, h); // Reopening
+                        statistics.inc_reopened();
+                        if (all_operators_preferred or is_preferred) {
+                            preferred_open_list.do_insertion(child_node.state_id, {h, dist});
+                        } else if (not is_preferred and not prune_relaxed_useless_operators) {
+                            regular_open_list.do_insertion(child_node.state_id, {h, dist});
+                        }
+                    }
+                    else {
+                        continue;
                     }
                 }
+
+                ++opened_children;
+                if ((stop_expansion_early and is_preferred)
+                    or (expansion_budget > 0 and opened_children >= expansion_budget)) {
+                    // Nothing is left to expand if this was the last applicable action
+                    stopped = not applicable.done();
+                    break;
+                }
+            }
+
+            if (stopped) {
+                // The state is evaluated again when it is expanded again
+                ++stopped_expansions;
+                node.open(g, h);
+                regular_open_list.do_insertion(sid, {h, g});
             }
         }
     }
@@ -129,6 +192,8 @@ utils::ExitCode LazySearch<PackedStateT>::search(const Task &task,
 template <class PackedStateT>
 void LazySearch<PackedStateT>::print_statistics() const {
     statistics.print_detailed_statistics();
+    if (stop_expansion_early or expansion_budget > 0)
+        cout << "Expansions stopped early: " << stopped_expansions << endl;
     space.print_statistics();
 }
 
@@ -4,7 +4,8 @@
 
 #include "search.h"
 #include "search_space.h"
-#include "../open_lists/greedy_open_list.h"
+#include "../open_lists/bucket_open_list.h"
+#include "../options.h"
 
 template <class PackedStateT>
 class LazySearch : public SearchBase {
@@ -22,10 +23,19 @@ protected:
     int heuristic_layer{};
     bool all_operators_preferred;
     bool prune_relaxed_useless_operators;
+    bool stop_expansion_early;
+    unsigned expansion_budget;
+    int stopped_expansions;
+    // Threads evaluating the batches of states taken from the open lists
+    unsigned num_threads;
 public:
-    explicit LazySearch(bool dual_queue, bool prune) :
+    LazySearch(bool dual_queue, bool prune, const Options &opt) :
         all_operators_preferred(dual_queue),
-        prune_relaxed_useless_operators(prune)
+        prune_relaxed_useless_operators(prune),
+        stop_expansion_early(opt.get_stop_expansion_early()),
+        expansion_budget(opt.get_expansion_budget()),
+        stopped_expansions(0),
+        num_threads(opt.get_threads())
     {
         priority_preferred = 0;
         priority_regular = 0;
@@ -37,7 +47,7 @@ public:
 
     void print_statistics() const override;
 
-    StateID get_top_node(GreedyOpenList &preferred, GreedyOpenList &other) {
+    StateID get_top_node(BucketOpenList<2> &preferred, BucketOpenList<2> &other) {
         if (priority_preferred >= priority_regular) {
             priority_preferred = std::max(priority_preferred-1, 0);
             if (not preferred.empty()) {
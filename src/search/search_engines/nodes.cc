@@ -5,6 +5,8 @@ using namespace std;
 
 const StateID StateID::no_state = StateID(-1);
 
+const OperatorHandle OperatorHandle::no_operator = OperatorHandle(-1);
+
 ostream &operator<<(ostream &os, StateID id) {
     os << "#" << id.value;
     return os;
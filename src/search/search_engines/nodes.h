@@ -32,17 +32,39 @@ public:
 };
 
 
+/*
+  Operator that generated a node, interned by the OperatorRegistry of its
+  search space.
+*/
+class OperatorHandle {
+    friend class OperatorRegistry;
+
+    int value;
+    explicit OperatorHandle(int value) : value(value) {}
+
+public:
+    OperatorHandle() = delete;
+
+    int id() const { return value; }
+
+    static const OperatorHandle no_operator;
+
+    bool operator==(const OperatorHandle &other) const { return value == other.value; }
+    bool operator!=(const OperatorHandle &other) const { return !(*this == other); }
+};
+
+
 class SearchNode {
 public:
     enum Status { NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3 };
 
     explicit SearchNode(StateID state_id) :
-        SearchNode(state_id, LiftedOperatorId::no_operator, StateID::no_state, 0)
+        SearchNode(state_id, OperatorHandle::no_operator, StateID::no_state, 0)
     {}
 
-    SearchNode(StateID state_id, LiftedOperatorId op, StateID parent_state_id, int f)
+    SearchNode(StateID state_id, OperatorHandle op, StateID parent_state_id, int f)
         : state_id(state_id),
-          op(std::move(op)),
+          op(op),
           parent_state_id(parent_state_id),
           status(Status::NEW),
           f(f),
@@ -82,7 +104,7 @@ public:
     }
 
     StateID state_id;
-    LiftedOperatorId op;
+    OperatorHandle op;
     StateID parent_state_id;
     unsigned int status : 2;
     int f : 30;
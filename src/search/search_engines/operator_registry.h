@@ -0,0 +1,125 @@
+#ifndef SEARCH_OPERATOR_REGISTRY_H
+#define SEARCH_OPERATOR_REGISTRY_H
+
+#include "nodes.h"
+
+#include "../action.h"
+
+#include "../algorithms/int_hash_set.h"
+#include "../utils/hash.h"
+#include "../utils/mapped_arena.h"
+#include "../utils/segmented_vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Interned operators of the nodes of a search space.
+ *
+ * @details Each distinct operator is stored once, as its schema index, its
+ * number of parameters and its instantiation, one after the other in a
+ * segmented vector of integers, and is identified by an OperatorHandle. Search
+ * nodes keep the handle of the operator that generated them instead of a
+ * LiftedOperatorId, which owns a heap-allocated instantiation, and the
+ * operators are rebuilt only when a plan is extracted.
+ *
+ * Like the states of a search space, the operators are allocated from its
+ * MappedArena if there is a memory budget, and the index used to find
+ * duplicates stays in memory.
+ */
+class OperatorRegistry {
+    using DataT = segmented_vector::SegmentedVector<int, utils::ArenaAllocator<int>>;
+    using OffsetsT = segmented_vector::SegmentedVector<std::size_t, utils::ArenaAllocator<std::size_t>>;
+
+    struct OperatorHash {
+        const DataT &data;
+        const OffsetsT &offsets;
+
+        OperatorHash(const DataT &data, const OffsetsT &offsets) : data(data), offsets(offsets) {}
+
+        std::size_t operator()(int id) const {
+            std::size_t begin = offsets[id];
+            std::size_t end = begin + 2 + data[begin + 1];
+            utils::HashState hash_state;
+            for (std::size_t i = begin; i < end; ++i)
+                utils::feed(hash_state, data[i]);
+            return hash_state.get_hash32();
+        }
+    };
+
+    struct OperatorEqual {
+        const DataT &data;
+        const OffsetsT &offsets;
+
+        OperatorEqual(const DataT &data, const OffsetsT &offsets) : data(data), offsets(offsets) {}
+
+        bool operator()(int lhs, int rhs) const {
+            std::size_t lhs_begin = offsets[lhs];
+            std::size_t rhs_begin = offsets[rhs];
+            if (data[lhs_begin + 1] != data[rhs_begin + 1])
+                return false;
+            std::size_t length = 2 + data[lhs_begin + 1];
+            for (std::size_t i = 0; i < length; ++i) {
+                if (data[lhs_begin + i] != data[rhs_begin + i])
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    DataT data;
+    OffsetsT offsets;
+    int_hash_set::IntHashSet<OperatorHash, OperatorEqual> registered_operators;
+
+public:
+    explicit OperatorRegistry(utils::MappedArena *arena)
+        : data(utils::ArenaAllocator<int>(arena)),
+          offsets(utils::ArenaAllocator<std::size_t>(arena)),
+          registered_operators(OperatorHash(data, offsets), OperatorEqual(data, offsets))
+    {}
+
+    //! Return the handle of the operator, storing it if it is new
+    OperatorHandle insert(const LiftedOperatorId &op) {
+        if (op.get_index() == LiftedOperatorId::no_operator.get_index())
+            return OperatorHandle::no_operator;
+        const std::vector<int> &instantiation = op.get_instantiation();
+        int id = offsets.size();
+        offsets.push_back(data.size());
+        data.push_back(op.get_index());
+        data.push_back(instantiation.size());
+        for (int object : instantiation)
+            data.push_back(object);
+
+        auto result = registered_operators.insert(id);
+        if (!result.second) {
+            // The operator was already registered
+            for (std::size_t i = 0; i < 2 + instantiation.size(); ++i)
+                data.pop_back();
+            offsets.pop_back();
+            id = result.first;
+        }
+        return OperatorHandle(id);
+    }
+
+    LiftedOperatorId get(OperatorHandle handle) const {
+        if (handle == OperatorHandle::no_operator)
+            return LiftedOperatorId::no_operator;
+        assert(handle.id() >= 0 && (std::size_t) handle.id() < offsets.size());
+        std::size_t begin = offsets[handle.id()];
+        int num_parameters = data[begin + 1];
+        std::vector<int> instantiation;
+        instantiation.reserve(num_parameters);
+        for (int i = 0; i < num_parameters; ++i)
+            instantiation.push_back(data[begin + 2 + i]);
+        return LiftedOperatorId(data[begin], std::move(instantiation));
+    }
+
+    //! Return the number of distinct operators
+    std::size_t size() const {
+        return offsets.size();
+    }
+};
+
+#endif //SEARCH_OPERATOR_REGISTRY_H
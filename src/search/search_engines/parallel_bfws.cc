@@ -0,0 +1,272 @@
+#include "parallel_bfws.h"
+#include "search.h"
+#include "utils.h"
+
+#include "../open_lists/bucket_open_list.h"
+
+#include "../heuristics/ff_heuristic.h"
+#include "../novelty/node_novelty.h"
+#include "../novelty/standard_novelty.h"
+
+#include "../states/extensional_states.h"
+#include "../states/sparse_states.h"
+
+#include "../parallel_hashmap/phmap.h"
+#include "../successor_generators/successor_generator.h"
+#include "../successor_generators/successor_generator_factory.h"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+template<class PackedStateT>
+ParallelBFWS<PackedStateT>::ParallelBFWS(int width, const Options &opt, int method)
+    : width(width),
+      method(method),
+      only_effects_opt(opt.get_only_effects_opt()),
+      dense_novelty_tables(opt.get_dense_novelty_tables()),
+      opt(opt)
+{
+    assert(method == StandardNovelty::R_0 || method == StandardNovelty::R_X);
+    if (method == StandardNovelty::R_X) {
+        std::cout << "Using version with R-X" << std::endl;
+    }
+}
+
+template<class PackedStateT>
+template<class F>
+void ParallelBFWS<PackedStateT>::run_in_parallel(size_t n, const F &f)
+{
+    /*
+     * There is one job per worker, and the jobs take the next index from a
+     * shared counter, so the work is balanced even if some indices take much
+     * longer than others, and no two threads use the same worker at once.
+     */
+    atomic<size_t> next_index(0);
+    pool->run(workers.size(), [&](size_t w) {
+        for (size_t i = next_index++; i < n; i = next_index++) {
+            f(*workers[w], i);
+        }
+    });
+}
+
+template<class PackedStateT>
+void ParallelBFWS<PackedStateT>::generate_successors(const Task &task,
+                                                     const StatePackerT &packer,
+                                                     Worker &worker,
+                                                     Expansion &expansion)
+{
+    const auto &action_schemas = task.get_action_schemas();
+    DBState state = packer.unpack(space.get_state(expansion.id));
+    const auto applicable = worker.generator->get_applicable_actions(action_schemas, state);
+    expansion.successors.reserve(applicable.size());
+    for (const LiftedOperatorId &op_id : applicable) {
+        const auto &action = action_schemas[op_id.get_index()];
+        DBState s = worker.generator->generate_successor(op_id, action, state);
+        PackedStateT packed = packer.pack(s);
+        expansion.successors.emplace_back(std::move(packed), std::move(s), op_id, expansion.g + action.get_cost());
+        if (only_effects_opt)
+            expansion.successors.back().added_atoms = worker.generator->get_added_atoms();
+    }
+}
+
+template<class PackedStateT>
+void ParallelBFWS<PackedStateT>::evaluate(const Task &task,
+                                          Worker &worker,
+                                          const Expansion &parent,
+                                          Successor &successor)
+{
+    successor.unsatisfied_goals = worker.gc.compute_heuristic(successor.state, task);
+    if (method == StandardNovelty::R_X)
+        successor.unsatisfied_relevant_atoms = atom_counter.count_unachieved_atoms(successor.state, task);
+
+    if (only_effects_opt and (successor.unsatisfied_goals == parent.unsatisfied_goals)
+        and (successor.unsatisfied_relevant_atoms == parent.unsatisfied_relevant_atoms)) {
+        successor.novelty = novelty->compute_novelty_from_operator(successor.state,
+                                                                   successor.unsatisfied_goals,
+                                                                   successor.unsatisfied_relevant_atoms,
+                                                                   successor.added_atoms,
+                                                                   worker.atom_ids);
+    }
+    else {
+        successor.novelty = novelty->compute_novelty(successor.state,
+                                                     successor.unsatisfied_goals,
+                                                     successor.unsatisfied_relevant_atoms,
+                                                     worker.atom_ids);
+    }
+}
+
+template <class PackedStateT>
+utils::ExitCode ParallelBFWS<PackedStateT>::search(const Task &task,
+                                                   SuccessorGenerator &generator,
+                                                   Heuristic &)
+{
+    unsigned num_threads = opt.get_threads();
+    cout << "Starting parallel BFWS with " << num_threads << " threads" << endl;
+    clock_t timer_start = clock();
+    StatePackerT packer(task);
+
+    size_t number_goal_conditions = task.get_goal().goal.size() + task.get_goal().positive_nullary_goals.size() + task.get_goal().negative_nullary_goals.size();
+    size_t number_relevant_atoms = 0;
+    if (method == StandardNovelty::R_X) {
+        atom_counter = initialize_counter_with_useful_atoms(task);
+        number_relevant_atoms = atom_counter.get_total_number_of_atoms();
+    }
+
+    novelty = make_unique<ConcurrentNovelty>(task, number_goal_conditions, number_relevant_atoms, width,
+                                             dense_novelty_tables);
+
+    /*
+     * Successor generators keep internal state, so every worker gets its own.
+     * They are created single-threaded, as the workers already use all
+     * threads. The first worker uses the generator of the caller, which is
+     * single-threaded for the same reason (see runs_worker_threads).
+     */
+    pool = make_unique<utils::WorkerPool>(num_threads);
+    for (unsigned i = 0; i < num_threads; ++i) {
+        auto worker = make_unique<Worker>();
+        if (i == 0) {
+            worker->generator = &generator;
+        }
+        else {
+            worker->owned_generator.reset(SuccessorGeneratorFactory::create(
+                opt.get_successor_generator(), opt.get_seed(), 1, task,
+                opt.get_incremental_successors()));
+            worker->generator = worker->owned_generator.get();
+        }
+        workers.push_back(std::move(worker));
+    }
+    const SuccessorGenerator &goal_generator = *workers[0]->generator;
+
+    // Keys <novelty, #g, g>, all non-negative as BucketOpenList expects
+    BucketOpenList<3> queue;
+    phmap::flat_hash_map<int, NodeNovelty> map_state_to_evaluators;
+
+    SearchNode &root_node = space.insert_or_get_previous_node(packer.pack(task.initial_state),
+                                                              LiftedOperatorId::no_operator, StateID::no_state);
+    int gc_h0 = workers[0]->gc.compute_heuristic(task.initial_state, task);
+    int unachieved_atoms_s0 = 0;
+    if (method == StandardNovelty::R_X)
+        unachieved_atoms_s0 = atom_counter.count_unachieved_atoms(task.initial_state, task);
+    int novelty_value = novelty->compute_novelty(task.initial_state, gc_h0, unachieved_atoms_s0,
+                                                 workers[0]->atom_ids);
+    root_node.open(0, novelty_value);
+    statistics.inc_evaluations();
+    cout << "Initial heuristic value 0" << endl;
+    statistics.report_f_value_progress(0);
+    queue.do_insertion(root_node.state_id, {novelty_value, gc_h0, 0});
+    map_state_to_evaluators.insert({root_node.state_id.id(), NodeNovelty(gc_h0, unachieved_atoms_s0)});
+
+    if (check_goal(task, goal_generator, timer_start, task.initial_state, root_node, space))
+        return utils::ExitCode::SUCCESS;
+
+    // A single thread expands one node at a time, as BreadthFirstWidthSearch
+    const size_t batch_size = (num_threads == 1) ? 1 : NODES_PER_THREAD * num_threads;
+    vector<Expansion> batch;
+    vector<pair<size_t, size_t>> new_successors;
+    while (not queue.empty()) {
+        batch.clear();
+        while (not queue.empty() and batch.size() < batch_size) {
+            StateID sid = queue.remove_min();
+            SearchNode &node = space.get_node(sid);
+            if (node.status == SearchNode::Status::CLOSED)
+                continue;
+            node.close();
+            statistics.report_f_value_progress(node.g);
+            statistics.inc_expanded();
+            const NodeNovelty &evaluators = map_state_to_evaluators.at(sid.id());
+            batch.emplace_back(sid, node.g, evaluators.unsatisfied_goals, evaluators.unsatisfied_relevant_atoms);
+        }
+
+        run_in_parallel(batch.size(), [&](Worker &worker, size_t i) {
+            generate_successors(task, packer, worker, batch[i]);
+        });
+
+        new_successors.clear();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            for (size_t j = 0; j < batch[i].successors.size(); ++j) {
+                Successor &successor = batch[i].successors[j];
+                statistics.inc_generated();
+                SearchNode &child_node = space.insert_or_get_previous_node(
+                    std::move(successor.packed), successor.op, batch[i].id);
+                if (child_node.status != SearchNode::Status::NEW)
+                    continue;
+                /*
+                 * Open the node before it is evaluated, so a state generated
+                 * again in the same batch is evaluated and inserted only once,
+                 * from the parent recorded in its node. The novelty is set
+                 * after the evaluation.
+                 */
+                child_node.open(successor.g, 0);
+                successor.id = child_node.state_id;
+                new_successors.emplace_back(i, j);
+            }
+        }
+
+        run_in_parallel(new_successors.size(), [&](Worker &worker, size_t k) {
+            const Expansion &parent = batch[new_successors[k].first];
+            evaluate(task, worker, parent, batch[new_successors[k].first].successors[new_successors[k].second]);
+        });
+
+        for (const auto &entry : new_successors) {
+            const Successor &successor = batch[entry.first].successors[entry.second];
+            statistics.inc_evaluations();
+            statistics.inc_evaluated_states();
+            SearchNode &child_node = space.get_node(successor.id);
+            child_node.open(successor.g, successor.novelty);
+            if (check_goal(task, goal_generator, timer_start, successor.state, child_node, space))
+                return utils::ExitCode::SUCCESS;
+            queue.do_insertion(successor.id, {successor.novelty, successor.unsatisfied_goals, successor.g});
+            map_state_to_evaluators.insert({successor.id.id(),
+                                            NodeNovelty(successor.unsatisfied_goals,
+                                                        successor.unsatisfied_relevant_atoms)});
+        }
+    }
+
+    print_no_solution_found(timer_start);
+    return utils::ExitCode::SEARCH_UNSOLVABLE;
+}
+
+template <class PackedStateT>
+void ParallelBFWS<PackedStateT>::print_statistics() const
+{
+    statistics.print_detailed_statistics();
+    space.print_statistics();
+}
+
+template<class PackedStateT>
+AtomCounter ParallelBFWS<PackedStateT>::initialize_counter_with_useful_atoms(const Task &task) const
+{
+    std::vector<std::vector<GroundAtom>> atoms(task.initial_state.get_relations().size(), std::vector<GroundAtom>());
+    std::unordered_set<int> positive = task.get_goal().positive_nullary_goals;
+    std::unordered_set<int> negative = task.get_goal().negative_nullary_goals;
+
+    FFHeuristic delete_free_h(task);
+
+    int h = delete_free_h.compute_heuristic(task.initial_state, task);
+    std::cout << "Initial h-add value of the task: " << h << std::endl;
+
+    std::vector<bool> useful_nullary = delete_free_h.get_useful_nullary_atoms();
+    for (size_t i = 0; i < useful_nullary.size(); ++i) {
+        if (useful_nullary[i]) {
+            positive.insert(i);
+        }
+    }
+
+    const std::vector<std::vector<GroundAtom>> &useful_atoms = delete_free_h.get_useful_atoms();
+    for (size_t pred_idx = 0; pred_idx < useful_atoms.size(); ++pred_idx) {
+        if (task.predicates[pred_idx].isStaticPredicate())
+            continue;
+        for (const GroundAtom &atom : useful_atoms[pred_idx]) {
+            atoms[pred_idx].push_back(atom);
+        }
+    }
+
+    return AtomCounter(task.get_atom_table(), atoms, positive, negative);
+}
+
+// explicit template instantiations
+template class ParallelBFWS<SparsePackedState>;
+template class ParallelBFWS<ExtensionalPackedState>;
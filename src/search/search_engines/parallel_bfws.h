@@ -0,0 +1,117 @@
+#ifndef SEARCH_SEARCH_ENGINES_PARALLEL_BFWS_H_
+#define SEARCH_SEARCH_ENGINES_PARALLEL_BFWS_H_
+
+#include "search.h"
+#include "search_space.h"
+
+#include "../action.h"
+#include "../options.h"
+
+#include "../heuristics/goalcount.h"
+#include "../novelty/atom_counter.h"
+#include "../novelty/concurrent_novelty.h"
+#include "../utils/worker_pool.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Multi-threaded version of BreadthFirstWidthSearch with R_0 or R_X.
+ *
+ * @details The search takes a batch of nodes from the open list and works on
+ * it in four steps:
+ *  1. The workers generate the successors of the nodes in parallel.
+ *  2. The successors are inserted in the search space, in the order in which
+ *     the serial search would generate them, to discard the duplicates.
+ *  3. The workers evaluate the new successors in parallel, against novelty
+ *     tables shared by all of them (see ConcurrentNovelty).
+ *  4. The successors are added to the open list, in the same order as in 2.
+ *
+ * The open list and the search space are only used by the main thread. The
+ * novelty of a state depends on the states evaluated before it, so the search
+ * is not deterministic with more than one thread: states of the same batch
+ * compete for the same new atoms.
+ */
+template <class PackedStateT>
+class ParallelBFWS : public SearchBase {
+public:
+    using StatePackerT = typename PackedStateT::StatePackerT;
+
+    ParallelBFWS(int width, const Options &opt, int method);
+
+    utils::ExitCode search(const Task &task, SuccessorGenerator &generator, Heuristic &heuristic) override;
+
+    void print_statistics() const override;
+
+    bool runs_worker_threads() const override {
+        return true;
+    }
+
+private:
+    struct Worker {
+        std::unique_ptr<SuccessorGenerator> owned_generator;
+        SuccessorGenerator *generator = nullptr;
+        Goalcount gc;
+        ConcurrentNovelty::AtomIds atom_ids;
+    };
+
+    struct Successor {
+        PackedStateT packed;
+        DBState state;
+        LiftedOperatorId op;
+        int g;
+        // Atoms added by the operator, only kept for the only-effects optimization
+        std::vector<std::pair<int, GroundAtom>> added_atoms;
+
+        StateID id = StateID::no_state;
+        int unsatisfied_goals = 0;
+        int unsatisfied_relevant_atoms = 0;
+        int novelty = 0;
+
+        Successor(PackedStateT &&packed, DBState &&state, const LiftedOperatorId &op, int g)
+            : packed(std::move(packed)), state(std::move(state)), op(op), g(g) {}
+    };
+
+    struct Expansion {
+        StateID id;
+        int g;
+        int unsatisfied_goals;
+        int unsatisfied_relevant_atoms;
+        std::vector<Successor> successors;
+
+        Expansion(StateID id, int g, int unsatisfied_goals, int unsatisfied_relevant_atoms)
+            : id(id), g(g), unsatisfied_goals(unsatisfied_goals),
+              unsatisfied_relevant_atoms(unsatisfied_relevant_atoms) {}
+    };
+
+    // Number of nodes expanded in one batch per thread
+    static const std::size_t NODES_PER_THREAD = 2;
+
+    int width;
+    int method;
+    bool only_effects_opt;
+    bool dense_novelty_tables;
+    const Options &opt;
+
+    AtomCounter atom_counter;
+    std::unique_ptr<ConcurrentNovelty> novelty;
+    std::unique_ptr<utils::WorkerPool> pool;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    SearchSpace<PackedStateT> space;
+
+    AtomCounter initialize_counter_with_useful_atoms(const Task &task) const;
+
+    // Call f(worker, i) for every i < n, spreading the calls over the workers
+    template<class F>
+    void run_in_parallel(std::size_t n, const F &f);
+
+    void generate_successors(const Task &task, const StatePackerT &packer, Worker &worker,
+                             Expansion &expansion);
+
+    void evaluate(const Task &task, Worker &worker, const Expansion &parent, Successor &successor);
+};
+
+#endif //SEARCH_SEARCH_ENGINES_PARALLEL_BFWS_H_
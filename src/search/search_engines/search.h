@@ -29,6 +29,14 @@ public:
 
     virtual void print_statistics() const = 0;
 
+    /*
+     * Engines running their own worker threads get a single-threaded
+     * successor generator, which their first worker uses.
+     */
+    virtual bool runs_worker_threads() const {
+        return false;
+    }
+
     template <class PackedStateT>
     bool check_goal(const Task &task,
                     const SuccessorGenerator &generator,
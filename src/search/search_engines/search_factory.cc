@@ -7,7 +7,9 @@
 #include "breadth_first_width_search.h"
 #include "dual_queue_bfws.h"
 #include "greedy_best_first_search.h"
+#include "hash_distributed_search.h"
 #include "lazy_search.h"
+#include "parallel_bfws.h"
 #include "search.h"
 
 #include "../states/extensional_states.h"
@@ -44,6 +46,22 @@ SearchFactory::create(const Options &opt, const std::string& method, const std::
         if (using_ext_state) return new BreadthFirstWidthSearch<ExtensionalPackedState>(2, opt, StandardNovelty::R_X);
         else return new BreadthFirstWidthSearch<SparsePackedState>(2, opt, StandardNovelty::R_X);
     }
+    else if (boost::iequals(method, "par-bfws1")) {
+        if (using_ext_state) return new ParallelBFWS<ExtensionalPackedState>(1, opt, StandardNovelty::R_0);
+        else return new ParallelBFWS<SparsePackedState>(1, opt, StandardNovelty::R_0);
+    }
+    else if (boost::iequals(method, "par-bfws2")) {
+        if (using_ext_state) return new ParallelBFWS<ExtensionalPackedState>(2, opt, StandardNovelty::R_0);
+        else return new ParallelBFWS<SparsePackedState>(2, opt, StandardNovelty::R_0);
+    }
+    else if (boost::iequals(method, "par-bfws1-rx")) {
+        if (using_ext_state) return new ParallelBFWS<ExtensionalPackedState>(1, opt, StandardNovelty::R_X);
+        else return new ParallelBFWS<SparsePackedState>(1, opt, StandardNovelty::R_X);
+    }
+    else if (boost::iequals(method, "par-bfws2-rx")) {
+        if (using_ext_state) return new ParallelBFWS<ExtensionalPackedState>(2, opt, StandardNovelty::R_X);
+        else return new ParallelBFWS<SparsePackedState>(2, opt, StandardNovelty::R_X);
+    }
     else if (boost::iequals(method, "iw1")) {
         if (using_ext_state) return new BreadthFirstWidthSearch<ExtensionalPackedState>(1, opt, StandardNovelty::IW);
         else return new BreadthFirstWidthSearch<SparsePackedState>(1, opt, StandardNovelty::IW);
@@ -77,20 +95,28 @@ SearchFactory::create(const Options &opt, const std::string& method, const std::
         else return new AlternatedBFWS<SparsePackedState>(2, opt);
     }
     else if (boost::iequals(method, "gbfs")) {
-        if (using_ext_state) return new GreedyBestFirstSearch<ExtensionalPackedState>();
-        else return new GreedyBestFirstSearch<SparsePackedState>();
+        if (using_ext_state) return new GreedyBestFirstSearch<ExtensionalPackedState>(opt);
+        else return new GreedyBestFirstSearch<SparsePackedState>(opt);
+    }
+    else if (boost::iequals(method, "hda-gbfs")) {
+        if (using_ext_state) return new HashDistributedSearch<ExtensionalPackedState>(HashDistributedSearch<ExtensionalPackedState>::Mode::GBFS, opt);
+        else return new HashDistributedSearch<SparsePackedState>(HashDistributedSearch<SparsePackedState>::Mode::GBFS, opt);
+    }
+    else if (boost::iequals(method, "hda-astar")) {
+        if (using_ext_state) return new HashDistributedSearch<ExtensionalPackedState>(HashDistributedSearch<ExtensionalPackedState>::Mode::ASTAR, opt);
+        else return new HashDistributedSearch<SparsePackedState>(HashDistributedSearch<SparsePackedState>::Mode::ASTAR, opt);
     }
     else if (boost::iequals(method, "lazy")) {
-        if (using_ext_state) return new LazySearch<ExtensionalPackedState>(true, false);
-        else return new LazySearch<SparsePackedState>(true, false);
+        if (using_ext_state) return new LazySearch<ExtensionalPackedState>(true, false, opt);
+        else return new LazySearch<SparsePackedState>(true, false, opt);
     }
     else if (boost::iequals(method, "lazy-po")) {
-        if (using_ext_state) return new LazySearch<ExtensionalPackedState>(false, false);
-        else return new LazySearch<SparsePackedState>(false, false);
+        if (using_ext_state) return new LazySearch<ExtensionalPackedState>(false, false, opt);
+        else return new LazySearch<SparsePackedState>(false, false, opt);
     }
     else if (boost::iequals(method, "lazy-prune")) {
-        if (using_ext_state) return new LazySearch<ExtensionalPackedState>(false, true);
-        else return new LazySearch<SparsePackedState>(false, true);
+        if (using_ext_state) return new LazySearch<ExtensionalPackedState>(false, true, opt);
+        else return new LazySearch<SparsePackedState>(false, true, opt);
     }
     else {
         std::cerr << "Invalid search method \"" << method << "\"" << std::endl;
@@ -1,4 +1,4 @@
-
 #include "search_space.h"
 
-
+std::size_t SearchSpaceMemory::memory_budget_mb = 0;
+std::string SearchSpaceMemory::spill_directory = ".";
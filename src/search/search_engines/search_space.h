@@ -2,25 +2,61 @@
 #pragma once
 
 #include "../algorithms/int_hash_set.h"
+#include "../utils/mapped_arena.h"
 #include "../utils/segmented_vector.h"
 #include "nodes.h"
+#include "operator_registry.h"
 
 #include <fstream>
+#include <memory>
+#include <string>
 #include <unordered_set>
 
 class LiftedOperatorId;
 
 
+/**
+ * @brief Memory budget of the search spaces, set once from the command line.
+ *
+ * @details If the budget is not zero, search spaces allocate their states and
+ * nodes from a MappedArena in the spill directory, which moves the oldest
+ * states and nodes to disk when the process uses more memory than the budget.
+ * The duplicate-detection index always stays in memory.
+ */
+class SearchSpaceMemory {
+    static std::size_t memory_budget_mb;
+    static std::string spill_directory;
+
+public:
+    static void set_memory_budget_mb(std::size_t budget) {
+        memory_budget_mb = budget;
+    }
+
+    static void set_spill_directory(const std::string &directory) {
+        spill_directory = directory;
+    }
+
+    //! Return the arena of a new search space, or nullptr if there is no budget
+    static std::unique_ptr<utils::MappedArena> create_arena() {
+        if (memory_budget_mb == 0)
+            return nullptr;
+        return std::make_unique<utils::MappedArena>(spill_directory, memory_budget_mb);
+    }
+};
+
+
 template <typename StateT>
 class SearchSpace {
 protected:
     using StateHashT = typename StateT::HashT;
+    using StateStorageT = typename StateT::StorageT;
 
+    // Packed states store their hash, so probing and resizing never read the atoms
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedVector<StateT>& state_data;
+        const StateStorageT& state_data;
         StateHashT hasher;
 
-        explicit StateIDSemanticHash(const segmented_vector::SegmentedVector<StateT>& state_data)
+        explicit StateIDSemanticHash(const StateStorageT& state_data)
             : state_data(state_data), hasher()
         {}
 
@@ -30,8 +66,8 @@ protected:
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedVector<StateT>& state_data;
-        explicit StateIDSemanticEqual(const segmented_vector::SegmentedVector<StateT>& state_data)
+        const StateStorageT& state_data;
+        explicit StateIDSemanticEqual(const StateStorageT& state_data)
             : state_data(state_data)
         {}
 
@@ -44,14 +80,20 @@ protected:
 
     using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
 
-    segmented_vector::SegmentedVector<StateT> state_data;
-    segmented_vector::SegmentedVector<SearchNode> node_data;
+    // Must be declared before the storage allocated from it
+    std::unique_ptr<utils::MappedArena> arena;
+    StateStorageT state_data;
+    segmented_vector::SegmentedVector<SearchNode, utils::ArenaAllocator<SearchNode>> node_data;
     StateIDSet registered_states;
+    OperatorRegistry operators;
 
 public:
     SearchSpace() :
-            state_data(),
-            registered_states(StateIDSemanticHash(state_data), StateIDSemanticEqual(state_data))
+            arena(SearchSpaceMemory::create_arena()),
+            state_data(arena.get()),
+            node_data(arena.get()),
+            registered_states(StateIDSemanticHash(state_data), StateIDSemanticEqual(state_data)),
+            operators(arena.get())
     {}
 
     //! Return the number of registered states
@@ -69,7 +111,7 @@ public:
         auto result = registered_states.insert(id);
 
         if (result.second) { // It's an unseen state, create the node
-            node_data.push_back(SearchNode(StateID(id), op, parent, 0));
+            node_data.push_back(SearchNode(StateID(id), operators.insert(op), parent, 0));
 
         } else { // The state was already registered
             id = result.first;
@@ -86,30 +128,47 @@ public:
         SearchNode n = goal_node;
 
         for (;;) {
-            if (n.op == LiftedOperatorId::no_operator) {  // We reached the root node
+            if (n.op == OperatorHandle::no_operator) {  // We reached the root node
                 assert(n.parent_state_id == StateID::no_state);
                 break;
             }
-            plan.push_back(n.op);
+            plan.push_back(operators.get(n.op));
             n = node_data[n.parent_state_id.value];
         }
         reverse(plan.begin(), plan.end());
         return plan;
     }
 
+    //! Make the node reached from the given parent with the given operator
+    void set_parent(SearchNode &node, const LiftedOperatorId &op, StateID parent) {
+        node.op = operators.insert(op);
+        node.parent_state_id = parent;
+    }
+
+    LiftedOperatorId get_operator(const SearchNode &node) const {
+        return operators.get(node.op);
+    }
+
     SearchNode &get_node(StateID id) {
         assert(id.value >= 0 && (unsigned) id.value < node_data.size());
         return node_data[id.value];
     }
 
-    const StateT& get_state(StateID id) {
+    //! Return the packed state, or a view of it if the storage does not keep state objects
+    decltype(auto) get_state(StateID id) const {
         assert(id.value >= 0 && (unsigned) id.value < state_data.size());
         return state_data[id.value];
     }
 
+    //! Return the arena holding the states and nodes, or nullptr if they are on the heap
+    const utils::MappedArena *get_arena() const { return arena.get(); }
+
     void print_statistics() const {
         std::cout << "Number of registered states: " << size() << std::endl;
         registered_states.print_statistics();
+        std::cout << "Number of distinct operators of the search nodes: " << operators.size() << std::endl;
+        if (arena)
+            arena->print_statistics();
     }
 };
 
@@ -58,6 +58,7 @@ public:
     int get_reopened() const {return reopened_states;}
     int get_generated_ops() const {return generated_ops;}
     int get_pruned_states() const {return pruned_states;}
+    int get_dead_ends() const {return dead_end_states;}
 
     /*
       Call the following method with the f value of every expanded
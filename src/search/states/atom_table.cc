@@ -0,0 +1,63 @@
+#include "atom_table.h"
+
+#include "../task.h"
+#include "../utils.h"
+
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+AtomTable::AtomTable(const Task &task)
+    : multipliers(task.predicates.size()),
+      parameter_types(task.predicates.size()),
+      index_to_object(task.compute_object_index()),
+      number_tuples(task.predicates.size()),
+      first_id(task.predicates.size()),
+      number_atoms(0)
+{
+    object_to_index.resize(index_to_object.size());
+    for (size_t t = 0; t < index_to_object.size(); ++t) {
+        object_to_index[t].resize(task.objects.size(), -1);
+        for (size_t j = 0; j < index_to_object[t].size(); ++j) {
+            object_to_index[t][index_to_object[t][j]] = j;
+        }
+    }
+
+    for (size_t i = 0; i < task.predicates.size(); ++i) {
+        const Predicate &pred = task.predicates[i];
+        multipliers[i].reserve(pred.getTypes().size());
+        long multiplier = 1;
+        for (int t : pred.getTypes()) {
+            multipliers[i].push_back(multiplier);
+            parameter_types[i].push_back(t);
+            if (!is_product_within_limit(multiplier, index_to_object[t].size(),
+                                         numeric_limits<long>::max())) {
+                cerr << "Hash multipliers overflow!"
+                     << " State representation is too large to be packed!" << endl;
+                exit(-2);
+            }
+            multiplier *= index_to_object[t].size();
+        }
+        number_tuples[i] = multiplier;
+        first_id[i] = number_atoms;
+        if (number_atoms > numeric_limits<long>::max() - multiplier) {
+            cerr << "Too many ground atoms to be numbered!" << endl;
+            exit(-2);
+        }
+        number_atoms += multiplier;
+    }
+}
+
+GroundAtom AtomTable::get_tuple(int predicate_index, long index) const
+{
+    const vector<long> &pred_multipliers = multipliers[predicate_index];
+    GroundAtom tuple(pred_multipliers.size());
+    for (int i = pred_multipliers.size() - 1; i >= 0; --i) {
+        long object_index = index / pred_multipliers[i];
+        tuple[i] = index_to_object[parameter_types[predicate_index][i]][object_index];
+        index -= object_index * pred_multipliers[i];
+    }
+    assert(index == 0);
+    return tuple;
+}
@@ -0,0 +1,147 @@
+#ifndef SEARCH_STATES_ATOM_TABLE_H
+#define SEARCH_STATES_ATOM_TABLE_H
+
+#include "../structures.h"
+#include "../utils/hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Task;
+
+/**
+ * @brief Numbering of all the ground atoms of a task.
+ *
+ * @details The tuples of each predicate are numbered by their position in the
+ * cartesian product of the objects of the types of the parameters, with the
+ * first parameter varying fastest. The id of an atom is the index of its tuple
+ * plus the number of tuples of the predicates before it, and a nullary
+ * predicate has a single atom. Indices and ids are computed with a few
+ * multiplications, so no table of atoms is kept and no atom is ever hashed.
+ *
+ * Each id also has a pseudo-random Zobrist key. The hash of a state is the XOR
+ * of the keys of its atoms, so the hash of a successor is the hash of its
+ * parent with the keys of the added and deleted atoms XOR-ed in.
+ *
+ * The table is created once the predicates and objects of the task are known,
+ * and is shared by all the components that need integer ids of atoms (state
+ * packers, novelty tables, goal counting, ...).
+ */
+class AtomTable {
+    // Multiplier of each parameter of each predicate
+    std::vector<std::vector<long>> multipliers;
+    // Type of each parameter of each predicate
+    std::vector<std::vector<int>> parameter_types;
+    // Index of each object among the objects of each type, -1 if the object is not of the type
+    std::vector<std::vector<int>> object_to_index;
+    // Objects of each type
+    std::vector<std::vector<int>> index_to_object;
+    // Number of tuples of each predicate
+    std::vector<long> number_tuples;
+    // Id of the first atom of each predicate
+    std::vector<long> first_id;
+    long number_atoms;
+
+public:
+    explicit AtomTable(const Task &task);
+
+    std::size_t get_number_predicates() const {
+        return number_tuples.size();
+    }
+
+    long get_number_atoms() const {
+        return number_atoms;
+    }
+
+    long get_number_tuples(int predicate_index) const {
+        return number_tuples[predicate_index];
+    }
+
+    long get_first_id(int predicate_index) const {
+        return first_id[predicate_index];
+    }
+
+    template<class TupleT>
+    long get_index(int predicate_index, const TupleT &tuple) const {
+        const std::vector<long> &pred_multipliers = multipliers[predicate_index];
+        const std::vector<int> &types = parameter_types[predicate_index];
+        long index = 0;
+        std::size_t i = 0;
+        for (int object : tuple) {
+            int object_index = object_to_index[types[i]][object];
+            assert(object_index != -1);
+            index += pred_multipliers[i] * object_index;
+            ++i;
+        }
+        assert(i == types.size());
+        return index;
+    }
+
+    template<class TupleT>
+    long get_id(int predicate_index, const TupleT &tuple) const {
+        return first_id[predicate_index] + get_index(predicate_index, tuple);
+    }
+
+    GroundAtom get_tuple(int predicate_index, long index) const;
+
+    static std::uint32_t get_zobrist_key(long id) {
+        return utils::get_hash32(static_cast<std::uint64_t>(id));
+    }
+};
+
+/**
+ * @brief Indices in the AtomTable of the tuples of the relations of a state,
+ * sorted within each relation.
+ */
+class TupleIndices {
+    std::vector<long> indices;
+    // Position in indices of the first tuple of each relation, plus the end
+    std::vector<std::size_t> relation_start;
+
+public:
+    bool is_valid() const {
+        return !relation_start.empty();
+    }
+
+    void invalidate() {
+        indices.clear();
+        relation_start.clear();
+    }
+
+    // Start filling the indices again, one relation after the other
+    void reset() {
+        indices.clear();
+        relation_start.assign(1, 0);
+    }
+
+    void add_index(long index) {
+        indices.push_back(index);
+    }
+
+    // End the relation whose indices were added since the last call
+    void end_relation() {
+        std::sort(indices.begin() + relation_start.back(), indices.end());
+        relation_start.push_back(indices.size());
+    }
+
+    const long *begin(std::size_t relation) const {
+        return indices.data() + relation_start[relation];
+    }
+
+    const long *end(std::size_t relation) const {
+        return indices.data() + relation_start[relation + 1];
+    }
+
+    std::size_t size(std::size_t relation) const {
+        return relation_start[relation + 1] - relation_start[relation];
+    }
+
+    bool contains(std::size_t relation, long index) const {
+        return std::binary_search(begin(relation), end(relation), index);
+    }
+};
+
+#endif // SEARCH_STATES_ATOM_TABLE_H
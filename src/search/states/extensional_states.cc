@@ -1,9 +1,7 @@
 
 #include "extensional_states.h"
-#include "../algorithms/cartesian_iterator.h"
 #include "../task.h"
 #include "../utils.h"
-#include "../utils/hash.h"
 
 #include <cstdint>
 #include <iostream>
@@ -11,62 +9,32 @@
 
 
 unsigned ExtensionalPackedState::Hash::operator() (const ExtensionalPackedState &s) const {
-
-//    std::size_t seed = 0;
-//    boost::hash_combine(seed, s.atoms.m_num_bits);
-//    boost::hash_combine(seed, s.atoms.m_bits);
-//    return (unsigned) seed;
-//    return (unsigned) boost::hash_value(s.atoms);
-//    return (unsigned) boost::hash_range(s.atoms.cbegin(), s.atoms.cend());
-//    std::hash<std::vector<bool>> hasher;
-//    hasher.operator()(s.atoms);
-//    return (unsigned) hasher(s.atoms);
-    utils::HashState hash_state;
-    utils::feed(hash_state, s.atoms);
-    return hash_state.get_hash32();
+    return s.hash;
 }
 
 
 ExtensionalStatePacker::ExtensionalStatePacker(const Task &task) :
-    task(task), npreds(task.predicates.size()), args_to_index(), index_to_args(), blank_state(npreds)
+    task(task), npreds(task.predicates.size()), table(task.get_atom_table()),
+    first_bit(npreds, -1), number_bits(0), blank_state(npreds)
 {
-    auto objects_per_type = task.compute_object_index();
-    args_to_index.reserve(npreds);
-
     for (std::size_t pid = 0; pid < npreds; ++pid) {
-        const auto& pred = task.predicates[pid];
-
-        args_to_index.emplace_back();  // emplace back an empty map
-        auto& ati_map = args_to_index.back();
-
-        const auto& types = pred.getTypes();
-        if (types.empty()) { // A nullary predicate - special treatment
-            ati_map.emplace(args_t(), index_to_args.size());
-            index_to_args.push_back({pid, {}});
-            continue;
-        }
-
-        std::vector<std::vector<int>> objects_per_arg;
-        for (const auto& type:types) {
-            objects_per_arg.push_back(objects_per_type[type]);
-        }
-
-        for (auto it = utils::cartesian_iterator<int>(objects_per_arg); !it.ended(); ++it) {
-            const std::vector<int>& args = *it;
-            ati_map.emplace(args, index_to_args.size());
-            index_to_args.emplace_back(pid, args);
-        }
-
         // Looks a bit redundant, but that's the way it is:
         blank_state.set_relation_predicate_symbol(pid, pid);
+
+        const Predicate &pred = task.predicates[pid];
+        if (pred.isStaticPredicate() && !pred.getTypes().empty())
+            continue;
+        first_bit[pid] = number_bits;
+        number_bits += table.get_number_tuples(pid);
     }
 
     std::cout << "Indexed a total of " << num_atoms() << " atoms" << std::endl;
 }
 
 unsigned ExtensionalStatePacker::to_index(int predicate, const std::vector<int>& arguments) const {
-    assert(0 <= predicate && (unsigned) predicate <= args_to_index.size());
-    return args_to_index[predicate].at(arguments);
+    assert(0 <= predicate && (unsigned) predicate < npreds);
+    assert(first_bit[predicate] != -1);
+    return first_bit[predicate] + table.get_index(predicate, arguments);
 }
 
 
@@ -78,40 +46,55 @@ ExtensionalPackedState ExtensionalStatePacker::pack(const DBState &state) const
     const auto& nullary_atoms = state.get_nullary_atoms();
     for (std::size_t i = 0, sz = nullary_atoms.size(); i < sz; ++i) {
         if (nullary_atoms[i]) {
-//            packed.atoms[to_index(i, {})] = true;
-            packed.atoms.set(to_index(i, {}));
+            assert(first_bit[i] != -1);
+            packed.atoms.set(first_bit[i]);
         }
     }
 
-    for (const Relation &relation:state.get_relations()) {
-        int pid = relation.predicate_symbol;
-        for (const auto &tuple:relation.tuples) {
-//            packed.atoms[to_index(pid, tuple)] = true;
-            packed.atoms.set(to_index(pid, tuple));
+    const TupleIndices &tuples = state.get_tuple_indices(table);
+    const auto &relations = state.get_relations();
+    for (std::size_t i = 0; i < relations.size(); ++i) {
+        long first = first_bit[relations[i].predicate_symbol];
+        assert(first != -1 || tuples.size(i) == 0);
+        for (const long *tuple = tuples.begin(i); tuple != tuples.end(i); ++tuple) {
+            packed.atoms.set(first + *tuple);
         }
     }
+    packed.hash = state.get_hash(table);
     return packed;
 }
 
 DBState ExtensionalStatePacker::unpack(const ExtensionalPackedState &packed) const {
     DBState result(blank_state);  // Let's start off with the precomputed state
 
-    auto natoms = packed.atoms.size();
-    assert(natoms == num_atoms());
-    for (std::size_t aid = 0; aid < natoms; ++aid) {
-        if (!packed.atoms[aid]) continue;
-
-        const auto& x = index_to_args[aid];
-        int pid = x.first;
-        const args_t& args = x.second;
-        if (args.empty()) {  // A nullary predicate
+    assert(packed.atoms.size() == num_atoms());
+    TupleIndices indices;
+    indices.reset();
+    for (std::size_t pid = 0; pid < npreds; ++pid) {
+        long first = first_bit[pid];
+        if (first == -1) {  // A static predicate, whose relation stays empty
+            indices.end_relation();
+            continue;
+        }
+        long number_tuples = table.get_number_tuples(pid);
+        if (task.predicates[pid].getTypes().empty()) {  // A nullary predicate
             // Make true the position corresponding to *the predicate*
-            result.set_nullary_atom(pid, true);
-
-        } else {  // An arity > 0 predicate
-            result.insert_tuple_in_relation(args, pid);
+            if (packed.atoms[first])
+                result.set_nullary_atom(pid, true);
+        }
+        else {  // An arity > 0 predicate
+            for (long index = 0; index < number_tuples; ++index) {
+                if (packed.atoms[first + index]) {
+                    result.insert_tuple_in_relation(table.get_tuple(pid, index), pid);
+                    indices.add_index(index);
+                }
+            }
         }
+        indices.end_relation();
     }
+    // Bits are visited in increasing order, so the indices are already sorted
+    result.set_tuple_indices(std::move(indices));
+    result.set_hash(packed.hash);
 
     return result;
 }
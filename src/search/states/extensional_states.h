@@ -1,10 +1,13 @@
 #ifndef EXTENSIONAL_SEARCH_STATE_PACKER_H
 #define EXTENSIONAL_SEARCH_STATE_PACKER_H
 
+#include "atom_table.h"
 #include "state.h"
 #include "../algorithms/dynamic_bitset.h"
+#include "../utils/mapped_arena.h"
+#include "../utils/segmented_vector.h"
 
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
 //#include <boost/dynamic_bitset.hpp>
@@ -15,8 +18,11 @@ class Task;
 /**
  * @brief A bitvector-based representation of states
  *
- * @details
- *
+ * @details There is one bit per atom of the fluent and nullary predicates. The
+ * relations of static predicates are always empty in a DBState, as their tuples
+ * are kept once in the static information of the task, so they get no bits. The
+ * Zobrist hash of the state is stored with the bits, so hashing a packed state
+ * does not read them.
  */
 
 class ExtensionalStatePacker;
@@ -24,13 +30,16 @@ class ExtensionalStatePacker;
 class ExtensionalPackedState {
 public:
     using StatePackerT = ExtensionalStatePacker;
+    using StorageT = segmented_vector::SegmentedVector<ExtensionalPackedState,
+                                                       utils::ArenaAllocator<ExtensionalPackedState>>;
 
 //    std::vector<bool> atoms;
 //    boost::dynamic_bitset<> atoms;
 
     dynamic_bitset::DynamicBitset<> atoms;
+    std::uint32_t hash;
 
-    explicit ExtensionalPackedState(std::size_t size) : atoms(size) {}
+    explicit ExtensionalPackedState(std::size_t size) : atoms(size), hash(0) {}
 
     ExtensionalPackedState(const ExtensionalPackedState&) = default;
     ExtensionalPackedState(ExtensionalPackedState&&) = default;
@@ -56,9 +65,12 @@ protected:
 
     std::size_t npreds;
 
-    using args_t = std::vector<int>;
-    std::vector<std::unordered_map<args_t, long unsigned int, boost::hash<args_t>>> args_to_index;
-    std::vector<std::pair<long unsigned int, args_t>> index_to_args;
+    //! Numbering of the tuples of each predicate, shared with the rest of the task
+    const AtomTable &table;
+
+    //! Bit of the first atom of each predicate, or -1 if the predicate is static and not nullary
+    std::vector<long> first_bit;
+    std::size_t number_bits;
 
     //! A state placeholder for faster creation of states in ExtensionalStatePacker::pack
     DBState blank_state;
@@ -67,7 +79,7 @@ protected:
 public:
     explicit ExtensionalStatePacker(const Task &task);
 
-    std::size_t num_atoms() const { return index_to_args.size(); }
+    std::size_t num_atoms() const { return number_bits; }
 
     unsigned to_index(int predicate, const std::vector<int>& arguments) const;
 
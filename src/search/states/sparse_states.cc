@@ -1,153 +1,145 @@
-
 #include "sparse_states.h"
 #include "../task.h"
-#include "../utils.h"
-
-#include "../utils/hash.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
+using namespace std;
 
-
-bool SparsePackedState::operator==(const SparsePackedState &b) const {
-    if (predicate_symbols.size() != b.predicate_symbols.size())
-        return false;
-    for (size_t i = 0; i < predicate_symbols.size(); ++i) {
-        if (predicate_symbols[i] != b.predicate_symbols[i])
-            return false;
-    }
-    for (size_t i = 0; i < nullary_atoms.size(); ++i) {
-        if (nullary_atoms[i] != b.nullary_atoms[i])
-            return false;
+static size_t get_varint_size(size_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
     }
-    for (size_t i = 0; i < packed_relations.size(); ++i) {
-        if (packed_relations[i].size() != b.packed_relations[i].size())
-            return false;
-        for (size_t j = 0; j < packed_relations[i].size(); j++) {
-            if (packed_relations[i][j] != b.packed_relations[i][j])
-                return false;
-        }
-    }
-    return true;
+    return size;
 }
 
+static unsigned char *write_varint(unsigned char *out, size_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(value);
+    return out;
+}
 
-unsigned PackedStateHash::operator() (const SparsePackedState &s) const {
-    utils::HashState hash_state;
-
-    for (int i : s.predicate_symbols) {
-        utils::feed(hash_state, i);
+static size_t read_varint(const unsigned char *&in) {
+    size_t value = 0;
+    int shift = 0;
+    while (*in & 0x80) {
+        value |= size_t(*in++ & 0x7F) << shift;
+        shift += 7;
     }
-    for (bool b : s.nullary_atoms) {
-        utils::feed(hash_state, b);
+    value |= size_t(*in++) << shift;
+    return value;
+}
+
+static unsigned char *write_tuple(unsigned char *out, long tuple, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        *out++ = static_cast<unsigned char>(tuple >> (8 * i));
     }
-    for (const auto &r : s.packed_relations) {
-        utils::feed(hash_state, r);
+    return out;
+}
+
+static long read_tuple(const unsigned char *&in, int bytes) {
+    long tuple = 0;
+    for (int i = 0; i < bytes; ++i) {
+        tuple |= long(*in++) << (8 * i);
     }
-    return hash_state.get_hash32();
+    return tuple;
 }
 
 
-SparseStatePacker::SparseStatePacker(const Task &task) {
-    obj_to_hash_index.resize(task.predicates.size());
-    hash_index_to_obj.resize(task.predicates.size());
-    hash_multipliers.resize(task.predicates.size());
-    auto objects_per_type = task.compute_object_index();
-
-
-    // Loop over all predicates computing the hash multipliers
-    // for each one.
-    for (size_t i = 0; i < hash_multipliers.size(); ++i) {
-        const Predicate &pred = task.predicates[i];
-        hash_multipliers[i].reserve(pred.getTypes().size());
-        obj_to_hash_index[i].resize(pred.getTypes().size());
-        hash_index_to_obj[i].resize(pred.getTypes().size());
-        long multiplier = 1;
-        int cont = 0;
-        for (auto t : pred.getTypes()) {
-            hash_multipliers[i].push_back(multiplier);
-            if (is_product_within_limit(multiplier, objects_per_type[t].size(),
-                                        std::numeric_limits<long>::max())) {
-                multiplier *= objects_per_type[t].size();
-                for (size_t j = 0; j < objects_per_type[t].size(); ++j) {
-                    obj_to_hash_index[i][cont][objects_per_type[t][j]] = j;
-                    hash_index_to_obj[i][cont][j] = objects_per_type[t][j];
-                }
-                cont++;
-            }
-            else {
-                std::cerr << "Hash multipliers overflow!" <<
-                " State representation is too large to be packed!" << std::endl;
-                exit(-2);
-            }
+SparseStatePacker::SparseStatePacker(const Task &task) : table(task.get_atom_table()) {
+    tuple_bytes.resize(task.predicates.size());
+    is_static.resize(task.predicates.size());
+    nullary_bytes = (task.predicates.size() + 7) / 8;
+    for (size_t i = 0; i < tuple_bytes.size(); ++i) {
+        is_static[i] = task.predicates[i].isStaticPredicate();
+        // Bytes needed for the largest tuple index of the predicate
+        int bytes = 0;
+        for (long largest = table.get_number_tuples(i) - 1; largest > 0; largest >>= 8) {
+            ++bytes;
         }
+        tuple_bytes[i] = bytes;
     }
 }
 
 SparsePackedState SparseStatePacker::pack(const DBState &state) const {
-    SparsePackedState packed_state;
     const auto &relations = state.get_relations();
-    packed_state.packed_relations.reserve(relations.size());
-    packed_state.predicate_symbols.reserve(relations.size());
-    packed_state.nullary_atoms = state.get_nullary_atoms();
-    for (const Relation &r : relations) {
-        std::vector<long> packed_relation;
-        packed_relation.reserve(r.tuples.size());
-        int predicate_index = r.predicate_symbol;
-        packed_state.predicate_symbols.push_back(predicate_index);
-        for (const auto &tuple : r.tuples) {
-            packed_relation.push_back(pack_tuple(tuple, predicate_index));
+    const auto &nullary_atoms = state.get_nullary_atoms();
+    assert(relations.size() == tuple_bytes.size());
+
+    const TupleIndices &tuples = state.get_tuple_indices(table);
+    size_t size = SparsePackedState::HASH_BYTES + nullary_bytes;
+    for (size_t i = 0; i < relations.size(); ++i) {
+        assert(relations[i].predicate_symbol == int(i));
+        if (is_static[i]) {
+            // The tuples of static predicates are in the static information of the task
+            assert(relations[i].tuples.empty());
+            continue;
         }
-        sort(packed_relation.begin(), packed_relation.end());
-        packed_state.packed_relations.push_back(packed_relation);
+        size += get_varint_size(tuples.size(i)) + tuples.size(i) * tuple_bytes[i];
     }
-    return packed_state;
-}
 
-DBState SparseStatePacker::unpack(const SparsePackedState &packed_state) const {
-    std::vector<Relation> relations;
-    std::vector<bool> nullary_atoms = packed_state.nullary_atoms;
-    relations.reserve(packed_state.packed_relations.size());
-    for (size_t i = 0; i < packed_state.packed_relations.size(); ++i) {
-        std::unordered_set<GroundAtom, TupleHash> tuples;
-        for (const auto &r : packed_state.packed_relations[i]) {
-            tuples.insert(unpack_tuple(r, packed_state.predicate_symbols[i]));
+    SparsePackedState packed_state;
+    packed_state.data.resize(size, 0);
+    unsigned char *begin = packed_state.data.data();
+    unsigned char *out = begin + SparsePackedState::HASH_BYTES;
+    for (size_t i = 0; i < nullary_atoms.size(); ++i) {
+        if (nullary_atoms[i])
+            out[i / 8] |= 1 << (i % 8);
+    }
+    out += nullary_bytes;
+    for (size_t i = 0; i < relations.size(); ++i) {
+        if (is_static[i])
+            continue;
+        out = write_varint(out, tuples.size(i));
+        for (const long *tuple = tuples.begin(i); tuple != tuples.end(i); ++tuple) {
+            out = write_tuple(out, *tuple, tuple_bytes[i]);
         }
-        relations.emplace_back(packed_state.predicate_symbols[i], std::move(tuples));
     }
-    return DBState(std::move(relations), std::move(nullary_atoms));
-}
+    assert(out == begin + size);
 
-long SparseStatePacker::pack_tuple(const std::vector<int> &tuple, int predicate_index) const {
-    long index = 0;
-    for (size_t i = 0; i < tuple.size(); ++i) {
-        index += hash_multipliers[predicate_index][i] *
-                 get_index_given_predicate_and_param(predicate_index, i, tuple[i]);
-    }
-    return index;
+    uint32_t hash = state.get_hash(table);
+    memcpy(begin, &hash, sizeof(hash));
+    return packed_state;
 }
 
-GroundAtom SparseStatePacker::unpack_tuple(long tuple, int predicate_index) const {
-    std::vector<int> values(hash_multipliers[predicate_index].size());
-    int aux;
-    for (int i = hash_multipliers[predicate_index].size() - 1; i >= 0; --i) {
-        aux = tuple / hash_multipliers[predicate_index][i];
-        values[i] = get_obj_given_predicate_and_param(predicate_index, i, aux);
-        tuple -= aux * hash_multipliers[predicate_index][i];
-    }
-    assert(tuple == 0);
-    return values;
-}
+DBState SparseStatePacker::unpack(const SparsePackedStateView &packed_state) const {
+    const unsigned char *in = packed_state.data + SparsePackedState::HASH_BYTES;
+    size_t num_predicates = tuple_bytes.size();
 
-int SparseStatePacker::get_index_given_predicate_and_param(int pred, int param, int element) const {
-    return obj_to_hash_index[pred][param].at(element);
-}
+    std::vector<bool> nullary_atoms(num_predicates);
+    for (size_t i = 0; i < num_predicates; ++i) {
+        nullary_atoms[i] = (in[i / 8] >> (i % 8)) & 1;
+    }
+    in += nullary_bytes;
 
-int SparseStatePacker::get_obj_given_predicate_and_param(int pred, int param, int element) const {
-    return hash_index_to_obj[pred][param].at(element);
+    std::vector<Relation> relations;
+    relations.reserve(num_predicates);
+    TupleIndices indices;
+    indices.reset();
+    for (size_t i = 0; i < num_predicates; ++i) {
+        size_t n = is_static[i] ? 0 : read_varint(in);
+        TupleSet tuples;
+        for (size_t j = 0; j < n; ++j) {
+            long index = read_tuple(in, tuple_bytes[i]);
+            tuples.insert(table.get_tuple(i, index));
+            indices.add_index(index);
+        }
+        indices.end_relation();
+        relations.emplace_back(i, std::move(tuples));
+    }
+    assert(in == packed_state.data + packed_state.size);
+    DBState state(std::move(relations), std::move(nullary_atoms));
+    // The indices were written sorted, so they can be reused as they are
+    state.set_tuple_indices(std::move(indices));
+    state.set_hash(packed_state.get_hash());
+    return state;
 }
-
-
@@ -1,26 +1,42 @@
 #ifndef SEARCH_SPARSE_STATES_H
 #define SEARCH_SPARSE_STATES_H
 
+#include "atom_table.h"
+
+#include "../utils/mapped_arena.h"
+#include "../utils/segmented_vector.h"
+
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <vector>
-#include <unordered_map>
-
-#include <boost/functional/hash/hash.hpp>
 
 /**
  * @brief The packed state representation is a more concise representation of states,
  * based on the Fast Downward source code.
  *
- * @details We represent a state as a vector of relations and a vector of
- * nullary atoms. Each relation is a set of tuples, which can be interpreted as a 'table'.
- * In order to make the representation more concise, we first order the tuples in the
- * sets corresponding to each relation in a deterministic way. We then hash these sets
- * in a well-defined order (by the predicate symbol of the corresponding relation).
- * Last, we combine all these hash values together and also combine with a hash over
- * the predicate symbols and the truth value of the nullary relations
- * (i.e., predicates) of the state.
+ * @details We represent a state as a single byte array. Each tuple of a relation is
+ * mapped to an integer (its index in the AtomTable of the task), and the
+ * integers of each relation are sorted, so equal states have equal arrays. The
+ * array contains, in this order:
+ *
+ *   - 4 bytes with the Zobrist hash of the state (see AtomTable);
+ *   - one bit per predicate with the truth value of the nullary atoms;
+ *   - for each fluent predicate, in the order of the predicate symbols, the
+ *     number of tuples as a variable-length integer, followed by the sorted tuple
+ *     indices, each one written in as few bytes as the largest index of the
+ *     predicate needs.
+ *
+ * The relations of static predicates are always empty in a DBState, as their
+ * tuples are kept once in the static information of the task, so they take no
+ * space in the array and are unpacked as empty relations.
+ *
+ * The hash is the one of the DBState, which successor generators derive from
+ * the hash of the parent state, so packing a successor does not hash its atoms
+ * again, and search spaces never rehash a stored state. Search spaces store the
+ * arrays one after the other in a SegmentedBlobVector (see
+ * SparsePackedStateStorage).
  * This packed state representation is loosely based on the PDB storage system used
  * by Fast Downward.
  *
@@ -30,26 +46,75 @@ class Task;
 class DBState;
 
 class SparseStatePacker;
+class SparsePackedStateStorage;
 class PackedStateHash;
 
 class SparsePackedState {
 public:
     using StatePackerT = SparseStatePacker;
+    using StorageT = SparsePackedStateStorage;
 
-    std::vector<std::vector<long>> packed_relations;
-    std::vector<int> predicate_symbols;
-    std::vector<bool> nullary_atoms;
+    static constexpr std::size_t HASH_BYTES = sizeof(std::uint32_t);
 
+    std::vector<unsigned char> data;
 
-    bool operator==(const SparsePackedState &b) const;
+    bool operator==(const SparsePackedState &b) const { return data == b.data; }
 
     using HashT = PackedStateHash;
+};
 
+/**
+ * @brief Non-owning reference to the byte array of a packed state
+ */
+class SparsePackedStateView {
+public:
+    const unsigned char *data;
+    std::size_t size;
+
+    SparsePackedStateView(const unsigned char *data, std::size_t size) : data(data), size(size) {}
+
+    SparsePackedStateView(const SparsePackedState &s) : data(s.data.data()), size(s.data.size()) {}
+
+    unsigned get_hash() const {
+        std::uint32_t hash;
+        std::memcpy(&hash, data, sizeof(hash));
+        return hash;
+    }
+
+    bool operator==(const SparsePackedStateView &b) const {
+        return size == b.size && std::memcmp(data, b.data, size) == 0;
+    }
 };
 
 class PackedStateHash {
 public:
-    unsigned operator() (const SparsePackedState &s) const;
+    unsigned operator() (const SparsePackedStateView &s) const { return s.get_hash(); }
+};
+
+/**
+ * @brief Store the byte arrays of packed states contiguously, indexed by state id
+ *
+ * @details The arrays are allocated from the given arena, or from the heap if
+ * there is none.
+ */
+class SparsePackedStateStorage {
+    segmented_vector::SegmentedBlobVector<utils::ArenaAllocator<unsigned char>> blobs;
+
+public:
+    explicit SparsePackedStateStorage(utils::MappedArena *arena = nullptr) : blobs(arena) {}
+
+    std::size_t size() const { return blobs.size(); }
+
+    void push_back(const SparsePackedState &state) {
+        blobs.push_back(state.data.data(), state.data.size());
+    }
+
+    void pop_back() { blobs.pop_back(); }
+
+    SparsePackedStateView operator[](std::size_t index) const {
+        auto blob = blobs[index];
+        return SparsePackedStateView(blob.data, blob.size);
+    }
 };
 
 
@@ -63,21 +128,16 @@ public:
 
     SparsePackedState pack(const DBState &state) const;
 
-    DBState unpack(const SparsePackedState &packed_state) const;
+    DBState unpack(const SparsePackedStateView &packed_state) const;
 
 private:
-    long pack_tuple(const std::vector<int> &tuple, int predicate_index) const;
-
-    std::vector<int> unpack_tuple(long tuple, int predicate_index) const;
-
-    int get_index_given_predicate_and_param(int pred, int param, int element) const;
-
-    int get_obj_given_predicate_and_param(int pred, int param, int element) const;
-
-
-    std::vector<std::vector<long>> hash_multipliers;
-    std::vector<std::vector<std::unordered_map<int, int>>> obj_to_hash_index;
-    std::vector<std::vector<std::unordered_map<int, int>>> hash_index_to_obj;
+    //! Numbering of the tuples of each predicate, shared with the rest of the task
+    const AtomTable &table;
+    // Bytes used to write each tuple index of each predicate
+    std::vector<int> tuple_bytes;
+    // Whether each predicate is static, and hence not stored
+    std::vector<bool> is_static;
+    std::size_t nullary_bytes;
 };
 
 
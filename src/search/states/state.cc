@@ -3,10 +3,73 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <cassert>
+
 using namespace std;
 
 void DBState::add_tuple(int relation, const GroundAtom &args) {
   relations[relation].tuples.insert(args);
+  tuple_indices.invalidate();
+  hash_is_valid = false;
+}
+
+const TupleIndices &DBState::get_tuple_indices(const AtomTable &table) const {
+    if (!tuple_indices.is_valid()) {
+        tuple_indices.reset();
+        for (const Relation &relation : relations) {
+            for (const auto &tuple : relation.tuples) {
+                tuple_indices.add_index(table.get_index(relation.predicate_symbol, tuple));
+            }
+            tuple_indices.end_relation();
+        }
+    }
+    return tuple_indices;
+}
+
+uint32_t DBState::get_hash(const AtomTable &table) const {
+    if (!hash_is_valid) {
+        const TupleIndices &indices = get_tuple_indices(table);
+        hash = 0;
+        for (size_t i = 0; i < relations.size(); ++i) {
+            long first_id = table.get_first_id(relations[i].predicate_symbol);
+            for (const long *index = indices.begin(i); index != indices.end(i); ++index) {
+                hash ^= AtomTable::get_zobrist_key(first_id + *index);
+            }
+        }
+        for (size_t i = 0; i < nullary_atoms.size(); ++i) {
+            if (nullary_atoms[i])
+                hash ^= AtomTable::get_zobrist_key(table.get_first_id(i));
+        }
+        hash_is_valid = true;
+    }
+    return hash;
+}
+
+void DBState::set_hash_from_parent(const DBState &parent,
+                                   const AtomTable &table,
+                                   const vector<pair<int, GroundAtom>> &added_atoms,
+                                   const vector<pair<int, GroundAtom>> &deleted_atoms) {
+    uint32_t h = parent.get_hash(table);
+    for (const auto &[predicate, atom] : deleted_atoms) {
+        if (!relations[predicate].tuples.count(atom))
+            h ^= AtomTable::get_zobrist_key(table.get_id(predicate, atom));
+    }
+    for (const auto &[predicate, atom] : added_atoms) {
+        // Nullary atoms are compared below
+        if (!atom.empty() && !parent.relations[predicate].tuples.count(atom))
+            h ^= AtomTable::get_zobrist_key(table.get_id(predicate, atom));
+    }
+    assert(nullary_atoms.size() == parent.nullary_atoms.size());
+    for (size_t i = 0; i < nullary_atoms.size(); ++i) {
+        if (nullary_atoms[i] != parent.nullary_atoms[i])
+            h ^= AtomTable::get_zobrist_key(table.get_first_id(i));
+    }
+#ifndef NDEBUG
+    // Check the incremental hash against the one of the whole state
+    hash_is_valid = false;
+    assert(get_hash(table) == h);
+#endif
+    set_hash(h);
 }
 
 
@@ -17,7 +80,7 @@ std::size_t hash_value(const DBState &s) {
     }
     for (const Relation &r : s.relations) {
         std::vector<std::size_t> x;
-        for (const GroundAtom &vga : r.tuples) {
+        for (const auto &vga : r.tuples) {
             std::size_t aux_seed = vga.size();
             for (auto &i : vga)
                 aux_seed ^= i + 0x9e3779b9 + (aux_seed << 6) + (aux_seed >> 2);
@@ -1,9 +1,12 @@
 #ifndef SEARCH_STATE_H
 #define SEARCH_STATE_H
 
+#include "atom_table.h"
+
 #include "../structures.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -21,6 +24,14 @@
  * see A. B. Correa, 2019.'Planning using Lifted Task Representations',
  * M.Sc. thesis. University of Basel.
  *
+ * The indices of the tuples in the AtomTable of the task are computed on
+ * first use and kept with the state, so the packers, novelty tables and
+ * heuristics that work on integer ids share a single computation. The cache is
+ * filled lazily, so a state must not be used to get its indices from several
+ * threads at once before they were computed. The same holds for the Zobrist
+ * hash of the state (see AtomTable), which successor generators derive from the
+ * hash of the parent state and packers store with the packed state.
+ *
  * @see state_packer.h
  *
  */
@@ -28,6 +39,9 @@ class DBState {
 
     std::vector<Relation> relations;
     std::vector<bool> nullary_atoms;
+    mutable TupleIndices tuple_indices;
+    mutable std::uint32_t hash = 0;
+    mutable bool hash_is_valid = false;
 
 public:
 
@@ -48,12 +62,13 @@ public:
         return nullary_atoms;
     }
 
-    const std::unordered_set<GroundAtom, TupleHash>& get_tuples_of_relation(size_t i) const {
+    const TupleSet& get_tuples_of_relation(size_t i) const {
         return relations[i].tuples;
     }
 
     void set_nullary_atom(size_t index, bool v) {
         nullary_atoms[index] = v;
+        hash_is_valid = false;
     }
 
     void set_relation_predicate_symbol(size_t i, int id) {
@@ -62,10 +77,38 @@ public:
 
     void insert_tuple_in_relation(GroundAtom ga, int id) {
         relations[id].tuples.insert(ga);
+        tuple_indices.invalidate();
+        hash_is_valid = false;
     }
 
     void add_tuple(int relation, const GroundAtom &args);
 
+    const TupleIndices &get_tuple_indices(const AtomTable &table) const;
+
+    // Set the indices of the tuples when they are already known, e.g., when unpacking
+    void set_tuple_indices(TupleIndices &&indices) {
+        tuple_indices = std::move(indices);
+    }
+
+    std::uint32_t get_hash(const AtomTable &table) const;
+
+    // Set the hash when it is already known, e.g., when unpacking
+    void set_hash(std::uint32_t h) {
+        hash = h;
+        hash_is_valid = true;
+    }
+
+    /*
+     * Set the hash of a successor of the given parent from the hash of the
+     * parent and the atoms the action added and deleted. Atoms reported as
+     * added that were already true in the parent, and atoms reported as
+     * deleted that are true in the successor, do not change the hash.
+     */
+    void set_hash_from_parent(const DBState &parent,
+                              const AtomTable &table,
+                              const std::vector<std::pair<int, GroundAtom>> &added_atoms,
+                              const std::vector<std::pair<int, GroundAtom>> &deleted_atoms);
+
     bool operator==(const DBState &other) const {
         return nullary_atoms==other.nullary_atoms && relations==other.relations;
     }
@@ -5,7 +5,7 @@
 #include <unordered_set>
 
 Relation::Relation(const PtrRelation &relation){
-    tuples = std::unordered_set<GroundAtom, TupleHash>();
+    tuples = TupleSet();
     for (auto tuple : relation.tuples){
         auto new_tuple = std::vector<int>();
         for (auto elem_ptr : *tuple){
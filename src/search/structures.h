@@ -1,6 +1,7 @@
 #ifndef SEARCH_STRUCTURES_H
 #define SEARCH_STRUCTURES_H
 
+#include "flat_tuple_set.h"
 #include "hash_structures.h"
 
 #include <string>
@@ -16,6 +17,17 @@
  */
 typedef std::vector<int> GroundAtom;
 
+/**
+ * @brief Set of tuples of a relation. Configured at build time with the
+ * FLAT_RELATIONS option: sorted flat arrays (FlatTupleSet) or hash sets of
+ * GroundAtoms (default).
+ */
+#ifdef FLAT_RELATIONS
+typedef FlatTupleSet TupleSet;
+#else
+typedef std::unordered_set<GroundAtom, TupleHash> TupleSet;
+#endif
+
 
 /**
  * @brief Represent a parameter for a given action schema.
@@ -96,8 +108,7 @@ public:
 struct PtrRelation;
 struct Relation {
     Relation() = default;
-    Relation(int predicate_symbol,
-        std::unordered_set<GroundAtom, TupleHash> &&tuples)
+    Relation(int predicate_symbol, TupleSet &&tuples)
             : predicate_symbol(predicate_symbol),
               tuples (std::move(tuples)) {}
 
@@ -110,7 +121,7 @@ struct Relation {
     }
 
     int predicate_symbol{};
-    std::unordered_set<GroundAtom, TupleHash> tuples;
+    TupleSet tuples;
 };
 
 struct PtrRelation {
@@ -0,0 +1,395 @@
+#include "adaptive_join_successor.h"
+
+#include "../action_schema.h"
+
+#include "../database/hash_join.h"
+#include "../database/hash_semi_join.h"
+#include "../database/table.h"
+#include "../states/state.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <unordered_set>
+
+using namespace std;
+
+/*
+ * Estimated size of a table and estimated number of distinct values of each
+ * of its variables.
+ */
+struct TableEstimate {
+    double size = 0;
+    map<int, double> distinct_values;
+};
+
+static TableEstimate estimate_join(const TableEstimate &t1, const TableEstimate &t2)
+{
+    TableEstimate result;
+    result.size = t1.size * t2.size;
+    result.distinct_values = t1.distinct_values;
+    for (const auto &[variable, distinct] : t2.distinct_values) {
+        auto it = result.distinct_values.find(variable);
+        if (it == result.distinct_values.end()) {
+            result.distinct_values.emplace(variable, distinct);
+        }
+        else {
+            result.size /= max(max(it->second, distinct), 1.0);
+            it->second = min(it->second, distinct);
+        }
+    }
+    for (auto &entry : result.distinct_values)
+        entry.second = min(entry.second, result.size);
+    return result;
+}
+
+
+AdaptiveJoinSuccessorGenerator::AdaptiveJoinSuccessorGenerator(const Task &task)
+    : GenericJoinSuccessor(task)
+{
+    predicate_statistics.resize(is_predicate_static.size());
+    vector<bool> is_fluent_predicate(is_predicate_static.size(), false);
+    static_distinct_values.resize(action_data.size());
+    for (const PrecompiledActionData &adata : action_data) {
+        const vector<Atom> &atoms = adata.relevant_precondition_atoms;
+        vector<bool> is_fluent(atoms.size(), false);
+        for (unsigned i : adata.fluent_tables) {
+            is_fluent[i] = true;
+            int predicate = atoms[i].get_predicate_symbol_idx();
+            if (!is_fluent_predicate[predicate]) {
+                is_fluent_predicate[predicate] = true;
+                fluent_predicates.push_back(predicate);
+                predicate_statistics[predicate].distinct_values.resize(atoms[i].get_arguments().size());
+            }
+        }
+        auto &distinct_values = static_distinct_values[adata.schema_index];
+        distinct_values.resize(atoms.size());
+        if (adata.statically_inapplicable)
+            continue;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            if (!is_fluent[i])
+                distinct_values[i] = count_distinct_values(adata.precompiled_db[i]);
+        }
+    }
+    plans.resize(action_data.size());
+    plan_switches.resize(action_data.size(), 0);
+    q_error_sums.resize(action_data.size(), 0);
+    number_estimates.resize(action_data.size(), 0);
+}
+
+vector<size_t> AdaptiveJoinSuccessorGenerator::count_distinct_values(const Table &table)
+{
+    vector<unordered_set<int>> values(table.arity());
+    for (size_t i = 0; i < table.size(); ++i) {
+        const int *tuple = table.row(i);
+        for (size_t j = 0; j < table.arity(); ++j)
+            values[j].insert(tuple[j]);
+    }
+    vector<size_t> distinct_values;
+    distinct_values.reserve(values.size());
+    for (const auto &column : values)
+        distinct_values.push_back(column.size());
+    return distinct_values;
+}
+
+bool AdaptiveJoinSuccessorGenerator::has_drifted(size_t size, size_t reference)
+{
+    double a = size + 1;
+    double b = reference + 1;
+    return a > DRIFT_FACTOR * b || b > DRIFT_FACTOR * a;
+}
+
+bool AdaptiveJoinSuccessorGenerator::has_drifted(const JoinPlan &plan,
+                                                 const PrecompiledActionData &adata,
+                                                 const vector<Table> &tables) const
+{
+    for (size_t i = 0; i < tables.size(); ++i) {
+        if (has_drifted(get_precondition_table(adata, tables, i).size(), plan.planned_sizes[i]))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Statistics are updated once per state, before the schemas are instantiated
+ * (possibly in parallel), so planning only reads them.
+ */
+void AdaptiveJoinSuccessorGenerator::update_statistics(const DBState &state)
+{
+    for (int predicate : fluent_predicates) {
+        PredicateStatistics &statistics = predicate_statistics[predicate];
+        const TupleSet &tuples = state.get_relations()[predicate].tuples;
+        statistics.cardinality = tuples.size();
+        if (statistics.counted && !has_drifted(statistics.cardinality, statistics.counted_cardinality))
+            continue;
+
+        vector<unordered_set<int>> values(statistics.distinct_values.size());
+        for (const auto &atom : tuples) {
+            for (size_t j = 0; j < values.size(); ++j)
+                values[j].insert(atom[j]);
+        }
+        for (size_t j = 0; j < values.size(); ++j)
+            statistics.distinct_values[j] = values[j].size();
+        statistics.counted = true;
+        statistics.counted_cardinality = statistics.cardinality;
+    }
+}
+
+vector<LiftedOperatorId> AdaptiveJoinSuccessorGenerator::get_applicable_actions(
+        const vector<ActionSchema> &actions, const DBState &state)
+{
+    update_statistics(state);
+    return GenericJoinSuccessor::get_applicable_actions(actions, state);
+}
+
+bool AdaptiveJoinSuccessorGenerator::prepare_schema_by_schema(const DBState &state)
+{
+    if (!GenericJoinSuccessor::prepare_schema_by_schema(state))
+        return false;
+    update_statistics(state);
+    return true;
+}
+
+JoinPlan AdaptiveJoinSuccessorGenerator::make_plan(const ActionSchema &action,
+                                                   const vector<Table> &tables) const
+{
+    const PrecompiledActionData &adata = action_data[action.get_index()];
+    size_t n = tables.size();
+    vector<bool> is_fluent(n, false);
+    for (unsigned i : adata.fluent_tables)
+        is_fluent[i] = true;
+
+    JoinPlan plan;
+    vector<TableEstimate> estimates(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Table &table = get_precondition_table(adata, tables, i);
+        estimates[i].size = table.size();
+        plan.planned_sizes.push_back(table.size());
+        int predicate = adata.relevant_precondition_atoms[i].get_predicate_symbol_idx();
+        const PredicateStatistics &statistics = predicate_statistics[predicate];
+        for (size_t j = 0; j < table.arity(); ++j) {
+            if (!table.index_is_variable(j))
+                continue;
+            double distinct;
+            if (!is_fluent[i])
+                distinct = static_distinct_values[action.get_index()][i][j];
+            else if (statistics.counted)
+                distinct = min<double>(table.size(), statistics.distinct_values[j]);
+            else
+                distinct = table.size();
+            auto it = estimates[i].distinct_values.find(table.tuple_index[j]);
+            if (it == estimates[i].distinct_values.end())
+                estimates[i].distinct_values.emplace(table.tuple_index[j], distinct);
+            else
+                it->second = min(it->second, distinct);
+        }
+    }
+
+    // Semi-joins removing at least half of the tuples of a table
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (i == j)
+                continue;
+            bool shares_variables = false;
+            double reduction = 1;
+            for (const auto &[variable, distinct] : estimates[i].distinct_values) {
+                auto it = estimates[j].distinct_values.find(variable);
+                if (it == estimates[j].distinct_values.end())
+                    continue;
+                shares_variables = true;
+                reduction *= min(1.0, it->second / max(distinct, 1.0));
+            }
+            // The removed tuples must pay for hashing the reducing table, and a
+            // semi-join cannot be expected to empty a table
+            if (!shares_variables || reduction > SEMI_JOIN_REDUCTION
+                || estimates[i].size * (1 - reduction) < max(estimates[j].size, 1.0))
+                continue;
+            plan.semi_joins.emplace_back(i, j);
+            estimates[i].size = max(estimates[i].size * reduction, 1.0);
+            for (auto &[variable, distinct] : estimates[i].distinct_values) {
+                auto it = estimates[j].distinct_values.find(variable);
+                if (it != estimates[j].distinct_values.end())
+                    distinct = min(distinct, it->second);
+                distinct = max(min(distinct, estimates[i].size), 1.0);
+            }
+        }
+    }
+
+    // Left-deep order minimizing the sum of the estimated intermediate sizes
+    if (n <= MAX_TABLES_EXHAUSTIVE) {
+        size_t number_subsets = size_t(1) << n;
+        vector<TableEstimate> subset_estimates(number_subsets);
+        vector<double> cost(number_subsets, 0);
+        vector<int> last_table(number_subsets, -1);
+        for (size_t i = 0; i < n; ++i) {
+            subset_estimates[size_t(1) << i] = estimates[i];
+            last_table[size_t(1) << i] = i;
+        }
+        for (size_t subset = 1; subset < number_subsets; ++subset) {
+            if (last_table[subset] != -1)
+                continue;
+            for (size_t i = 0; i < n; ++i) {
+                if (!(subset & (size_t(1) << i)))
+                    continue;
+                size_t rest = subset ^ (size_t(1) << i);
+                TableEstimate joined = estimate_join(subset_estimates[rest], estimates[i]);
+                double subset_cost = cost[rest] + joined.size;
+                if (last_table[subset] == -1 || subset_cost < cost[subset]) {
+                    cost[subset] = subset_cost;
+                    last_table[subset] = i;
+                    subset_estimates[subset] = std::move(joined);
+                }
+            }
+        }
+        for (size_t subset = number_subsets - 1; subset != 0;) {
+            plan.order.push_back(last_table[subset]);
+            subset ^= size_t(1) << last_table[subset];
+        }
+        reverse(plan.order.begin(), plan.order.end());
+    }
+    else {
+        vector<bool> joined(n, false);
+        size_t first = 0;
+        for (size_t i = 1; i < n; ++i) {
+            if (estimates[i].size < estimates[first].size)
+                first = i;
+        }
+        plan.order.push_back(first);
+        joined[first] = true;
+        TableEstimate current = estimates[first];
+        for (size_t k = 1; k < n; ++k) {
+            int next = -1;
+            TableEstimate best;
+            for (size_t i = 0; i < n; ++i) {
+                if (joined[i])
+                    continue;
+                TableEstimate candidate = estimate_join(current, estimates[i]);
+                if (next == -1 || candidate.size < best.size) {
+                    next = i;
+                    best = std::move(candidate);
+                }
+            }
+            plan.order.push_back(next);
+            joined[next] = true;
+            current = std::move(best);
+        }
+    }
+
+    TableEstimate current = estimates[plan.order[0]];
+    for (size_t k = 1; k < n; ++k) {
+        current = estimate_join(current, estimates[plan.order[k]]);
+        plan.estimated_sizes.push_back(current.size);
+    }
+    plan.valid = true;
+    return plan;
+}
+
+Table AdaptiveJoinSuccessorGenerator::instantiate(const ActionSchema &action, const DBState &state)
+{
+    if (action.is_ground()) {
+        throw std::runtime_error("Shouldn't be calling instantiate() on a ground action");
+    }
+
+    const PrecompiledActionData &adata = action_data[action.get_index()];
+    vector<Table> tables;
+    if (!parse_fluent_preconditions(adata, state, tables))
+        return Table::EMPTY_TABLE();
+
+    JoinPlan &plan = plans[action.get_index()];
+    if (!plan.valid || has_drifted(plan, adata, tables)) {
+        JoinPlan new_plan = make_plan(action, tables);
+        if (plan.valid && new_plan.has_same_operations(plan)) {
+            plan.planned_sizes = std::move(new_plan.planned_sizes);
+        }
+        else {
+            if (plan.valid)
+                ++plan_switches[action.get_index()];
+            plan = std::move(new_plan);
+        }
+    }
+
+    // Static tables are only copied if a semi-join reduces them, otherwise their index is probed
+    vector<bool> is_indexed(tables.size());
+    for (size_t i = 0; i < tables.size(); ++i)
+        is_indexed[i] = is_static_precondition(adata, i);
+    for (const auto &[reduced, reducer] : plan.semi_joins) {
+        if (is_indexed[reduced]) {
+            tables[reduced] = adata.precompiled_db[reduced];
+            is_indexed[reduced] = false;
+        }
+        size_t size = is_indexed[reducer]
+            ? semi_join_static_precondition(adata, reducer, tables[reduced])
+            : hash_semi_join(tables[reduced], tables[reducer]);
+        if (size == 0)
+            return Table::EMPTY_TABLE();
+    }
+
+    vector<size_t> actual_sizes;
+    JoinArena &arena = get_join_arena(action);
+    Table working_table = is_indexed[plan.order[0]]
+        ? adata.precompiled_db[plan.order[0]] : std::move(tables[plan.order[0]]);
+    for (size_t k = 1; k < plan.order.size(); ++k) {
+        if (is_indexed[plan.order[k]])
+            join_static_precondition(adata, plan.order[k], working_table, arena);
+        else
+            hash_join(working_table, tables[plan.order[k]], arena);
+        // Filter out equalities
+        filter_static(action, working_table);
+        actual_sizes.push_back(working_table.size());
+        if (working_table.empty())
+            break;
+    }
+    if (!plan.reported) {
+        if (!actual_sizes.empty())
+            report_plan(action, plan, actual_sizes);
+        plan.reported = true;
+    }
+    return working_table;
+}
+
+void AdaptiveJoinSuccessorGenerator::report_plan(const ActionSchema &action,
+                                                 const JoinPlan &plan,
+                                                 const vector<size_t> &actual_sizes)
+{
+    int index = action.get_index();
+    const vector<Atom> &atoms = action_data[index].relevant_precondition_atoms;
+    ostringstream message;
+    message << "Join plan " << plan_switches[index] << " of action schema " << action.get_name() << ":";
+    for (const auto &[reduced, reducer] : plan.semi_joins) {
+        message << " " << atoms[reduced].get_name() << "#" << reduced << " semi-join "
+                << atoms[reducer].get_name() << "#" << reducer << ",";
+    }
+    message << " join";
+    for (int i : plan.order)
+        message << " " << atoms[i].get_name() << "#" << i;
+    message << "; estimated/actual intermediate sizes:";
+    for (size_t k = 0; k < actual_sizes.size(); ++k) {
+        double estimated = plan.estimated_sizes[k];
+        double actual = actual_sizes[k];
+        message << " " << llround(estimated) << "/" << actual_sizes[k];
+        q_error_sums[index] += max(estimated + 1, actual + 1) / min(estimated + 1, actual + 1);
+        ++number_estimates[index];
+    }
+    message << endl;
+    // Schemas may be instantiated in parallel, so the line is written at once
+    cout << message.str();
+}
+
+void AdaptiveJoinSuccessorGenerator::print_statistics() const
+{
+    GenericJoinSuccessor::print_statistics();
+    int switches = 0;
+    int estimates = 0;
+    double q_error_sum = 0;
+    for (size_t i = 0; i < plans.size(); ++i) {
+        switches += plan_switches[i];
+        estimates += number_estimates[i];
+        q_error_sum += q_error_sums[i];
+    }
+    cout << "Join plan switches: " << switches << endl;
+    if (estimates > 0) {
+        cout << "Mean q-error of the estimated intermediate sizes: " << q_error_sum / estimates << endl;
+    }
+}
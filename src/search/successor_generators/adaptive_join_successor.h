@@ -0,0 +1,128 @@
+#ifndef SEARCH_ADAPTIVE_JOIN_SUCCESSOR_H
+#define SEARCH_ADAPTIVE_JOIN_SUCCESSOR_H
+
+#include "generic_join_successor.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Statistics of the relation of a fluent predicate in the states
+ * being expanded.
+ *
+ * @var cardinality: Number of tuples in the last expanded state.
+ * @var distinct_values: Number of distinct objects at each argument position,
+ * counted when the cardinality was `counted_cardinality`.
+ */
+struct PredicateStatistics {
+    std::size_t cardinality = 0;
+    std::size_t counted_cardinality = 0;
+    bool counted = false;
+    std::vector<std::size_t> distinct_values;
+};
+
+
+/**
+ * @brief Join plan of an action schema: semi-joins reducing the tables of the
+ * preconditions, followed by a left-deep join in the given order.
+ *
+ * @var semi_joins: Pairs (reduced table, reducing table), applied in order.
+ * @var order: Order in which the tables are joined.
+ * @var estimated_sizes: Estimated size of the result of each join.
+ * @var planned_sizes: Sizes of the tables the plan was made for.
+ */
+struct JoinPlan {
+    std::vector<std::pair<int, int>> semi_joins;
+    std::vector<int> order;
+    std::vector<double> estimated_sizes;
+    std::vector<std::size_t> planned_sizes;
+    bool valid = false;
+    bool reported = false;
+
+    bool has_same_operations(const JoinPlan &other) const {
+        return semi_joins == other.semi_joins && order == other.order;
+    }
+};
+
+
+/**
+ * @brief Successor generator choosing the join plan of each schema with a
+ * cost model over live statistics of the states.
+ *
+ * @details Before a state is instantiated, the cardinality of each fluent
+ * predicate in it is recorded, and the number of distinct values at each
+ * argument position is counted again if the cardinality drifted by more than
+ * a factor of DRIFT_FACTOR since the last count. Distinct values of the static
+ * tables are counted once.
+ *
+ * The plan of a schema is cached and only made again when the size of one of
+ * its tables in the current state drifted by more than DRIFT_FACTOR from the
+ * size the plan was made for. Planning estimates the size of a join with the
+ * usual independence assumption, |R join S| = |R| |S| / prod_v max(V(R, v),
+ * V(S, v)) over the shared variables v, and picks the left-deep order with
+ * the smallest sum of intermediate sizes (by dynamic programming over subsets
+ * of tables, or greedily for schemas with many preconditions). Before the
+ * join, a table is reduced by a semi-join with another one if this is
+ * estimated to remove at least half of its tuples, and more tuples than the
+ * other table has.
+ *
+ * When the operations of the plan of a schema change, the switch is logged
+ * together with the estimated and the actual sizes of the intermediate
+ * results of its first execution.
+ */
+class AdaptiveJoinSuccessorGenerator : public GenericJoinSuccessor {
+public:
+    explicit AdaptiveJoinSuccessorGenerator(const Task &task);
+
+    std::vector<LiftedOperatorId> get_applicable_actions(
+            const std::vector<ActionSchema> &actions, const DBState &state) override;
+
+    using GenericJoinSuccessor::get_applicable_actions;
+
+    bool prepare_schema_by_schema(const DBState &state) override;
+
+    Table instantiate(const ActionSchema &action, const DBState &state) override;
+
+    void print_statistics() const override;
+
+private:
+    static constexpr double DRIFT_FACTOR = 2.0;
+    static constexpr double SEMI_JOIN_REDUCTION = 0.5;
+    static constexpr std::size_t MAX_TABLES_EXHAUSTIVE = 10;
+
+    //! Indexed by predicate index; empty for predicates of no fluent precondition
+    std::vector<PredicateStatistics> predicate_statistics;
+    std::vector<int> fluent_predicates;
+
+    //! Distinct values of each column of the static tables, indexed by schema
+    //! index and precondition
+    std::vector<std::vector<std::vector<std::size_t>>> static_distinct_values;
+
+    //! Indexed by schema index
+    std::vector<JoinPlan> plans;
+    std::vector<int> plan_switches;
+
+    //! Sum and number of the q-errors of the estimated sizes in the reported
+    //! executions, indexed by schema index
+    std::vector<double> q_error_sums;
+    std::vector<int> number_estimates;
+
+    void update_statistics(const DBState &state);
+
+    bool has_drifted(const JoinPlan &plan,
+                     const PrecompiledActionData &adata,
+                     const std::vector<Table> &tables) const;
+
+    JoinPlan make_plan(const ActionSchema &action, const std::vector<Table> &tables) const;
+
+    void report_plan(const ActionSchema &action,
+                     const JoinPlan &plan,
+                     const std::vector<std::size_t> &actual_sizes);
+
+    static bool has_drifted(std::size_t size, std::size_t reference);
+
+    static std::vector<std::size_t> count_distinct_values(const Table &table);
+};
+
+#endif //SEARCH_ADAPTIVE_JOIN_SUCCESSOR_H
@@ -0,0 +1,37 @@
+#include "applicable_action_iterator.h"
+
+#include "successor_generator.h"
+
+#include "../action_schema.h"
+
+using namespace std;
+
+ApplicableActionIterator::ApplicableActionIterator(SuccessorGenerator &generator,
+                                                   const vector<ActionSchema> &actions,
+                                                   const DBState &state)
+    : generator(generator), actions(actions), state(state), next_schema(0), position(0), num_returned(0)
+{
+    if (!generator.prepare_schema_by_schema(state)) {
+        applicable = generator.get_applicable_actions(actions, state);
+        next_schema = actions.size();
+    }
+}
+
+bool ApplicableActionIterator::done()
+{
+    while (position == applicable.size()) {
+        if (next_schema == actions.size())
+            return true;
+        applicable = generator.get_applicable_actions_of_schema(actions[next_schema++], state);
+        position = 0;
+    }
+    return false;
+}
+
+const LiftedOperatorId *ApplicableActionIterator::next()
+{
+    if (done())
+        return nullptr;
+    ++num_returned;
+    return &applicable[position++];
+}
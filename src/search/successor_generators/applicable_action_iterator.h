@@ -0,0 +1,60 @@
+#ifndef SEARCH_APPLICABLE_ACTION_ITERATOR_H
+#define SEARCH_APPLICABLE_ACTION_ITERATOR_H
+
+#include "../action.h"
+
+#include <cstddef>
+#include <vector>
+
+class ActionSchema;
+class DBState;
+class SuccessorGenerator;
+
+/**
+ * @brief Enumerates the applicable actions of a state one at a time, in the
+ * order of SuccessorGenerator::get_applicable_actions(actions, state).
+ *
+ * @details The action schemas are instantiated one after the other, each when
+ * all instantiations of the previous ones have been returned, so a search that
+ * stops the expansion of a state early does not instantiate the remaining
+ * schemas. Generators that only instantiate all schemas at once (see
+ * SuccessorGenerator::prepare_schema_by_schema) return all applicable actions
+ * when the iterator is created.
+ *
+ * The generator, the schemas and the state must outlive the iterator. The
+ * generator may generate successors while the iterator is used, but must not
+ * be asked for the applicable actions of another state.
+ */
+class ApplicableActionIterator {
+    SuccessorGenerator &generator;
+    const std::vector<ActionSchema> &actions;
+    const DBState &state;
+
+    std::size_t next_schema;
+    std::vector<LiftedOperatorId> applicable;
+    std::size_t position;
+    std::size_t num_returned;
+
+public:
+    ApplicableActionIterator(SuccessorGenerator &generator,
+                             const std::vector<ActionSchema> &actions,
+                             const DBState &state);
+
+    /**
+     * @return the next applicable action, or nullptr once all of them have
+     * been returned. The action is valid until the next call.
+     */
+    const LiftedOperatorId *next();
+
+    /**
+     * @return true if all applicable actions have been returned. The
+     * remaining schemas are instantiated until one has applicable actions.
+     */
+    bool done();
+
+    std::size_t get_num_returned() const {
+        return num_returned;
+    }
+};
+
+#endif //SEARCH_APPLICABLE_ACTION_ITERATOR_H
@@ -17,6 +17,36 @@
 
 using namespace std;
 
+// Number of expanded states whose successors are recognized in incremental mode
+static const size_t INCREMENTAL_CACHE_CAPACITY = 1024;
+
+/*
+ * Call f with the rank of every (partial) assignment the atom is compatible
+ * with, i.e., the rank of each of its positions and of each pair of them.
+ */
+template<typename F>
+static void for_each_assignment_rank(const GroundAtom &atom,
+                                     int predicate_arity,
+                                     int num_objects,
+                                     const F &f) {
+    for (size_t first_position = 0; first_position < atom.size(); ++first_position) {
+        const auto first_object = atom[first_position];
+
+        f(get_rank(first_position, first_object, -1, -1, predicate_arity, num_objects));
+
+        for (size_t second_position = first_position + 1; second_position < atom.size();
+             ++second_position) {
+            const auto second_object = atom[second_position];
+            f(get_rank(first_position,
+                       first_object,
+                       second_position,
+                       second_object,
+                       predicate_arity,
+                       num_objects));
+        }
+    }
+}
+
 bool CliqueSuccessorGenerator::consistent_literals(const vector<Atom> &literals,
                                                    const Assignment &first_assignment,
                                                    const Assignment &second_assignment) {
@@ -169,32 +199,197 @@ void CliqueSuccessorGenerator::build_assignment_sets(const DBState &atoms) {
         assignment_set.resize(total_ranks(predicate_arity, num_objects));
 
         for (const auto &atom : relation.tuples) {
-            for (size_t first_position = 0; first_position < atom.size(); ++first_position) {
-                const auto first_object = atom[first_position];
-
-                assignment_set[get_rank(
-                    first_position, first_object, -1, -1, predicate_arity, num_objects)] = true;
-
-                for (size_t second_position = first_position + 1; second_position < atom.size();
-                     ++second_position) {
-                    const auto second_object = atom[second_position];
-                    assignment_set[get_rank(
-                        second_position, second_object, -1, -1, predicate_arity, num_objects)] =
-                        true;
-                    assignment_set[get_rank(first_position,
-                                            first_object,
-                                            second_position,
-                                            second_object,
-                                            predicate_arity,
-                                            num_objects)] = true;
+            for_each_assignment_rank(atom, predicate_arity, num_objects, [&](size_t rank) {
+                assignment_set[rank] = true;
+            });
+        }
+    }
+}
+
+/**
+ * @brief Rebuilds the assignment sets of the relevant predicates, counting
+ * the atoms of the state compatible with each assignment.
+ */
+void CliqueSuccessorGenerator::build_assignment_counts(const DBState &state) {
+    const auto num_objects = task.objects.size();
+
+    for (const auto &relation : state.get_relations()) {
+        const auto predicate = relation.predicate_symbol;
+        if (!incremental_cache->is_relevant(predicate)) {
+            continue;
+        }
+
+        const auto predicate_arity = task.predicates[predicate].getArity();
+        auto &assignment_set = assignment_sets[predicate];
+        auto &counts = assignment_counts[predicate];
+        assignment_set.assign(total_ranks(predicate_arity, num_objects), false);
+        counts.clear();
+        ++assignment_set_versions[predicate];
+
+        for (const auto &atom : relation.tuples) {
+            for_each_assignment_rank(atom, predicate_arity, num_objects, [&](size_t rank) {
+                if (counts[rank]++ == 0) {
+                    assignment_set[rank] = true;
                 }
+            });
+        }
+    }
+    ++assignment_sets_from_scratch;
+}
+
+void CliqueSuccessorGenerator::update_assignment_counts(int predicate,
+                                                        const GroundAtom &atom,
+                                                        bool is_added) {
+    const auto num_objects = task.objects.size();
+    const auto predicate_arity = task.predicates[predicate].getArity();
+    auto &assignment_set = assignment_sets[predicate];
+    auto &counts = assignment_counts[predicate];
+
+    for_each_assignment_rank(atom, predicate_arity, num_objects, [&](size_t rank) {
+        if (is_added) {
+            if (counts[rank]++ == 0) {
+                assignment_set[rank] = true;
+                ++assignment_set_versions[predicate];
             }
         }
+        else {
+            auto it = counts.find(rank);
+            assert(it != counts.end() && it->second > 0);
+            if (--it->second == 0) {
+                counts.erase(it);
+                assignment_set[rank] = false;
+                ++assignment_set_versions[predicate];
+            }
+        }
+    });
+}
+
+/**
+ * @brief Brings the assignment sets to the given state, from those of the
+ * last expanded state if the state is one of its successors, or of one of its
+ * siblings, and from scratch otherwise.
+ */
+void CliqueSuccessorGenerator::update_assignment_sets_incrementally(const DBState &state) {
+    const uint64_t hash = incremental_cache->hash_state(state);
+    const IncrementalSuccessorCache::Delta *delta = incremental_cache->find_delta(state, hash);
+
+    /*
+     * Both pointers are compared before the new state is inserted, so the
+     * parent of the delta is alive. assignment_sets_state is the last inserted
+     * state, which is alive as well; assignment_sets_parent may have been
+     * evicted since, but no state has been allocated after it was, so its
+     * address cannot belong to the parent of the delta.
+     */
+    if (delta && assignment_sets_state && delta->parent == assignment_sets_state) {
+        for (const auto &[predicate, atom] : delta->deleted) {
+            update_assignment_counts(predicate, atom, false);
+        }
+        for (const auto &[predicate, atom] : delta->added) {
+            update_assignment_counts(predicate, atom, true);
+        }
+        ++assignment_sets_from_delta;
+    }
+    else if (delta && assignment_sets_parent && delta->parent == assignment_sets_parent) {
+        /*
+         * Go back from the sibling to the parent, and then to the state. Atoms
+         * added or deleted by both are left alone, so the assignment sets they
+         * belong to keep their version, and so do the cliques depending on them.
+         */
+        auto contains = [](const vector<pair<int, GroundAtom>> &atoms, int predicate, const GroundAtom &atom) {
+            return find(atoms.begin(), atoms.end(), make_pair(predicate, atom)) != atoms.end();
+        };
+        for (const auto &[predicate, atom] : assignment_sets_added) {
+            if (!contains(delta->added, predicate, atom))
+                update_assignment_counts(predicate, atom, false);
+        }
+        for (const auto &[predicate, atom] : assignment_sets_deleted) {
+            if (!contains(delta->deleted, predicate, atom))
+                update_assignment_counts(predicate, atom, true);
+        }
+        for (const auto &[predicate, atom] : delta->deleted) {
+            if (!contains(assignment_sets_deleted, predicate, atom))
+                update_assignment_counts(predicate, atom, false);
+        }
+        for (const auto &[predicate, atom] : delta->added) {
+            if (!contains(assignment_sets_added, predicate, atom))
+                update_assignment_counts(predicate, atom, true);
+        }
+        ++assignment_sets_from_delta;
+    }
+    else {
+        build_assignment_counts(state);
+    }
+
+    if (delta) {
+        assignment_sets_parent = delta->parent;
+        assignment_sets_added = delta->added;
+        assignment_sets_deleted = delta->deleted;
+    }
+    else {
+        assignment_sets_parent = nullptr;
+        assignment_sets_added.clear();
+        assignment_sets_deleted.clear();
+    }
+
+    auto expanded = std::make_unique<IncrementalSuccessorCache::ExpandedState>(state, hash, 0);
+    assignment_sets_state = expanded.get();
+    incremental_cache->insert(std::move(expanded));
+}
+
+vector<uint64_t> CliqueSuccessorGenerator::get_assignment_set_versions(const Precondition &preconds) const {
+    vector<uint64_t> versions;
+    versions.reserve(preconds.dynamic_preconds.size());
+    for (const auto &literal : preconds.dynamic_preconds) {
+        versions.push_back(assignment_set_versions[literal.get_predicate_symbol_idx()]);
+    }
+    return versions;
+}
+
+void CliqueSuccessorGenerator::set_incremental(bool incremental) {
+    assignment_sets_state = nullptr;
+    assignment_sets_parent = nullptr;
+    assignment_sets_added.clear();
+    assignment_sets_deleted.clear();
+    cached_cliques.clear();
+    if (!incremental) {
+        incremental_cache.reset();
+        return;
+    }
+
+    // Only the assignment sets of dynamic preconditions are tested during the search
+    const auto num_predicates = task.predicates.size();
+    vector<bool> relevant_predicates(num_predicates, false);
+    for (const auto &[action, preconds] : action_precondition) {
+        for (const auto &literal : preconds.dynamic_preconds) {
+            relevant_predicates[literal.get_predicate_symbol_idx()] = true;
+        }
+    }
+    incremental_cache = std::make_unique<IncrementalSuccessorCache>(
+        std::move(relevant_predicates), INCREMENTAL_CACHE_CAPACITY);
+
+    if (assignment_sets.size() < num_predicates) {
+        assignment_sets.resize(num_predicates);
     }
+    assignment_counts.resize(num_predicates);
+    assignment_set_versions.assign(num_predicates, 0);
+    cached_cliques.resize(task.get_action_schemas().size());
 }
 
-CliqueSuccessorGenerator::CliqueSuccessorGenerator(const Task &task, const CliquePivot &pivot)
-    : task(task), pivot(pivot) {
+void CliqueSuccessorGenerator::print_statistics() const {
+    if (!incremental_cache) {
+        return;
+    }
+    incremental_cache->print_statistics();
+    cout << "Assignment sets updated from the parent state: " << assignment_sets_from_delta << endl;
+    cout << "Assignment sets built from scratch: " << assignment_sets_from_scratch << endl;
+    cout << "Cliques reused from an earlier state: " << reused_cliques << endl;
+}
+
+CliqueSuccessorGenerator::CliqueSuccessorGenerator(const Task &task, const CliquePivot &pivot, unsigned num_threads)
+    : task(task), pivot(pivot), k_partite_clique_enumerator(pivot == KCliqueKPartite ? num_threads : 1),
+      assignment_sets_state(nullptr), assignment_sets_parent(nullptr),
+      has_built_assignment_sets(false), assignment_sets_from_delta(0), assignment_sets_from_scratch(0),
+      reused_cliques(0) {
     // Types are static information, precompute the set of object that
     // can be assigned to each parameter based on type information.
 
@@ -392,18 +587,13 @@ vector<uint32_t> CliqueSuccessorGenerator::create_adjacency_list(const Precondit
     return vertex_ids;
 }
 
-void CliqueSuccessorGenerator::create_adjacency_matrix(const Precondition &preconds,
-                                                       const std::vector<AssignmentPair> &statically_consistent_assignments,
-                                                       std::size_t num_parameters,
-                                                       std::size_t num_vertices,
-                                                       std::vector<boost::dynamic_bitset<>> &adjacency_matrix) {
+void CliqueSuccessorGenerator::create_k_partite_graph(const Precondition &preconds,
+                                                     const std::vector<AssignmentPair> &statically_consistent_assignments,
+                                                     algorithms::KPartiteGraph &graph) {
     for (const auto &pair : statically_consistent_assignments) {
         if (consistent_literals(
                 preconds.dynamic_preconds, pair.first_assignment, pair.second_assignment)) {
-            auto &first_row = adjacency_matrix[pair.first_position];
-            auto &second_row = adjacency_matrix[pair.second_position];
-            first_row[pair.second_position] = 1;
-            second_row[pair.first_position] = 1;
+            graph.add_edge(pair.first_position, pair.second_position);
         }
     }
 }
@@ -425,71 +615,85 @@ vector<LiftedOperatorId> CliqueSuccessorGenerator::applicable_actions_general_ca
     const auto &statically_consistent_assignments =
         action_statically_consistent_assignments.find(action)->second;
 
-    vector<vector<uint32_t>> cliques;
-
-    if (num_parameters == 2) {
-        for (const auto &pair : statically_consistent_assignments) {
-            if (consistent_literals(
-                    preconds.dynamic_preconds, pair.first_assignment, pair.second_assignment)) {
-                cliques.push_back(std::vector<uint32_t>(
-                    {(uint32_t)pair.first_position, (uint32_t)pair.second_position}));
-            }
+    /*
+     * The cliques only depend on the assignment sets of the dynamic
+     * preconditions, so in incremental mode they are found again only if one
+     * of these sets changed since the last state the schema was instantiated
+     * in, e.g., a sibling of the state.
+     */
+    vector<vector<uint32_t>> computed;
+    bool reuse_cliques = false;
+    if (incremental_cache) {
+        auto &cached = cached_cliques[action.get_index()];
+        auto versions = get_assignment_set_versions(preconds);
+        reuse_cliques = cached.valid && (cached.versions == versions);
+        if (!reuse_cliques) {
+            cached.cliques.clear();
+            cached.versions = std::move(versions);
+            cached.valid = true;
+        }
+        else {
+            ++reused_cliques;
         }
     }
-    else {
-        switch (pivot) {
-        case BronKerboschFirst: {
-            const auto num_vertices = to_vertex_assignment.size();
-            vector<uint32_t> adjacency_list[num_vertices];
-            const auto vertex_ids = create_adjacency_list(preconds,
-                                                          statically_consistent_assignments,
-                                                          num_parameters,
-                                                          adjacency_list,
-                                                          num_vertices);
-            bron_kerbosch_first_pivot(adjacency_list, vertex_ids, num_parameters, cliques);
-            break;
-        }
-
-        case BronKerboschMaxNeighborhood: {
-            const auto num_vertices = to_vertex_assignment.size();
-            vector<uint32_t> adjacency_list[num_vertices];
-            const auto vertex_ids = create_adjacency_list(preconds,
-                                                          statically_consistent_assignments,
-                                                          num_parameters,
-                                                          adjacency_list,
-                                                          num_vertices);
-            bron_kerbosch_max_neighborhood_pivot(
-                adjacency_list, vertex_ids, num_parameters, cliques);
-            break;
-        }
-
-        case BronKerboschMinDifference: {
-            const auto num_vertices = to_vertex_assignment.size();
-            vector<uint32_t> adjacency_list[num_vertices];
-            const auto vertex_ids = create_adjacency_list(preconds,
-                                                          statically_consistent_assignments,
-                                                          num_parameters,
-                                                          adjacency_list,
-                                                          num_vertices);
-            bron_kerbosch_min_difference_pivot(adjacency_list, vertex_ids, num_parameters, cliques);
-            break;
-        }
-
-        case KCliqueKPartite: {
-            const auto num_vertices = to_vertex_assignment.size();
-            std::vector<boost::dynamic_bitset<>> adjacency_matrix(
-                num_vertices, boost::dynamic_bitset<>(num_vertices));
-            create_adjacency_matrix(preconds,
-                                    statically_consistent_assignments,
-                                    num_parameters,
-                                    num_vertices,
-                                    adjacency_matrix);
-
-            const auto &partitions = action_partitions.at(action);
-            algorithms::find_all_k_cliques_in_k_partite_graph(
-                adjacency_matrix, partitions, cliques);
-            break;
+    auto &cliques = incremental_cache ? cached_cliques[action.get_index()].cliques : computed;
+
+    if (!reuse_cliques) {
+        if (num_parameters == 2) {
+            for (const auto &pair : statically_consistent_assignments) {
+                if (consistent_literals(
+                        preconds.dynamic_preconds, pair.first_assignment, pair.second_assignment)) {
+                    cliques.push_back(std::vector<uint32_t>(
+                        {(uint32_t)pair.first_position, (uint32_t)pair.second_position}));
+                }
+            }
         }
+        else {
+            switch (pivot) {
+            case BronKerboschFirst: {
+                const auto num_vertices = to_vertex_assignment.size();
+                vector<uint32_t> adjacency_list[num_vertices];
+                const auto vertex_ids = create_adjacency_list(preconds,
+                                                              statically_consistent_assignments,
+                                                              num_parameters,
+                                                              adjacency_list,
+                                                              num_vertices);
+                bron_kerbosch_first_pivot(adjacency_list, vertex_ids, num_parameters, cliques);
+                break;
+            }
+
+            case BronKerboschMaxNeighborhood: {
+                const auto num_vertices = to_vertex_assignment.size();
+                vector<uint32_t> adjacency_list[num_vertices];
+                const auto vertex_ids = create_adjacency_list(preconds,
+                                                              statically_consistent_assignments,
+                                                              num_parameters,
+                                                              adjacency_list,
+                                                              num_vertices);
+                bron_kerbosch_max_neighborhood_pivot(
+                    adjacency_list, vertex_ids, num_parameters, cliques);
+                break;
+            }
+
+            case BronKerboschMinDifference: {
+                const auto num_vertices = to_vertex_assignment.size();
+                vector<uint32_t> adjacency_list[num_vertices];
+                const auto vertex_ids = create_adjacency_list(preconds,
+                                                              statically_consistent_assignments,
+                                                              num_parameters,
+                                                              adjacency_list,
+                                                              num_vertices);
+                bron_kerbosch_min_difference_pivot(adjacency_list, vertex_ids, num_parameters, cliques);
+                break;
+            }
+
+            case KCliqueKPartite: {
+                algorithms::KPartiteGraph graph(action_partitions.at(action));
+                create_k_partite_graph(preconds, statically_consistent_assignments, graph);
+                k_partite_clique_enumerator.find_all_cliques(graph, cliques);
+                break;
+            }
+            }
         }
     }
 
@@ -521,38 +725,50 @@ vector<LiftedOperatorId> CliqueSuccessorGenerator::applicable_actions_general_ca
     return applicable_actions;
 }
 
-std::vector<LiftedOperatorId>
-CliqueSuccessorGenerator::get_applicable_actions(const std::vector<ActionSchema> &actions,
-                                                 const DBState &state) {
-    std::vector<LiftedOperatorId> all_applicable;
-    bool has_built_assignment_sets = false;
+bool CliqueSuccessorGenerator::prepare_schema_by_schema(const DBState &state) {
+    // Without incremental successors, the assignment sets are only built if some schema needs them
+    has_built_assignment_sets = false;
+    if (incremental_cache) {
+        update_assignment_sets_incrementally(state);
+        has_built_assignment_sets = true;
+    }
+    return true;
+}
 
-    for (const auto &action : actions) {
-        if (!test_nullary_preconditions(action, state)) {
-            continue;
-        }
+vector<LiftedOperatorId>
+CliqueSuccessorGenerator::get_applicable_actions_of_schema(const ActionSchema &action,
+                                                           const DBState &state) {
+    if (!test_nullary_preconditions(action, state)) {
+        return vector<LiftedOperatorId>();
+    }
 
-        const auto &action_parameters = action.get_parameters();
-        const auto num_parameters = action_parameters.size();
+    const auto &action_parameters = action.get_parameters();
+    const auto num_parameters = action_parameters.size();
 
-        if (num_parameters == 0) {
-            const auto &applicable = applicable_actions_nullary_case(action, state);
-            all_applicable.insert(all_applicable.end(), applicable.begin(), applicable.end());
-        }
-        else if (num_parameters == 1) {
-            const auto &applicable = applicable_actions_unary_case(action, state);
-            all_applicable.insert(all_applicable.end(), applicable.begin(), applicable.end());
+    if (num_parameters == 0) {
+        return applicable_actions_nullary_case(action, state);
+    }
+    else if (num_parameters == 1) {
+        return applicable_actions_unary_case(action, state);
+    }
+    else {
+        if (!has_built_assignment_sets) {
+            build_assignment_sets(state);
+            has_built_assignment_sets = true;
         }
-        else {
+        return applicable_actions_general_case(action, state);
+    }
+}
 
-            if (!has_built_assignment_sets) {
-                build_assignment_sets(state);
-                has_built_assignment_sets = true;
-            }
+std::vector<LiftedOperatorId>
+CliqueSuccessorGenerator::get_applicable_actions(const std::vector<ActionSchema> &actions,
+                                                 const DBState &state) {
+    std::vector<LiftedOperatorId> all_applicable;
+    prepare_schema_by_schema(state);
 
-            const auto &applicable = applicable_actions_general_case(action, state);
-            all_applicable.insert(all_applicable.end(), applicable.begin(), applicable.end());
-        }
+    for (const auto &action : actions) {
+        const auto &applicable = get_applicable_actions_of_schema(action, state);
+        all_applicable.insert(all_applicable.end(), applicable.begin(), applicable.end());
     }
 
     return all_applicable;
@@ -573,6 +789,13 @@ CliqueSuccessorGenerator::get_applicable_actions(const ActionSchema &action, con
     else if (num_parameters == 1) {
         return applicable_actions_unary_case(action, state);
     }
+    else if (incremental_cache) {
+        // The state is not recorded as expanded, so the next one is built from scratch
+        build_assignment_counts(state);
+        assignment_sets_state = nullptr;
+        assignment_sets_parent = nullptr;
+        return applicable_actions_general_case(action, state);
+    }
     else {
         build_assignment_sets(state);
         return applicable_actions_general_case(action, state);
@@ -1,16 +1,20 @@
 #ifndef SEARCH_CLIQUE_H
 #define SEARCH_CLIQUE_H
 
+#include "incremental_successor_cache.h"
 #include "successor_generator.h"
 
 #include "../action.h"
+#include "../algorithms/kpkc.h"
 #include "../action_schema.h"
 #include "../states/state.h"
 #include "../task.h"
+#include "../parallel_hashmap/phmap.h"
 
 #include <algorithm>
 #include <boost/dynamic_bitset.hpp>
 #include <map>
+#include <memory>
 #include <set>
 #include <unordered_map>
 #include <vector>
@@ -98,6 +102,9 @@ enum CliquePivot {
 };
 
 class CliqueSuccessorGenerator : public SuccessorGenerator {
+    // Reads the k-partite graphs of the action schemas in benchmarks/kpkc_benchmark.cc
+    friend class CliqueGraphCollector;
+
 private:
     const Task &task;
     const CliquePivot pivot;
@@ -110,8 +117,56 @@ private:
     // Cache certain data-structures to avoid dynamic allocations
     std::vector<std::vector<bool>> assignment_sets;
 
+    algorithms::KPartiteCliqueEnumerator k_partite_clique_enumerator;
+
+    /*
+      Cliques of the graph of an action schema, and the versions of the
+      assignment sets of its dynamic preconditions they were found with.
+    */
+    struct CachedCliques {
+        bool valid = false;
+        std::vector<std::uint64_t> versions;
+        std::vector<std::vector<uint32_t>> cliques;
+    };
+
+    // The members below are only used with incremental successors
+    std::unique_ptr<IncrementalSuccessorCache> incremental_cache;
+
+    // Number of atoms of the state having each assignment, indexed by predicate and rank
+    std::vector<phmap::flat_hash_map<std::size_t, std::uint32_t>> assignment_counts;
+
+    // Incremented whenever an assignment is added to or removed from the set of a predicate
+    std::vector<std::uint64_t> assignment_set_versions;
+
+    // Indexed by schema index
+    std::vector<CachedCliques> cached_cliques;
+
+    // State the assignment sets correspond to, its parent, and the changes from the parent
+    const IncrementalSuccessorCache::ExpandedState *assignment_sets_state;
+    const IncrementalSuccessorCache::ExpandedState *assignment_sets_parent;
+    std::vector<std::pair<int, GroundAtom>> assignment_sets_added;
+    std::vector<std::pair<int, GroundAtom>> assignment_sets_deleted;
+
+    // Whether the assignment sets are those of the state being instantiated schema by schema
+    bool has_built_assignment_sets;
+
+    // Atoms removed from the state by the last generated successor
+    std::vector<std::pair<int, GroundAtom>> deleted_atoms;
+
+    std::size_t assignment_sets_from_delta;
+    std::size_t assignment_sets_from_scratch;
+    std::size_t reused_cliques;
+
     void build_assignment_sets(const DBState &atoms);
 
+    void build_assignment_counts(const DBState &state);
+
+    void update_assignment_counts(int predicate, const GroundAtom &atom, bool is_added);
+
+    void update_assignment_sets_incrementally(const DBState &state);
+
+    std::vector<std::uint64_t> get_assignment_set_versions(const Precondition &preconds) const;
+
     bool consistent_literals(const std::vector<Atom> &literals,
                              const Assignment &first_assignment,
                              const Assignment &second_assignment);
@@ -126,11 +181,9 @@ private:
                                                 std::vector<uint32_t> *adjacency_list,
                                                 std::size_t num_vertices);
 
-    void create_adjacency_matrix(const Precondition &preconds,
-                                 const std::vector<AssignmentPair> &statically_consistent_assignments,
-                                 std::size_t num_parameters,
-                                 std::size_t num_vertices,
-                                 std::vector<boost::dynamic_bitset<>> &adjacency_matrix);
+    void create_k_partite_graph(const Precondition &preconds,
+                               const std::vector<AssignmentPair> &statically_consistent_assignments,
+                               algorithms::KPartiteGraph &graph);
 
     std::vector<LiftedOperatorId> applicable_actions_nullary_case(const ActionSchema &action,
                                                                   const DBState &state);
@@ -142,7 +195,24 @@ private:
                                                                   const DBState &state);
 
 public:
-    explicit CliqueSuccessorGenerator(const Task &task, const CliquePivot &pivot);
+    /*
+      With KCliqueKPartite, the branches of the clique search are split over
+      num_threads threads.
+    */
+    CliqueSuccessorGenerator(const Task &task, const CliquePivot &pivot, unsigned num_threads = 1);
+
+    /*
+      Update the assignment sets from those of the parent state (or of a
+      sibling) when the state is a successor of one of the recently expanded
+      states. The assignment sets then count the atoms having each
+      assignment, and the atoms added and deleted by the action are added to
+      and removed from these counts. The cliques of an action schema are
+      reused as long as the assignment sets of its dynamic preconditions did
+      not change.
+
+      @see incremental_successor_cache.h
+    */
+    void set_incremental(bool incremental);
 
     std::vector<LiftedOperatorId> get_applicable_actions(const std::vector<ActionSchema> &actions,
                                                          const DBState &state) override;
@@ -150,6 +220,11 @@ public:
     std::vector<LiftedOperatorId> get_applicable_actions(const ActionSchema &action,
                                                          const DBState &state) override;
 
+    bool prepare_schema_by_schema(const DBState &state) override;
+
+    std::vector<LiftedOperatorId> get_applicable_actions_of_schema(const ActionSchema &action,
+                                                                   const DBState &state) override;
+
     const GroundAtom tuple_to_atom(const std::vector<int> &tuple, const Atom &eff);
 
     void apply_nullary_effects(const ActionSchema &action, std::vector<bool> &new_nullary_atoms);
@@ -164,6 +239,8 @@ public:
     DBState generate_successor(const LiftedOperatorId &op,
                                const ActionSchema &action,
                                const DBState &state) override;
+
+    void print_statistics() const override;
 };
 
 #endif  // SEARCH_CLIQUE_H
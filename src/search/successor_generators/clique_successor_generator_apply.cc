@@ -48,13 +48,14 @@ void CliqueSuccessorGenerator::apply_ground_action_effects(const ActionSchema &a
 
         if (eff.is_negated()) {
             // If ground effect is negated, remove it from relation
-            new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga);
+            if (new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga) > 0) {
+                deleted_atoms.emplace_back(eff.get_predicate_symbol_idx(), ga);
+            }
         }
         else {
             // If ground effect is not in the state, we add it
-
-            new_relation[eff.get_predicate_symbol_idx()].tuples.insert(ga);
-            add_to_added_atoms(eff.get_predicate_symbol_idx(), ga);
+            if (new_relation[eff.get_predicate_symbol_idx()].tuples.insert(ga).second)
+                add_to_added_atoms(eff.get_predicate_symbol_idx(), ga);
         }
     }
 }
@@ -86,16 +87,15 @@ void CliqueSuccessorGenerator::apply_lifted_action_effects(const ActionSchema &a
                new_relation[eff.get_predicate_symbol_idx()].predicate_symbol);
         if (eff.is_negated()) {
             // Remove from relation
-            new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga);
+            if (new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga) > 0) {
+                deleted_atoms.emplace_back(eff.get_predicate_symbol_idx(), std::move(ga));
+            }
         }
         else {
             int predicate_symbol_idx = eff.get_predicate_symbol_idx();
-            if (find(new_relation[predicate_symbol_idx].tuples.begin(),
-                     new_relation[predicate_symbol_idx].tuples.end(),
-                     ga) == new_relation[predicate_symbol_idx].tuples.end()) {
-                // If ground atom is not in the state, we add it
-                new_relation[eff.get_predicate_symbol_idx()].tuples.insert(ga);
-                add_to_added_atoms(eff.get_predicate_symbol_idx(), ga);
+            if (new_relation[predicate_symbol_idx].tuples.insert(ga).second) {
+                // The ground atom was not in the state
+                add_to_added_atoms(predicate_symbol_idx, ga);
             }
         }
     }
@@ -105,6 +105,7 @@ DBState CliqueSuccessorGenerator::generate_successor(const LiftedOperatorId &op,
                                                      const ActionSchema &action,
                                                      const DBState &state) {
     added_atoms.clear();
+    deleted_atoms.clear();
     vector<bool> new_nullary_atoms(state.get_nullary_atoms());
     vector<Relation> new_relation(state.get_relations());
     apply_nullary_effects(action, new_nullary_atoms);
@@ -116,5 +117,9 @@ DBState CliqueSuccessorGenerator::generate_successor(const LiftedOperatorId &op,
         apply_lifted_action_effects(action, op.get_instantiation(), new_relation);
     }
 
-    return DBState(std::move(new_relation), std::move(new_nullary_atoms));
+    DBState successor(std::move(new_relation), std::move(new_nullary_atoms));
+    successor.set_hash_from_parent(state, task.get_atom_table(), added_atoms, deleted_atoms);
+    if (incremental_cache)
+        incremental_cache->record_successor(state, successor, added_atoms, deleted_atoms);
+    return successor;
 }
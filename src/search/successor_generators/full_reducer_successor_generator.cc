@@ -197,9 +197,9 @@ Table FullReducerSuccessorGenerator::instantiate(const ActionSchema &action, con
 
     Table &working_table = tables[fjr[0]];
     for (size_t i = 1; i < fjr.size(); ++i) {
-        hash_join(working_table, tables[fjr[i]]);
+        hash_join(working_table, tables[fjr[i]], get_join_arena(action));
         filter_static(action, working_table);
-        if (working_table.tuples.empty()) {
+        if (working_table.empty()) {
             return working_table;
         }
     }
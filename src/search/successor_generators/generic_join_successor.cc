@@ -6,24 +6,79 @@
 #include "../database/hash_join.h"
 #include "../database/semi_join.h"
 #include "../database/table.h"
+#include "../database/utils.h"
+#include "../hash_structures.h"
 #include "../states/state.h"
 #include "../task.h"
 
+#include "../utils/worker_pool.h"
+
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <numeric>
 #include <vector>
 #include <iostream>
 
 using namespace std;
 
+// Number of expanded states whose applicable actions are kept in incremental mode
+static const size_t INCREMENTAL_CACHE_CAPACITY = 1024;
+
 GenericJoinSuccessor::GenericJoinSuccessor(const Task &task)
-    : static_information(task.get_static_info()), is_predicate_static(), action_data()
+    : static_information(task.get_static_info()), atom_table(task.get_atom_table()),
+      is_predicate_static(), action_data()
 {
     is_predicate_static.reserve(static_information.get_relations().size());
     for (const auto &r : static_information.get_relations()) {
         is_predicate_static.push_back(!r.tuples.empty());
     }
     action_data = precompile_action_data(task.get_action_schemas());
+    join_arenas.resize(action_data.size());
+    static_indexes.resize(action_data.size());
+    for (const PrecompiledActionData &adata : action_data) {
+        static_indexes[adata.schema_index].resize(adata.relevant_precondition_atoms.size());
+    }
+}
+
+GenericJoinSuccessor::~GenericJoinSuccessor() = default;
+
+void GenericJoinSuccessor::set_num_threads(unsigned num_threads)
+{
+    if (num_threads <= 1) {
+        worker_pool.reset();
+    }
+    else {
+        worker_pool = std::make_unique<utils::WorkerPool>(num_threads);
+    }
+}
+
+void GenericJoinSuccessor::set_incremental(bool incremental)
+{
+    if (!incremental) {
+        incremental_cache.reset();
+        return;
+    }
+    // Only the predicates joined by some schema decide which actions are applicable
+    vector<bool> relevant_predicates(is_predicate_static.size(), false);
+    for (const PrecompiledActionData &adata : action_data) {
+        for (unsigned i : adata.fluent_tables) {
+            relevant_predicates[adata.relevant_precondition_atoms[i].get_predicate_symbol_idx()] = true;
+        }
+    }
+    incremental_cache = std::make_unique<IncrementalSuccessorCache>(
+        std::move(relevant_predicates), INCREMENTAL_CACHE_CAPACITY);
+}
+
+void GenericJoinSuccessor::print_statistics() const
+{
+    if (incremental_cache)
+        incremental_cache->print_statistics();
+}
+
+JoinArena &GenericJoinSuccessor::get_join_arena(const ActionSchema &action)
+{
+    return join_arenas[action.get_index()];
 }
 
 Table GenericJoinSuccessor::instantiate(const ActionSchema &action,
@@ -36,19 +91,35 @@ Table GenericJoinSuccessor::instantiate(const ActionSchema &action,
     const auto& actiondata = action_data[action.get_index()];
 
     vector<Table> tables(0);
-    auto res = parse_precond_into_join_program(actiondata, state, tables);
+    auto res = parse_fluent_preconditions(actiondata, state, tables);
 
     if (!res) return Table::EMPTY_TABLE();
 
-    assert(!tables.empty());
-    assert(tables.size() == actiondata.relevant_precondition_atoms.size());
+    vector<int> order(tables.size());
+    iota(order.begin(), order.end(), 0);
+    return join_in_order(action, tables, order);
+}
 
-    Table &working_table = tables[0];
-    for (size_t i = 1; i < tables.size(); ++i) {
-        hash_join(working_table, tables[i]);
+Table GenericJoinSuccessor::join_in_order(const ActionSchema &action,
+                                          vector<Table> &tables,
+                                          const vector<int> &order)
+{
+    const PrecompiledActionData &adata = action_data[action.get_index()];
+    assert(!tables.empty());
+    assert(tables.size() == adata.relevant_precondition_atoms.size());
+    assert(order.size() == tables.size());
+
+    JoinArena &arena = get_join_arena(action);
+    Table working_table = is_static_precondition(adata, order[0])
+        ? adata.precompiled_db[order[0]] : std::move(tables[order[0]]);
+    for (size_t i = 1; i < order.size(); ++i) {
+        if (is_static_precondition(adata, order[i]))
+            join_static_precondition(adata, order[i], working_table, arena);
+        else
+            hash_join(working_table, tables[order[i]], arena);
         // Filter out equalities
         filter_static(action, working_table);
-        if (working_table.tuples.empty()) {
+        if (working_table.empty()) {
             return working_table;
         }
     }
@@ -56,6 +127,86 @@ Table GenericJoinSuccessor::instantiate(const ActionSchema &action,
     return working_table;
 }
 
+bool GenericJoinSuccessor::is_static_precondition(const PrecompiledActionData &adata,
+                                                  size_t i) const
+{
+    return is_static(adata.relevant_precondition_atoms[i].get_predicate_symbol_idx());
+}
+
+const Table &GenericJoinSuccessor::get_precondition_table(const PrecompiledActionData &adata,
+                                                          const vector<Table> &tables,
+                                                          size_t i) const
+{
+    return is_static_precondition(adata, i) ? adata.precompiled_db[i] : tables[i];
+}
+
+const StaticTableIndex &GenericJoinSuccessor::get_static_index(const PrecompiledActionData &adata,
+                                                               size_t i,
+                                                               const vector<int> &key_columns)
+{
+    assert(is_static_precondition(adata, i));
+    // Only the job instantiating the schema accesses its indexes
+    auto &indexes = static_indexes[adata.schema_index][i];
+    auto it = indexes.find(key_columns);
+    if (it == indexes.end()) {
+        it = indexes.emplace(key_columns, StaticTableIndex(adata.precompiled_db[i], key_columns)).first;
+    }
+    return it->second;
+}
+
+/*
+ * Columns of the static table matching the table, in increasing order, and the
+ * matching columns of the table in the same order. The index on the static
+ * table is thus the same whatever the order of the columns of the table.
+ */
+static void compute_index_columns(const Table &table,
+                                  const Table &static_table,
+                                  vector<int> &key_columns,
+                                  vector<int> &probe_columns)
+{
+    vector<pair<int, int>> matches;
+    for (const auto &[column, static_column] : compute_matching_columns(table, static_table)) {
+        matches.emplace_back(static_column, column);
+    }
+    sort(matches.begin(), matches.end());
+    for (const auto &[static_column, column] : matches) {
+        key_columns.push_back(static_column);
+        probe_columns.push_back(column);
+    }
+}
+
+void GenericJoinSuccessor::join_static_precondition(const PrecompiledActionData &adata,
+                                                    size_t i,
+                                                    Table &working_table,
+                                                    JoinArena &arena)
+{
+    const Table &static_table = adata.precompiled_db[i];
+    vector<int> key_columns, probe_columns;
+    compute_index_columns(working_table, static_table, key_columns, probe_columns);
+    /*
+     * The index join must sort its matches to list them in the order of the
+     * hash join, so it only pays off if it saves scanning a larger static
+     * table. Cartesian products have nothing to index.
+     */
+    if (key_columns.empty() || working_table.size() >= static_table.size()) {
+        hash_join(working_table, static_table, arena);
+        return;
+    }
+    index_join(working_table, static_table, get_static_index(adata, i, key_columns), probe_columns, arena);
+}
+
+size_t GenericJoinSuccessor::semi_join_static_precondition(const PrecompiledActionData &adata,
+                                                           size_t i,
+                                                           Table &table)
+{
+    const Table &static_table = adata.precompiled_db[i];
+    vector<int> key_columns, probe_columns;
+    compute_index_columns(table, static_table, key_columns, probe_columns);
+    if (key_columns.empty())
+        return table.size();
+    return index_semi_join(table, static_table, get_static_index(adata, i, key_columns), probe_columns);
+}
+
 void GenericJoinSuccessor::filter_static(const ActionSchema &action,
                                          Table &working_table)
 {
@@ -73,7 +224,7 @@ void GenericJoinSuccessor::filter_static(const ActionSchema &action,
 
                 if ((atom.is_negated() && is_equal)
                         || (!atom.is_negated() && !is_equal)){
-                    working_table.tuples.clear();
+                    working_table.values.clear();
                     return;
                 }
 
@@ -91,14 +242,10 @@ void GenericJoinSuccessor::filter_static(const ActionSchema &action,
                 if (it != tup_idx.end()){
                     int index = distance(tup_idx.begin(), it);
 
-                    vector<vector<int>> newtuples;
-                    for (const auto &t : working_table.tuples) {
-                        if ((atom.is_negated() && t[index] != const_idx)
-                                || (!atom.is_negated() && t[index] == const_idx)){
-                            newtuples.push_back(t);
-                        }
-                    }
-                    working_table.tuples = std::move(newtuples);
+                    working_table.filter_tuples([&](const int *t) {
+                        return (atom.is_negated() && t[index] != const_idx)
+                                || (!atom.is_negated() && t[index] == const_idx);
+                    });
                 }
 
             }else{ // !args[0].is_constant() && !args[1].is_constant()
@@ -111,14 +258,10 @@ void GenericJoinSuccessor::filter_static(const ActionSchema &action,
                     int index1 = distance(tup_idx.begin(), it_1);
                     int index2 = distance(tup_idx.begin(), it_2);
 
-                    vector<vector<int>> newtuples;
-                    for (const auto &t : working_table.tuples) {
-                        if ((atom.is_negated() && t[index1] != t[index2])
-                                || (!atom.is_negated() && t[index1] == t[index2])){
-                            newtuples.push_back(t);
-                        }
-                    }
-                    working_table.tuples = std::move(newtuples);
+                    working_table.filter_tuples([&](const int *t) {
+                        return (atom.is_negated() && t[index1] != t[index2])
+                                || (!atom.is_negated() && t[index1] == t[index2]);
+                    });
                 }
             }
         }
@@ -144,14 +287,15 @@ void GenericJoinSuccessor::get_indices_and_constants_in_preconditions(vector<int
 
 /*
  * Select only those tuples matching the constants of a partially grounded
- * precondition.
+ * precondition. The selected tuples are appended one after the other to the
+ * flat buffer `tuples`.
  */
 void GenericJoinSuccessor::select_tuples(const DBState &s,
                                          const Atom &a,
-                                         std::vector<GroundAtom> &tuples,
+                                         std::vector<int> &tuples,
                                          const std::vector<int> &constants)
 {
-    for (const GroundAtom &atom : s.get_relations()[a.get_predicate_symbol_idx()].tuples) {
+    for (const auto &atom : s.get_relations()[a.get_predicate_symbol_idx()].tuples) {
         bool match_constants = true;
         for (int c : constants) {
             assert(a.get_arguments()[c].is_constant());
@@ -160,7 +304,7 @@ void GenericJoinSuccessor::select_tuples(const DBState &s,
                 break;
             }
         }
-        if (match_constants) tuples.push_back(atom);
+        if (match_constants) tuples.insert(tuples.end(), atom.begin(), atom.end());
     }
 }
 
@@ -177,6 +321,7 @@ GenericJoinSuccessor::precompile_action_data(const std::vector<ActionSchema>& ac
 PrecompiledActionData GenericJoinSuccessor::precompile_action_data(const ActionSchema& action) {
     PrecompiledActionData data;
 
+    data.schema_index = action.get_index();
     data.is_ground = action.get_parameters().empty();
     if (data.is_ground) return data; // We won't need anything from this action
 
@@ -210,7 +355,7 @@ PrecompiledActionData GenericJoinSuccessor::precompile_action_data(const ActionS
         }
 
         // Otherwise the atom is static, so we precompile the table corresponding to it
-        vector<GroundAtom> tuples;
+        vector<int> tuples;
         vector<int> constants, indices;
 
         get_indices_and_constants_in_preconditions(indices, constants, atom);
@@ -245,16 +390,29 @@ bool GenericJoinSuccessor::parse_precond_into_join_program(
      *    2. The table comes directly from the current state.
      *
      */
+    if (!parse_fluent_preconditions(adata, state, tables)) return false;
+
+    for (size_t i = 0; i < tables.size(); ++i) {
+        if (is_static_precondition(adata, i))
+            tables[i] = adata.precompiled_db[i];  // This performs the copy that we'll return
+    }
+    return true;
+}
+
+bool GenericJoinSuccessor::parse_fluent_preconditions(
+    const PrecompiledActionData &adata, const DBState &state, std::vector<Table>& tables)
+{
     if (adata.statically_inapplicable) return false;
 
-    tables = adata.precompiled_db;  // This performs the copy that we'll return
+    tables.clear();
+    tables.resize(adata.relevant_precondition_atoms.size());
     for (unsigned i:adata.fluent_tables) {
         // Let's fill in those (currently empty) tables that correspond to
         // fluent symbols in the precondition
         const Atom &atom = adata.relevant_precondition_atoms[i];
         assert(!is_static(atom.get_predicate_symbol_idx()));
 
-        vector<GroundAtom> tuples;
+        vector<int> tuples;
         vector<int> constants, indices;
 
         // TODO the call next line should be performed at preprocessing as well. We should keep in
@@ -335,6 +493,7 @@ DBState GenericJoinSuccessor::generate_successor(
     const DBState &state) {
 
     added_atoms.clear();
+    deleted_atoms.clear();
     vector<bool> new_nullary_atoms(state.get_nullary_atoms());
     vector<Relation> new_relation(state.get_relations());
     apply_nullary_effects(action, new_nullary_atoms);
@@ -346,12 +505,16 @@ DBState GenericJoinSuccessor::generate_successor(
         apply_lifted_action_effects(action, op.get_instantiation(), new_relation);
     }
 
-    return DBState(std::move(new_relation), std::move(new_nullary_atoms));
+    DBState successor(std::move(new_relation), std::move(new_nullary_atoms));
+    successor.set_hash_from_parent(state, atom_table, added_atoms, deleted_atoms);
+    if (incremental_cache)
+        incremental_cache->record_successor(state, successor, added_atoms, deleted_atoms);
+    return successor;
 }
 
 void GenericJoinSuccessor::order_tuple_by_free_variable_order(const vector<int> &free_var_indices,
                                                             const vector<int> &map_indices_to_position,
-                                                            const vector<int> &tuple_with_const,
+                                                            const int *tuple_with_const,
                                                             vector<int> &ordered_tuple) {
     for (size_t i = 0; i < free_var_indices.size(); ++i) {
         ordered_tuple[free_var_indices[i]] = tuple_with_const[map_indices_to_position[i]];
@@ -410,14 +573,13 @@ void GenericJoinSuccessor::apply_ground_action_effects(const ActionSchema &actio
         assert(eff.get_predicate_symbol_idx() == new_relation[eff.get_predicate_symbol_idx()].predicate_symbol);
         if (eff.is_negated()) {
             // If ground effect is negated, remove it from relation
-            new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga);
+            if (new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga))
+                deleted_atoms.emplace_back(eff.get_predicate_symbol_idx(), ga);
         }
         else {
             // If ground effect is not in the state, we add it
-
-            new_relation[eff.get_predicate_symbol_idx()].tuples.insert(ga);
-            add_to_added_atoms(eff.get_predicate_symbol_idx(), ga);
-
+            if (new_relation[eff.get_predicate_symbol_idx()].tuples.insert(ga).second)
+                add_to_added_atoms(eff.get_predicate_symbol_idx(), ga);
         }
     }
 }
@@ -430,18 +592,14 @@ void GenericJoinSuccessor::apply_lifted_action_effects(const ActionSchema &actio
         assert(eff.get_predicate_symbol_idx() == new_relation[eff.get_predicate_symbol_idx()].predicate_symbol);
         if (eff.is_negated()) {
             // Remove from relation
-            new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga);
+            if (new_relation[eff.get_predicate_symbol_idx()].tuples.erase(ga))
+                deleted_atoms.emplace_back(eff.get_predicate_symbol_idx(), std::move(ga));
         }
         else {
             int predicate_symbol_idx = eff.get_predicate_symbol_idx();
-            if (find(new_relation[predicate_symbol_idx].tuples.begin(),
-                     new_relation[predicate_symbol_idx].tuples.end(),
-                     ga) == new_relation[predicate_symbol_idx].tuples.end()) {
-                // If ground atom is not in the state, we add it
-
-                new_relation[eff.get_predicate_symbol_idx()].tuples.insert(ga);
-                add_to_added_atoms(eff.get_predicate_symbol_idx(), ga);
-
+            if (new_relation[predicate_symbol_idx].tuples.insert(ga).second) {
+                // The ground atom was not in the state
+                add_to_added_atoms(predicate_symbol_idx, ga);
             }
         }
     }
@@ -476,8 +634,9 @@ std::vector<LiftedOperatorId> GenericJoinSuccessor::get_applicable_actions(
         return applicable;
     }
 
+    get_join_arena(action).reset();
     Table instantiations = instantiate(action, state);
-    if (instantiations.tuples.empty()) { // No applicable action from this schema
+    if (instantiations.empty()) { // No applicable action from this schema
         return applicable;
     }
 
@@ -486,7 +645,9 @@ std::vector<LiftedOperatorId> GenericJoinSuccessor::get_applicable_actions(
     compute_map_indices_to_table_positions(
         instantiations, free_var_indices, map_indices_to_position);
 
-    for (const vector<int> &tuple_with_const : instantiations.tuples) {
+    applicable.reserve(instantiations.size());
+    for (size_t i = 0; i < instantiations.size(); ++i) {
+        const int *tuple_with_const = instantiations.row(i);
         vector<int> ordered_tuple(free_var_indices.size());
         order_tuple_by_free_variable_order(
             free_var_indices, map_indices_to_position, tuple_with_const, ordered_tuple);
@@ -498,8 +659,31 @@ std::vector<LiftedOperatorId> GenericJoinSuccessor::get_applicable_actions(
 std::vector<LiftedOperatorId> GenericJoinSuccessor::get_applicable_actions(
             const std::vector<ActionSchema> &actions, const DBState &state)
 {
+    if (incremental_cache) {
+        return get_applicable_actions_incrementally(actions, state);
+    }
+
     std::vector<LiftedOperatorId> all_applicable_actions;
 
+    if (worker_pool) {
+        applicable_per_schema.resize(actions.size());
+        worker_pool->run(actions.size(), [&](size_t i) {
+            applicable_per_schema[i] = get_applicable_actions(actions[i], state);
+        });
+
+        size_t total = 0;
+        for (const auto &applicable_actions : applicable_per_schema) {
+            total += applicable_actions.size();
+        }
+        all_applicable_actions.reserve(total);
+        for (auto &applicable_actions : applicable_per_schema) {
+            std::move(applicable_actions.begin(), applicable_actions.end(),
+                      std::back_inserter(all_applicable_actions));
+            applicable_actions.clear();
+        }
+        return all_applicable_actions;
+    }
+
     for (const auto& action : actions) {
         const auto applicable_actions = get_applicable_actions(action, state);
         all_applicable_actions.reserve(all_applicable_actions.size() + applicable_actions.size());
@@ -509,6 +693,182 @@ std::vector<LiftedOperatorId> GenericJoinSuccessor::get_applicable_actions(
     return all_applicable_actions;
 }
 
+bool GenericJoinSuccessor::prepare_schema_by_schema(const DBState &)
+{
+    return !worker_pool && !incremental_cache;
+}
+
+std::vector<LiftedOperatorId> GenericJoinSuccessor::get_applicable_actions_incrementally(
+            const std::vector<ActionSchema> &actions, const DBState &state)
+{
+    uint64_t hash = incremental_cache->hash_state(state);
+    const IncrementalSuccessorCache::Delta *delta = incremental_cache->find_delta(state, hash);
+    auto expanded = std::make_unique<IncrementalSuccessorCache::ExpandedState>(
+        state, hash, action_data.size());
+
+    auto instantiate_schema = [&](size_t i) {
+        const ActionSchema &action = actions[i];
+        if (delta && delta->parent->joined[action.get_index()] && !action.is_ground()
+            && !is_trivially_inapplicable(state, action)) {
+            expanded->applicable[action.get_index()] =
+                get_applicable_actions_from_delta(action, state, *delta);
+        }
+        else {
+            expanded->applicable[action.get_index()] = get_applicable_actions(action, state);
+        }
+    };
+    if (worker_pool) {
+        worker_pool->run(actions.size(), instantiate_schema);
+    }
+    else {
+        for (size_t i = 0; i < actions.size(); ++i)
+            instantiate_schema(i);
+    }
+
+    std::vector<LiftedOperatorId> all_applicable_actions;
+    for (const ActionSchema &action : actions) {
+        // Lists of ground or nullary-inapplicable schemas are not join results
+        expanded->joined[action.get_index()] =
+            !action.is_ground() && !is_trivially_inapplicable(state, action);
+        const auto &applicable_actions = expanded->applicable[action.get_index()];
+        all_applicable_actions.insert(all_applicable_actions.end(),
+                                      applicable_actions.begin(), applicable_actions.end());
+    }
+    incremental_cache->insert(std::move(expanded));
+    return all_applicable_actions;
+}
+
+/*
+ * An instantiation is applicable in the state but not in its parent only if it
+ * uses an added tuple, so the new instantiations are those of the join of the
+ * state where one fluent precondition is restricted to the added tuples.
+ */
+std::vector<LiftedOperatorId> GenericJoinSuccessor::get_applicable_actions_from_delta(
+        const ActionSchema &action,
+        const DBState &state,
+        const IncrementalSuccessorCache::Delta &delta)
+{
+    const PrecompiledActionData &adata = action_data[action.get_index()];
+    const vector<Atom> &atoms = adata.relevant_precondition_atoms;
+    const vector<LiftedOperatorId> &parent_applicable = delta.parent->applicable[action.get_index()];
+
+    auto changes_predicate = [](const vector<pair<int, GroundAtom>> &changes, int predicate) {
+        return any_of(changes.begin(), changes.end(),
+                      [&](const pair<int, GroundAtom> &change) {return change.first == predicate;});
+    };
+    bool has_deleted = false, has_added = false;
+    for (unsigned i : adata.fluent_tables) {
+        int predicate = atoms[i].get_predicate_symbol_idx();
+        has_deleted = has_deleted || changes_predicate(delta.deleted, predicate);
+        has_added = has_added || changes_predicate(delta.added, predicate);
+    }
+
+    std::vector<LiftedOperatorId> applicable;
+    if (!has_deleted) {
+        applicable = parent_applicable;
+    }
+    else {
+        for (const LiftedOperatorId &op : parent_applicable) {
+            bool uses_deleted_tuple = false;
+            for (unsigned i : adata.fluent_tables) {
+                const Atom &atom = atoms[i];
+                if (!changes_predicate(delta.deleted, atom.get_predicate_symbol_idx()))
+                    continue;
+                if (delta.is_deleted(atom.get_predicate_symbol_idx(),
+                                     tuple_to_atom(op.get_instantiation(), atom))) {
+                    uses_deleted_tuple = true;
+                    break;
+                }
+            }
+            if (!uses_deleted_tuple)
+                applicable.push_back(op);
+        }
+    }
+    if (!has_added) {
+        return applicable;
+    }
+
+    // The tables must be in the order of the preconditions, whatever the join order of the generator
+    vector<Table> tables;
+    if (!parse_fluent_preconditions(adata, state, tables)) {
+        return applicable;
+    }
+
+    JoinArena &arena = get_join_arena(action);
+    arena.reset();
+    unordered_set<vector<int>, TupleHash> new_instantiations;
+    for (unsigned j : adata.fluent_tables) {
+        const Atom &atom = atoms[j];
+        vector<int> indices, constants;
+        get_indices_and_constants_in_preconditions(indices, constants, atom);
+        vector<int> tuples;
+        for (const auto &[predicate, tuple] : delta.added) {
+            if (predicate != atom.get_predicate_symbol_idx())
+                continue;
+            bool match_constants = all_of(constants.begin(), constants.end(), [&](int c) {
+                return tuple[c] == atom.get_arguments()[c].get_index();
+            });
+            if (match_constants)
+                tuples.insert(tuples.end(), tuple.begin(), tuple.end());
+        }
+        if (tuples.empty())
+            continue;
+
+        /*
+         * The added tuples are few, so the join starts from them and always
+         * continues with a table sharing a variable with the joined ones, if
+         * any, to avoid cartesian products.
+         */
+        Table working_table(std::move(tuples), std::move(indices));
+        filter_static(action, working_table);
+        vector<bool> joined(tables.size(), false);
+        joined[j] = true;
+        for (size_t n = 1; n < tables.size() && !working_table.empty(); ++n) {
+            size_t next = tables.size();
+            bool next_is_connected = false;
+            for (size_t k = 0; k < tables.size(); ++k) {
+                if (joined[k])
+                    continue;
+                const Table &table = get_precondition_table(adata, tables, k);
+                bool is_connected = any_of(
+                    table.tuple_index.begin(), table.tuple_index.end(), [&](int index) {
+                        return index >= 0 && find(working_table.tuple_index.begin(),
+                                                  working_table.tuple_index.end(),
+                                                  index) != working_table.tuple_index.end();
+                    });
+                if (next == tables.size() || (is_connected && !next_is_connected)
+                    || (is_connected == next_is_connected
+                        && table.size() < get_precondition_table(adata, tables, next).size())) {
+                    next = k;
+                    next_is_connected = is_connected;
+                }
+            }
+            joined[next] = true;
+            if (is_static_precondition(adata, next))
+                join_static_precondition(adata, next, working_table, arena);
+            else
+                hash_join(working_table, tables[next], arena);
+            filter_static(action, working_table);
+        }
+        if (working_table.empty())
+            continue;
+
+        vector<int> free_var_indices;
+        vector<int> map_indices_to_position;
+        compute_map_indices_to_table_positions(
+            working_table, free_var_indices, map_indices_to_position);
+        for (size_t i = 0; i < working_table.size(); ++i) {
+            vector<int> ordered_tuple(free_var_indices.size());
+            order_tuple_by_free_variable_order(
+                free_var_indices, map_indices_to_position, working_table.row(i), ordered_tuple);
+            // Instantiations using several added tuples are found once per tuple
+            if (new_instantiations.insert(ordered_tuple).second)
+                applicable.emplace_back(action.get_index(), std::move(ordered_tuple));
+        }
+    }
+    return applicable;
+}
+
 /**
  *    This action generates the ground atom produced by an atomic effect given an instantiation of
  *    its parameters.
@@ -583,7 +943,7 @@ bool GenericJoinSuccessor::is_ground_action_applicable(const ActionSchema &actio
     }
     return true;
 }
-const unordered_set<GroundAtom, TupleHash> &
+const TupleSet &
 GenericJoinSuccessor::get_tuples_from_static_relation(size_t i) const
 {
     return static_information.get_tuples_of_relation(i);
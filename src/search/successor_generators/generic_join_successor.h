@@ -1,20 +1,30 @@
 #ifndef SEARCH_GENERIC_JOIN_SUCCESSOR_H
 #define SEARCH_GENERIC_JOIN_SUCCESSOR_H
 
+#include "incremental_successor_cache.h"
 #include "successor_generator.h"
 
 #include "../atom.h"
 #include "../structures.h"
 
+#include "../database/join_arena.h"
+#include "../database/static_table_index.h"
+
 #include <map>
+#include <memory>
 #include <set>
 #include <unordered_set>
 #include <vector>
 
 class PrecompiledActionData;
+class AtomTable;
 class Task;
 class Table;
 
+namespace utils {
+class WorkerPool;
+}
+
 /**
  * This class is not a successor generator per se. It just contain most of the common functions
  * used over all the join successor generators.
@@ -22,11 +32,17 @@ class Table;
  * @details This contains the main functions for successor generators based on
  * join of preconditions .The main function of this class is the instantiate
  * function, which performs the join program itself. If used, this class
- * orders the join program using the same order as the PDDL file. This behavior
- * is defined in the function parse_precond_into_join_program. Classes
- * extending the GenericJoinSuccessor class usually replace this function for
+ * orders the join program using the same order as the PDDL file. Classes
+ * extending the GenericJoinSuccessor class usually replace this order for
  * something more elaborated.
  *
+ * The tables of the static preconditions are not copied into the join
+ * program: when one is joined with the working table, a persistent index on
+ * the columns it shares with the working table is probed instead. The indexes
+ * are built the first time their columns are probed and kept for the whole
+ * search, so generators with a fixed join order build all of them when the
+ * initial state is expanded.
+ *
  * @see database/join.cc
  */
 class GenericJoinSuccessor : public SuccessorGenerator {
@@ -34,6 +50,35 @@ class GenericJoinSuccessor : public SuccessorGenerator {
 
 public:
     explicit GenericJoinSuccessor(const Task &task);
+    ~GenericJoinSuccessor() override;
+
+    /**
+     * Instantiate the action schemas of a state in parallel using the given
+     * number of threads. With a single thread (the default), schemas are
+     * processed sequentially.
+     *
+     * @details Each schema is a job of a persistent worker pool and writes its
+     * instantiations into its own slot. The slots are concatenated in schema
+     * order, so the result does not depend on the number of threads.
+     * Implementations of instantiate() and parse_precond_into_join_program()
+     * must therefore not modify state shared with other schemas.
+     */
+    void set_num_threads(unsigned num_threads);
+
+    /**
+     * Derive the applicable actions of a state from those of its parent when
+     * the parent is among the recently expanded states.
+     *
+     * @details Instantiations of the parent that use a deleted tuple are
+     * dropped, and the new ones are found by delta-joins: for each fluent
+     * precondition, the tuples added by the action are joined with the
+     * tables of the other preconditions in the state. Instantiations of the
+     * parent come first, so the order of the applicable actions may differ
+     * from the one of a full instantiation.
+     *
+     * @see incremental_successor_cache.h
+     */
+    void set_incremental(bool incremental);
 
     virtual Table instantiate(const ActionSchema &action, const DBState &state);
 
@@ -67,32 +112,97 @@ public:
     std::vector<LiftedOperatorId> get_applicable_actions(
             const std::vector<ActionSchema> &actions, const DBState &state) override;
 
+    //! Schemas are instantiated together in parallel or incremental mode
+    bool prepare_schema_by_schema(const DBState &state) override;
+
     const GroundAtom tuple_to_atom(const std::vector<int> &tuple, const Atom &eff);
 
-    const std::unordered_set<GroundAtom, TupleHash>
-    &get_tuples_from_static_relation(size_t i) const;
+    const TupleSet &get_tuples_from_static_relation(size_t i) const;
 
     const std::vector<std::pair<int, GroundAtom>> &get_added_atoms() const override {
         return added_atoms;
     }
 
+    void print_statistics() const override;
+
 protected:
     const StaticInformation& static_information;
 
+    //! Used to derive the hash of a successor from the hash of its parent
+    const AtomTable &atom_table;
+
     std::vector<bool> is_predicate_static;
 
     //! Some data relevant to each action schema, indexed by schema index
     std::vector<PrecompiledActionData> action_data;
 
+    //! Scratch memory of the hash joins, indexed by schema index
+    std::vector<JoinArena> join_arenas;
+
+    //! Indexes on the static tables, indexed by schema index and precondition,
+    //! and keyed by the indexed columns
+    std::vector<std::vector<std::map<std::vector<int>, StaticTableIndex>>> static_indexes;
+
+    std::unique_ptr<utils::WorkerPool> worker_pool;
+    std::vector<std::vector<LiftedOperatorId>> applicable_per_schema;
+
+    //! Only used in incremental mode
+    std::unique_ptr<IncrementalSuccessorCache> incremental_cache;
+
+    //! Atoms removed from the state by the last generated successor
+    std::vector<std::pair<int, GroundAtom>> deleted_atoms;
+
     bool is_static(size_t i) const { return is_predicate_static[i]; }
 
+    JoinArena &get_join_arena(const ActionSchema &action);
+
+    /**
+     * Same as parse_precond_into_join_program, but only the tables of the
+     * fluent preconditions are created. The tables of the static ones are left
+     * empty, and are found in adata.precompiled_db.
+     */
+    bool parse_fluent_preconditions(const PrecompiledActionData &adata,
+                                    const DBState &state,
+                                    std::vector<Table> &tables);
+
+    bool is_static_precondition(const PrecompiledActionData &adata, std::size_t i) const;
+
+    /// @return the table of the i-th precondition in a join program created by parse_fluent_preconditions
+    const Table &get_precondition_table(const PrecompiledActionData &adata,
+                                        const std::vector<Table> &tables,
+                                        std::size_t i) const;
+
+    /// Index on the given columns of the table of the i-th precondition, which must be static
+    const StaticTableIndex &get_static_index(const PrecompiledActionData &adata,
+                                             std::size_t i,
+                                             const std::vector<int> &key_columns);
+
+    /// Join the working table with the table of the i-th precondition, which must be static
+    void join_static_precondition(const PrecompiledActionData &adata,
+                                  std::size_t i,
+                                  Table &working_table,
+                                  JoinArena &arena);
+
+    /// Semi-join the table with the one of the i-th precondition, which must be static
+    std::size_t semi_join_static_precondition(const PrecompiledActionData &adata,
+                                              std::size_t i,
+                                              Table &table);
+
+    /**
+     * Join the tables of a join program created by parse_fluent_preconditions
+     * in the given order, filtering the (in)equalities after each join.
+     */
+    Table join_in_order(const ActionSchema &action,
+                        std::vector<Table> &tables,
+                        const std::vector<int> &order);
+
     static void get_indices_and_constants_in_preconditions(std::vector<int> &indices,
                                                            std::vector<int> &constants,
                                                            const Atom &a);
 
     static void select_tuples(const DBState &s,
                               const Atom &a,
-                              std::vector<GroundAtom> &tuples,
+                              std::vector<int> &tuples,
                               const std::vector<int> &constants);
 
     static void filter_static(const ActionSchema &action,
@@ -113,7 +223,7 @@ protected:
 
     static void order_tuple_by_free_variable_order(const std::vector<int> &free_var_indices,
                                             const std::vector<int> &map_indices_to_position,
-                                            const std::vector<int> &tuple_with_const,
+                                            const int *tuple_with_const,
                                             std::vector<int> &ordered_tuple) ;
 
     static bool is_trivially_inapplicable(const DBState &state, const ActionSchema &action) ;
@@ -128,6 +238,14 @@ protected:
                                      const std::vector<int> &tuple,
                                      std::vector<Relation> &new_relation);
 
+    std::vector<LiftedOperatorId> get_applicable_actions_incrementally(
+            const std::vector<ActionSchema> &actions, const DBState &state);
+
+    std::vector<LiftedOperatorId> get_applicable_actions_from_delta(
+            const ActionSchema &action,
+            const DBState &state,
+            const IncrementalSuccessorCache::Delta &delta);
+
     bool is_ground_action_applicable(const ActionSchema &action,
                                      const DBState &state) const;
 
@@ -139,11 +257,14 @@ protected:
 class PrecompiledActionData {
 public:
     PrecompiledActionData() :
-        is_ground(false), statically_inapplicable(false),
+        schema_index(-1), is_ground(false), statically_inapplicable(false),
         relevant_precondition_atoms(), fluent_tables(),
         precompiled_db()
     {}
 
+    //! Index of the action schema this data belongs to
+    int schema_index;
+
     //! Whether the action has no parameters
     bool is_ground;
 
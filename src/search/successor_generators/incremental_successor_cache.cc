@@ -0,0 +1,152 @@
+#include "incremental_successor_cache.h"
+
+#include "../utils/hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+bool IncrementalSuccessorCache::Delta::is_deleted(int predicate, const GroundAtom &atom) const
+{
+    // Actions delete a handful of atoms, a linear scan is the fastest lookup
+    for (const auto &[p, deleted_atom] : deleted) {
+        if (p == predicate && deleted_atom == atom)
+            return true;
+    }
+    return false;
+}
+
+IncrementalSuccessorCache::IncrementalSuccessorCache(vector<bool> &&relevant_predicates,
+                                                     size_t capacity)
+    : relevant_predicates(std::move(relevant_predicates)), capacity(max<size_t>(capacity, 1)),
+      states_from_delta(0), states_from_scratch(0)
+{
+}
+
+uint64_t IncrementalSuccessorCache::hash_atom(int predicate, const GroundAtom &atom) const
+{
+    utils::HashState hash_state;
+    utils::feed(hash_state, predicate);
+    for (int object : atom)
+        utils::feed(hash_state, object);
+    return hash_state.get_hash64();
+}
+
+/*
+ * The hash of a state is the sum of the hashes of its relevant atoms, so the
+ * hash of a successor is obtained from the hash of its parent by subtracting
+ * the deleted atoms and adding the added ones.
+ */
+uint64_t IncrementalSuccessorCache::hash_state(const DBState &state) const
+{
+    uint64_t hash = 0;
+    const vector<Relation> &relations = state.get_relations();
+    for (size_t i = 0; i < relations.size(); ++i) {
+        if (!relevant_predicates[i])
+            continue;
+        for (const GroundAtom &atom : relations[i].tuples)
+            hash += hash_atom(i, atom);
+    }
+    return hash;
+}
+
+bool IncrementalSuccessorCache::is_successor(const DBState &state, const Delta &delta) const
+{
+    const vector<Relation> &parent_relations = delta.parent->state.get_relations();
+    const vector<Relation> &relations = state.get_relations();
+    vector<long> size_change(relations.size(), 0);
+    for (const auto &[predicate, atom] : delta.deleted) {
+        if (parent_relations[predicate].tuples.count(atom) == 0)
+            return false;
+        --size_change[predicate];
+    }
+    for (const auto &[predicate, atom] : delta.added) {
+        if (relations[predicate].tuples.count(atom) == 0)
+            return false;
+        if (parent_relations[predicate].tuples.count(atom) && !delta.is_deleted(predicate, atom))
+            return false;
+        ++size_change[predicate];
+    }
+
+    // With the sizes matching, the state is the parent with the changes
+    // applied if it contains every tuple of the parent that was not deleted
+    for (size_t i = 0; i < relations.size(); ++i) {
+        if (!relevant_predicates[i])
+            continue;
+        const TupleSet &tuples = relations[i].tuples;
+        const TupleSet &parent_tuples = parent_relations[i].tuples;
+        if (long(tuples.size()) != long(parent_tuples.size()) + size_change[i])
+            return false;
+        for (const GroundAtom &atom : parent_tuples) {
+            if (tuples.count(atom) == 0 && !delta.is_deleted(i, atom))
+                return false;
+        }
+    }
+    return true;
+}
+
+const IncrementalSuccessorCache::Delta *IncrementalSuccessorCache::find_delta(const DBState &state,
+                                                                              uint64_t hash)
+{
+    auto it = deltas.find(hash);
+    if (it == deltas.end() || !is_successor(state, it->second)) {
+        ++states_from_scratch;
+        return nullptr;
+    }
+    ++states_from_delta;
+    return &it->second;
+}
+
+void IncrementalSuccessorCache::evict_oldest()
+{
+    const ExpandedState *oldest = expanded_states.front().get();
+    for (uint64_t hash : oldest->successor_hashes) {
+        auto it = deltas.find(hash);
+        if (it != deltas.end() && it->second.parent == oldest)
+            deltas.erase(it);
+    }
+    expanded_states.pop_front();
+}
+
+void IncrementalSuccessorCache::insert(unique_ptr<ExpandedState> &&expanded)
+{
+    if (expanded_states.size() == capacity)
+        evict_oldest();
+    expanded_states.push_back(std::move(expanded));
+}
+
+void IncrementalSuccessorCache::record_successor(const DBState &parent_state,
+                                                 const DBState &successor,
+                                                 const vector<pair<int, GroundAtom>> &added,
+                                                 const vector<pair<int, GroundAtom>> &deleted)
+{
+    if (expanded_states.empty())
+        return;
+    ExpandedState &parent = *expanded_states.back();
+    Delta delta;
+    delta.parent = &parent;
+    uint64_t hash = parent.hash;
+    for (const auto &[predicate, atom] : deleted) {
+        if (!relevant_predicates[predicate] || successor.get_tuples_of_relation(predicate).count(atom))
+            continue;
+        hash -= hash_atom(predicate, atom);
+        delta.deleted.emplace_back(predicate, atom);
+    }
+    for (const auto &[predicate, atom] : added) {
+        if (!relevant_predicates[predicate] || parent_state.get_tuples_of_relation(predicate).count(atom))
+            continue;
+        hash += hash_atom(predicate, atom);
+        delta.added.emplace_back(predicate, atom);
+    }
+    // A state reached from several parents keeps the latest one
+    deltas[hash] = std::move(delta);
+    parent.successor_hashes.push_back(hash);
+}
+
+void IncrementalSuccessorCache::print_statistics() const
+{
+    cout << "States instantiated from the parent state: " << states_from_delta << endl;
+    cout << "States instantiated from scratch: " << states_from_scratch << endl;
+}
@@ -0,0 +1,118 @@
+#ifndef SEARCH_INCREMENTAL_SUCCESSOR_CACHE_H
+#define SEARCH_INCREMENTAL_SUCCESSOR_CACHE_H
+
+#include "../action.h"
+#include "../structures.h"
+
+#include "../states/state.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Applicable actions of the most recently expanded states, and the
+ * changes that lead from them to the successors generated from them.
+ *
+ * @details When a state is expanded, its applicable actions are stored
+ * together with a copy of the state. Every successor generated afterwards is
+ * recorded by the atoms it adds to and deletes from the last expanded state,
+ * keyed by a hash of the successor that is updated from the hash of the parent
+ * with the changed atoms only. If one of these successors is expanded later,
+ * find_delta() returns its parent and the changes, so the applicable actions
+ * can be derived from those of the parent.
+ *
+ * States are compared only on the relevant predicates, i.e., the fluent
+ * predicates occurring in the precondition of some action schema: the other
+ * relations do not change which instantiations are applicable. Only the last
+ * `capacity` expanded states are kept.
+ */
+class IncrementalSuccessorCache {
+public:
+    struct ExpandedState {
+        DBState state;
+        std::uint64_t hash;
+
+        //! Applicable actions of each schema, indexed by schema index
+        std::vector<std::vector<LiftedOperatorId>> applicable;
+
+        //! Whether the applicable actions of a schema are the result of the
+        //! join of its preconditions, and can hence be updated with a delta
+        std::vector<bool> joined;
+
+        //! Hashes under which the successors of the state are recorded
+        std::vector<std::uint64_t> successor_hashes;
+
+        ExpandedState(const DBState &state, std::uint64_t hash, std::size_t num_schemas)
+            : state(state), hash(hash), applicable(num_schemas), joined(num_schemas, false) {}
+    };
+
+    /**
+     * @brief Difference between a successor and the state it was generated
+     * from: the successor has the tuples of the parent except `deleted`, plus
+     * `added`. Only atoms of relevant predicates are listed.
+     */
+    struct Delta {
+        const ExpandedState *parent;
+        std::vector<std::pair<int, GroundAtom>> added;
+        std::vector<std::pair<int, GroundAtom>> deleted;
+
+        bool is_deleted(int predicate, const GroundAtom &atom) const;
+    };
+
+private:
+    std::vector<bool> relevant_predicates;
+    std::size_t capacity;
+
+    std::deque<std::unique_ptr<ExpandedState>> expanded_states;
+    std::unordered_map<std::uint64_t, Delta> deltas;
+
+    std::size_t states_from_delta;
+    std::size_t states_from_scratch;
+
+    bool is_successor(const DBState &state, const Delta &delta) const;
+    void evict_oldest();
+
+public:
+    IncrementalSuccessorCache(std::vector<bool> &&relevant_predicates, std::size_t capacity);
+
+    bool is_relevant(int predicate) const {
+        return relevant_predicates[predicate];
+    }
+
+    std::uint64_t hash_atom(int predicate, const GroundAtom &atom) const;
+
+    //! Order-independent hash of the relevant relations of the state
+    std::uint64_t hash_state(const DBState &state) const;
+
+    /**
+     * Return the recorded changes leading to the given state from one of the
+     * cached expanded states, or nullptr if there are none. The state is
+     * checked to be exactly the parent with the changes applied.
+     */
+    const Delta *find_delta(const DBState &state, std::uint64_t hash);
+
+    //! Store the given state as the last expanded one, evicting the oldest
+    //! state if the cache is full
+    void insert(std::unique_ptr<ExpandedState> &&expanded);
+
+    /**
+     * Record a successor of the last expanded state, given as `parent`, from
+     * the atoms reported as added and deleted by the action. Only the atoms
+     * whose truth value differs in the parent and the successor are kept, so
+     * atoms deleted and added again, or added while already true, are not
+     * changes. Atoms of irrelevant predicates are ignored.
+     */
+    void record_successor(const DBState &parent,
+                          const DBState &successor,
+                          const std::vector<std::pair<int, GroundAtom>> &added,
+                          const std::vector<std::pair<int, GroundAtom>> &deleted);
+
+    void print_statistics() const;
+};
+
+#endif //SEARCH_INCREMENTAL_SUCCESSOR_CACHE_H
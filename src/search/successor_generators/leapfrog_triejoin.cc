@@ -0,0 +1,318 @@
+#include "leapfrog_triejoin.h"
+
+#include "../action_schema.h"
+#include "../database/table.h"
+#include "../states/state.h"
+#include "../task.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <numeric>
+#include <set>
+
+using namespace std;
+
+size_t TrieRelation::seek(size_t begin, size_t end, size_t level, int value) const
+{
+    if (begin == end || get(begin, level) >= value)
+        return begin;
+    // Galloping search: the leapfrog mostly moves by short distances
+    size_t low = begin;
+    size_t step = 1;
+    while (low + step < end && get(low + step, level) < value) {
+        low += step;
+        step *= 2;
+    }
+    // The row is in (low, high]
+    size_t high = min(low + step, end);
+    ++low;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (get(middle, level) < value)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+size_t TrieRelation::skip(size_t begin, size_t end, size_t level, int value) const
+{
+    // Values are object indices, so value + 1 does not overflow
+    return seek(begin, end, level, value + 1);
+}
+
+
+/*
+ * Enumerate the bindings of the variables of one action schema in one state.
+ * begin[i] and end[i] delimit the rows of the trie of atom i that match the
+ * values bound so far.
+ */
+class LeapfrogJoin {
+    const LeapfrogActionData &data;
+    const vector<const TrieRelation *> &tries;
+    vector<size_t> begin;
+    vector<size_t> end;
+    vector<int> binding;
+    Table &result;
+
+    // Scratch memory of each depth: position in each participating trie, where
+    // the rows of the current value end, and the rows matched before the depth
+    vector<vector<size_t>> positions;
+    vector<vector<size_t>> next_positions;
+    vector<vector<pair<size_t, size_t>>> saved_ranges;
+
+    void enumerate(size_t depth);
+
+public:
+    LeapfrogJoin(const LeapfrogActionData &data,
+                 const vector<const TrieRelation *> &tries,
+                 Table &result)
+        : data(data), tries(tries), begin(tries.size(), 0), end(tries.size()),
+          binding(data.variable_order.size()), result(result),
+          positions(data.variable_order.size()), next_positions(data.variable_order.size()),
+          saved_ranges(data.variable_order.size())
+    {
+        for (size_t i = 0; i < tries.size(); ++i) {
+            end[i] = tries[i]->size();
+        }
+        for (size_t depth = 0; depth < data.variable_order.size(); ++depth) {
+            positions[depth].resize(data.participants[depth].size());
+            next_positions[depth].resize(data.participants[depth].size());
+            saved_ranges[depth].resize(data.participants[depth].size());
+        }
+    }
+
+    void run() { enumerate(0); }
+};
+
+void LeapfrogJoin::enumerate(size_t depth)
+{
+    if (depth == binding.size()) {
+        result.values.insert(result.values.end(), binding.begin(), binding.end());
+        return;
+    }
+
+    const vector<pair<int, int>> &participants = data.participants[depth];
+    vector<size_t> &position = positions[depth];
+    vector<size_t> &next_position = next_positions[depth];
+    vector<pair<size_t, size_t>> &ranges = saved_ranges[depth];
+    size_t k = participants.size();
+    assert(k > 0);
+
+    for (size_t j = 0; j < k; ++j) {
+        position[j] = begin[participants[j].first];
+        if (position[j] == end[participants[j].first])
+            return;
+    }
+
+    while (true) {
+        int value = 0;
+        for (size_t j = 0; j < k; ++j) {
+            const auto &[atom, level] = participants[j];
+            value = max(value, tries[atom]->get(position[j], level));
+        }
+
+        // Move every trie to the first value not smaller than the largest one
+        bool all_equal = true;
+        for (size_t j = 0; j < k; ++j) {
+            const auto &[atom, level] = participants[j];
+            position[j] = tries[atom]->seek(position[j], end[atom], level, value);
+            if (position[j] == end[atom])
+                return;
+            if (tries[atom]->get(position[j], level) != value)
+                all_equal = false;
+        }
+        if (!all_equal)
+            continue;
+
+        binding[depth] = value;
+        for (size_t j = 0; j < k; ++j) {
+            const auto &[atom, level] = participants[j];
+            next_position[j] = tries[atom]->skip(position[j], end[atom], level, value);
+        }
+
+        // Restrict the tries to the rows with this value and bind the next variables
+        for (size_t j = 0; j < k; ++j) {
+            int atom = participants[j].first;
+            ranges[j] = {begin[atom], end[atom]};
+            begin[atom] = position[j];
+            end[atom] = next_position[j];
+        }
+        enumerate(depth + 1);
+        for (size_t j = 0; j < k; ++j) {
+            int atom = participants[j].first;
+            begin[atom] = ranges[j].first;
+            end[atom] = ranges[j].second;
+        }
+
+        for (size_t j = 0; j < k; ++j) {
+            position[j] = next_position[j];
+            if (position[j] == end[participants[j].first])
+                return;
+        }
+    }
+}
+
+
+LeapfrogTriejoinSuccessorGenerator::LeapfrogTriejoinSuccessorGenerator(const Task &task)
+    : GenericJoinSuccessor(task)
+{
+    leapfrog_data.resize(action_data.size());
+    for (const ActionSchema &action : task.get_action_schemas()) {
+        const PrecompiledActionData &adata = action_data[action.get_index()];
+        if (adata.is_ground || adata.statically_inapplicable)
+            continue;
+        precompile_leapfrog_data(action, leapfrog_data[action.get_index()]);
+    }
+}
+
+void LeapfrogTriejoinSuccessorGenerator::precompile_leapfrog_data(const ActionSchema &action,
+                                                                  LeapfrogActionData &data) const
+{
+    const PrecompiledActionData &adata = action_data[action.get_index()];
+    const vector<Atom> &atoms = adata.relevant_precondition_atoms;
+
+    // Bind first the variables that appear in more atoms
+    map<int, int> number_atoms;
+    for (const Atom &atom : atoms) {
+        set<int> variables;
+        for (const Argument &arg : atom.get_arguments()) {
+            if (!arg.is_constant())
+                variables.insert(arg.get_index());
+        }
+        for (int v : variables)
+            ++number_atoms[v];
+    }
+    for (const auto &entry : number_atoms)
+        data.variable_order.push_back(entry.first);
+    stable_sort(data.variable_order.begin(), data.variable_order.end(),
+                [&](int v1, int v2) {return number_atoms[v1] > number_atoms[v2];});
+
+    map<int, int> depth_of_variable;
+    for (size_t depth = 0; depth < data.variable_order.size(); ++depth)
+        depth_of_variable[data.variable_order[depth]] = depth;
+
+    data.columns.resize(atoms.size());
+    data.repeated.resize(atoms.size());
+    data.participants.resize(data.variable_order.size());
+    for (size_t i = 0; i < atoms.size(); ++i) {
+        const vector<Argument> &args = atoms[i].get_arguments();
+        map<int, int> first_position;
+        vector<pair<int, int>> depth_and_position;
+        for (size_t pos = 0; pos < args.size(); ++pos) {
+            if (args[pos].is_constant())
+                continue;
+            int v = args[pos].get_index();
+            auto it = first_position.find(v);
+            if (it == first_position.end()) {
+                first_position[v] = pos;
+                depth_and_position.emplace_back(depth_of_variable[v], pos);
+            }
+            else {
+                data.repeated[i].emplace_back(it->second, pos);
+            }
+        }
+        sort(depth_and_position.begin(), depth_and_position.end());
+        for (size_t level = 0; level < depth_and_position.size(); ++level) {
+            data.columns[i].push_back(depth_and_position[level].second);
+            data.participants[depth_and_position[level].first].emplace_back(i, level);
+        }
+    }
+
+    data.static_tries.resize(atoms.size());
+    vector<bool> is_fluent(atoms.size(), false);
+    for (unsigned i : adata.fluent_tables)
+        is_fluent[i] = true;
+    for (size_t i = 0; i < atoms.size(); ++i) {
+        if (!is_fluent[i])
+            build_trie(adata.precompiled_db[i], data.columns[i], data.repeated[i], data.static_tries[i]);
+    }
+}
+
+void LeapfrogTriejoinSuccessorGenerator::build_trie(const Table &table,
+                                                    const vector<int> &columns,
+                                                    const vector<pair<int, int>> &repeated,
+                                                    TrieRelation &trie)
+{
+    size_t k = columns.size();
+    trie.arity = k;
+    trie.values.clear();
+    if (k == 0) {
+        // All arguments are constants: the atom only needs a matching tuple
+        return;
+    }
+    vector<int> projected;
+    projected.reserve(table.size() * k);
+    for (size_t r = 0; r < table.size(); ++r) {
+        const int *tuple = table.row(r);
+        bool matches = all_of(repeated.begin(), repeated.end(),
+                              [&](const pair<int, int> &p) {return tuple[p.first] == tuple[p.second];});
+        if (!matches)
+            continue;
+        for (int c : columns)
+            projected.push_back(tuple[c]);
+    }
+
+    size_t n = projected.size() / k;
+    if (k == 1) {
+        sort(projected.begin(), projected.end());
+        projected.erase(unique(projected.begin(), projected.end()), projected.end());
+        trie.values = std::move(projected);
+        return;
+    }
+
+    vector<size_t> order(n);
+    iota(order.begin(), order.end(), 0);
+    const int *rows = projected.data();
+    sort(order.begin(), order.end(), [&](size_t r1, size_t r2) {
+        return lexicographical_compare(rows + r1 * k, rows + (r1 + 1) * k,
+                                       rows + r2 * k, rows + (r2 + 1) * k);
+    });
+    trie.values.reserve(projected.size());
+    for (size_t r : order) {
+        const int *row = rows + r * k;
+        // Projections of different tuples may coincide
+        if (!trie.values.empty() && equal(row, row + k, trie.values.end() - k))
+            continue;
+        trie.values.insert(trie.values.end(), row, row + k);
+    }
+}
+
+Table LeapfrogTriejoinSuccessorGenerator::instantiate(const ActionSchema &action,
+                                                      const DBState &state)
+{
+    if (action.is_ground()) {
+        throw std::runtime_error("Shouldn't be calling instantiate() on a ground action");
+    }
+
+    const PrecompiledActionData &adata = action_data[action.get_index()];
+    const LeapfrogActionData &data = leapfrog_data[action.get_index()];
+    if (adata.statically_inapplicable)
+        return Table::EMPTY_TABLE();
+
+    const vector<Atom> &atoms = adata.relevant_precondition_atoms;
+    vector<TrieRelation> fluent_tries(atoms.size());
+    vector<const TrieRelation *> tries(atoms.size());
+    for (size_t i = 0; i < atoms.size(); ++i)
+        tries[i] = &data.static_tries[i];
+    for (unsigned i : adata.fluent_tables) {
+        vector<int> tuples;
+        vector<int> constants, indices;
+        get_indices_and_constants_in_preconditions(indices, constants, atoms[i]);
+        select_tuples(state, atoms[i], tuples, constants);
+        if (tuples.empty())
+            return Table::EMPTY_TABLE();
+        build_trie(Table(std::move(tuples), std::move(indices)),
+                   data.columns[i], data.repeated[i], fluent_tries[i]);
+        if (fluent_tries[i].size() == 0 && !data.columns[i].empty())
+            return Table::EMPTY_TABLE();
+        tries[i] = &fluent_tries[i];
+    }
+
+    Table result(vector<int>(), vector<int>(data.variable_order));
+    LeapfrogJoin(data, tries, result).run();
+    filter_static(action, result);
+    return result;
+}
@@ -0,0 +1,95 @@
+#ifndef SEARCH_LEAPFROG_TRIEJOIN_H
+#define SEARCH_LEAPFROG_TRIEJOIN_H
+
+#include "generic_join_successor.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Relation of a precondition stored as a trie: its tuples, projected
+ * onto the free variables of the precondition in the global variable order,
+ * sorted lexicographically and without duplicates.
+ *
+ * @details The trie is implicit: the children of a node at level l are the
+ * rows of a contiguous range that share the first l values, and the values of
+ * column l are sorted within that range.
+ */
+class TrieRelation {
+public:
+    std::vector<int> values;
+    std::size_t arity;
+
+    TrieRelation() : arity(0) {}
+
+    std::size_t size() const { return arity == 0 ? 0 : values.size() / arity; }
+
+    int get(std::size_t row, std::size_t level) const {
+        return values[row * arity + level];
+    }
+
+    //! First row in [begin, end) whose value at `level` is not smaller than `value`
+    std::size_t seek(std::size_t begin, std::size_t end, std::size_t level, int value) const;
+
+    //! First row in [begin, end) whose value at `level` is larger than `value`
+    std::size_t skip(std::size_t begin, std::size_t end, std::size_t level, int value) const;
+};
+
+
+/**
+ * @brief Precompiled data of an action schema for the Leapfrog Triejoin.
+ *
+ * @var variable_order: Free variables in the order they are bound.
+ * @var columns: For each relevant precondition atom, the argument positions
+ * of its free variables in variable order, one per variable.
+ * @var repeated: For each relevant precondition atom, the pairs of argument
+ * positions holding the same variable, which must have equal values.
+ * @var participants: For each variable, the atoms containing it and the
+ * level of the variable in the trie of each one.
+ * @var static_tries: Tries of the static atoms, built once.
+ */
+struct LeapfrogActionData {
+    std::vector<int> variable_order;
+    std::vector<std::vector<int>> columns;
+    std::vector<std::vector<std::pair<int, int>>> repeated;
+    std::vector<std::vector<std::pair<int, int>>> participants;
+    std::vector<TrieRelation> static_tries;
+};
+
+
+/**
+ * @brief Successor generator evaluating preconditions with the Leapfrog
+ * Triejoin (Veldhuizen, 2014), a worst-case optimal multiway join.
+ *
+ * @details Instead of a sequence of binary joins, the preconditions are joined
+ * one variable at a time: for each variable, the values allowed by all
+ * relations containing it are intersected by leapfrogging over their sorted
+ * tries, and the remaining variables are bound recursively for each common
+ * value. No intermediate table is built, so the running time is bounded by
+ * the size of the largest possible result also on cyclic preconditions, where
+ * binary joins may produce intermediate results much larger than the output.
+ *
+ * The tries of fluent preconditions are built for each state from the
+ * relations of the state; the tries of static preconditions are built once.
+ * Variables shared by more preconditions are bound first.
+ */
+class LeapfrogTriejoinSuccessorGenerator : public GenericJoinSuccessor {
+public:
+    explicit LeapfrogTriejoinSuccessorGenerator(const Task &task);
+
+    Table instantiate(const ActionSchema &action, const DBState &state) override;
+
+private:
+    //! Indexed by schema index
+    std::vector<LeapfrogActionData> leapfrog_data;
+
+    void precompile_leapfrog_data(const ActionSchema &action, LeapfrogActionData &data) const;
+
+    static void build_trie(const Table &table,
+                           const std::vector<int> &columns,
+                           const std::vector<std::pair<int, int>> &repeated,
+                           TrieRelation &trie);
+};
+
+#endif //SEARCH_LEAPFROG_TRIEJOIN_H
@@ -4,7 +4,6 @@
 #include "../task.h"
 
 #include "../database/table.h"
-#include "../database/hash_join.h"
 #include "../states/state.h"
 
 #include <cassert>
@@ -47,7 +46,7 @@ template<typename OrderT>
 Table OrderedJoinSuccessorGenerator<OrderT>::instantiate(const ActionSchema &action,
                                                          const DBState &state) {
 
-    vector<int> order = precondition_to_order[action.get_index()];
+    const vector<int> &order = precondition_to_order[action.get_index()];
 
     if (action.is_ground()) {
         throw std::runtime_error("Shouldn't be calling instantiate() on a ground action");
@@ -56,24 +55,11 @@ Table OrderedJoinSuccessorGenerator<OrderT>::instantiate(const ActionSchema &act
     const auto& actiondata = action_data[action.get_index()];
 
     vector<Table> tables(0);
-    auto res = parse_precond_into_join_program(actiondata, state, tables);
+    auto res = parse_fluent_preconditions(actiondata, state, tables);
 
     if (!res) return Table::EMPTY_TABLE();
 
-    assert(!tables.empty());
-    assert(tables.size() == actiondata.relevant_precondition_atoms.size());
-
-    Table &working_table = tables[order[0]];
-    for (size_t i = 1; i < tables.size(); ++i) {
-        hash_join(working_table, tables[order[i]]);
-        // Filter out equalities
-        filter_static(action, working_table);
-        if (working_table.tuples.empty()) {
-            return working_table;
-        }
-    }
-
-    return working_table;
+    return join_in_order(action, tables, order);
 }
 
 // explicit template instantiations
@@ -1,24 +1,39 @@
 #include "random_successor.h"
 
+#include "../action_schema.h"
+
 #include "../database/table.h"
 
 #include <algorithm>
+#include <numeric>
+#include <stdexcept>
 #include <vector>
 
 using namespace std;
 
 RandomSuccessorGenerator::RandomSuccessorGenerator(const Task &task, unsigned seed) :
-    GenericJoinSuccessor(task),
-    rng(seed)
+    GenericJoinSuccessor(task)
 {
+    rngs.reserve(action_data.size());
+    for (size_t i = 0; i < action_data.size(); ++i) {
+        seed_seq seq{seed, static_cast<unsigned>(i)};
+        rngs.emplace_back(seq);
+    }
 }
 
-bool RandomSuccessorGenerator::parse_precond_into_join_program(
-    const PrecompiledActionData &adata, const DBState &state, std::vector<Table>& tables)
+Table RandomSuccessorGenerator::instantiate(const ActionSchema &action, const DBState &state)
 {
-    bool res = GenericJoinSuccessor::parse_precond_into_join_program(adata, state, tables);
-    if (!res) return false;
+    if (action.is_ground()) {
+        throw std::runtime_error("Shouldn't be calling instantiate() on a ground action");
+    }
+
+    const PrecompiledActionData &adata = action_data[action.get_index()];
+    vector<Table> tables;
+    if (!parse_fluent_preconditions(adata, state, tables))
+        return Table::EMPTY_TABLE();
 
-    shuffle(tables.begin(), tables.end(), rng);
-    return true;
-}
\ No newline at end of file
+    vector<int> order(tables.size());
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), rngs[adata.schema_index]);
+    return join_in_order(action, tables, order);
+}
@@ -4,21 +4,23 @@
 #include "generic_join_successor.h"
 
 #include <random>
+#include <vector>
 
 /**
  * This class implements a successor generator based on a randomly ordered
  * join program.
+ *
+ * @details Each action schema shuffles its join order with its own random engine,
+ * seeded from the global seed and the schema index. This keeps the join
+ * orders reproducible when schemas are instantiated in parallel.
  */
 class RandomSuccessorGenerator : public GenericJoinSuccessor {
-    std::default_random_engine rng;
+    std::vector<std::default_random_engine> rngs;
 
 public:
     explicit RandomSuccessorGenerator(const Task &task, unsigned seed);
 
-    // @see generic_join_successor.h
-    bool parse_precond_into_join_program(const PrecompiledActionData &adata,
-                                         const DBState &state,
-                                         std::vector<Table>& tables) override;
+    Table instantiate(const ActionSchema &action, const DBState &state) override;
 };
 
 
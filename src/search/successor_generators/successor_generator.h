@@ -49,6 +49,27 @@ public:
     virtual std::vector<LiftedOperatorId> get_applicable_actions(
             const std::vector<ActionSchema> &actions, const DBState &state) = 0;
 
+    /**
+     * Prepare the instantiation of the action schemas in the given state one at
+     * a time with get_applicable_actions_of_schema().
+     *
+     * @see ApplicableActionIterator
+     * @return false if the generator only computes the applicable actions of all
+     * schemas at once, with get_applicable_actions(actions, state).
+     */
+    virtual bool prepare_schema_by_schema(const DBState &) {
+        return true;
+    }
+
+    /**
+     * Compute the instantiations of the given action schema that are applicable in
+     * the state given to the last call of prepare_schema_by_schema().
+     */
+    virtual std::vector<LiftedOperatorId> get_applicable_actions_of_schema(
+            const ActionSchema &action, const DBState &state) {
+        return get_applicable_actions(action, state);
+    }
+
     /**
      * Generate the state that results from applying the given action to the given state.
      */
@@ -64,6 +85,8 @@ public:
         return added_atoms;
     }
 
+    virtual void print_statistics() const {}
+
 };
 
 #endif //SEARCH_SUCCESSOR_GENERATOR_H
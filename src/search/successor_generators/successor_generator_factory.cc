@@ -1,7 +1,9 @@
 
 #include "successor_generator_factory.h"
 
+#include "adaptive_join_successor.h"
 #include "full_reducer_successor_generator.h"
+#include "leapfrog_triejoin.h"
 #include "naive_successor.h"
 #include "ordered_join_successor.h"
 #include "random_successor.h"
@@ -16,35 +18,72 @@
 
 SuccessorGenerator *SuccessorGeneratorFactory::create(const std::string &method,
                                                       unsigned seed,
-                                                      Task &task)
+                                                      unsigned num_threads,
+                                                      const Task &task,
+                                                      bool incremental)
 {
     std::cout << "Creating successor generator factory..." << std::endl;
+    GenericJoinSuccessor *generator = nullptr;
     if (boost::iequals(method, "join")) {
-        return new NaiveSuccessorGenerator(task);
+        generator = new NaiveSuccessorGenerator(task);
     }
     else if (boost::iequals(method, "full_reducer")) {
-        return new FullReducerSuccessorGenerator(task);
+        generator = new FullReducerSuccessorGenerator(task);
     }
     else if (boost::iequals(method, "inverse_ordered_join")) {
-        return new OrderedJoinSuccessorGenerator<InverseOrderTable>(task);
+        generator = new OrderedJoinSuccessorGenerator<InverseOrderTable>(task);
     }
     else if (boost::iequals(method, "ordered_join")) {
-        return new OrderedJoinSuccessorGenerator<OrderTable>(task);
+        generator = new OrderedJoinSuccessorGenerator<OrderTable>(task);
     }
     else if (boost::iequals(method, "random_join")) {
-        return new RandomSuccessorGenerator(task, seed);
+        generator = new RandomSuccessorGenerator(task, seed);
     }
     else if (boost::iequals(method, "yannakakis")) {
-        return new YannakakisSuccessorGenerator(task);
+        generator = new YannakakisSuccessorGenerator(task);
     }
-    else if (boost::iequals(method, "clique_bk")) {
-        return new CliqueSuccessorGenerator(task, BronKerboschFirst);
+    else if (boost::iequals(method, "leapfrog")) {
+        generator = new LeapfrogTriejoinSuccessorGenerator(task);
     }
-    else if (boost::iequals(method, "clique_kckp")) {
-        return new CliqueSuccessorGenerator(task, KCliqueKPartite);
+    else if (boost::iequals(method, "adaptive_join")) {
+        generator = new AdaptiveJoinSuccessorGenerator(task);
     }
-    else {
-        std::cerr << "Invalid successor generator method \"" << method << "\"" << std::endl;
-        exit(-1);
+
+    if (generator) {
+        if (num_threads > 1) {
+            std::cout << "Instantiating action schemas with " << num_threads << " threads" << std::endl;
+        }
+        generator->set_num_threads(num_threads);
+        if (incremental) {
+            std::cout << "Instantiating action schemas incrementally from the parent state" << std::endl;
+        }
+        generator->set_incremental(incremental);
+        return generator;
     }
+
+    CliqueSuccessorGenerator *clique_generator = nullptr;
+    if (boost::iequals(method, "clique_kckp")) {
+        if (num_threads > 1) {
+            std::cout << "Splitting the k-partite clique search over " << num_threads << " threads" << std::endl;
+        }
+        clique_generator = new CliqueSuccessorGenerator(task, KCliqueKPartite, num_threads);
+    }
+    else if (boost::iequals(method, "clique_bk")) {
+        if (num_threads > 1) {
+            std::cout << "WARNING: successor generator \"" << method
+                      << "\" does not support multiple threads, running single-threaded" << std::endl;
+        }
+        clique_generator = new CliqueSuccessorGenerator(task, BronKerboschFirst);
+    }
+
+    if (clique_generator) {
+        if (incremental) {
+            std::cout << "Updating the assignment sets incrementally from the parent state" << std::endl;
+        }
+        clique_generator->set_incremental(incremental);
+        return clique_generator;
+    }
+
+    std::cerr << "Invalid successor generator method \"" << method << "\"" << std::endl;
+    exit(-1);
 }
@@ -10,7 +10,9 @@ class SuccessorGeneratorFactory {
 public:
     static SuccessorGenerator *create(const std::string &method,
                                       unsigned seed,
-                                      Task &task);
+                                      unsigned num_threads,
+                                      const Task &task,
+                                      bool incremental = false);
 };
 
 
@@ -245,12 +245,12 @@ Table YannakakisSuccessorGenerator::instantiate(const ActionSchema &action,
             }
         }
         Table &working_table = tables[j.second];
-        hash_join(working_table, tables[j.first]);
+        hash_join(working_table, tables[j.first], get_join_arena(action));
         // Project must be after removal of inequality constraints, otherwise we might keep only the tuple violating
         // some inequality. Variables in inequalities are also considered distinguished.
         filter_static(action, working_table);
         project(working_table, project_over);
-        if (working_table.tuples.empty()) {
+        if (working_table.empty()) {
             return working_table;
         }
     }
@@ -258,9 +258,9 @@ Table YannakakisSuccessorGenerator::instantiate(const ActionSchema &action,
     // For the case where the action schema is cyclic
     Table &working_table = tables[remaining_join[action.get_index()][0]];
     for (size_t i = 1; i < remaining_join[action.get_index()].size(); ++i) {
-        hash_join(working_table, tables[remaining_join[action.get_index()][i]]);
+        hash_join(working_table, tables[remaining_join[action.get_index()][i]], get_join_arena(action));
         filter_static(action, working_table);
-        if (working_table.tuples.empty()) {
+        if (working_table.empty()) {
             return working_table;
         }
     }
@@ -34,6 +34,7 @@ void Task::create_empty_initial_state(size_t number_predicates)
         static_preds.push_back(r);
         fluents.push_back(r);
     }
+    atom_table = make_shared<AtomTable>(*this);
     initial_state = DBState(std::move(fluents), vector<bool>(predicates.size(), false));
     static_info = StaticInformation(std::move(static_preds), vector<bool>(predicates.size(), false));
 }
@@ -51,8 +52,7 @@ void Task::dump_state(DBState s) const
     const auto& relations = s.get_relations();
     for (size_t i = 0; i < relations.size(); ++i) {
         string relation_name = predicates[relations[i].predicate_symbol].get_name();
-        unordered_set<GroundAtom, TupleHash> tuples = relations[i].tuples;
-        for (auto &tuple : tuples) {
+        for (const auto &tuple : relations[i].tuples) {
             cout << relation_name << "(";
             for (auto obj : tuple) {
                 cout << objects[obj].get_name() << ",";
@@ -112,9 +112,10 @@ bool Task::is_goal(const DBState &state) const
     }
     for (const AtomicGoal &atomicGoal : goal.goal) {
         int goal_predicate = atomicGoal.get_predicate_index();
-        const Relation &relation_at_goal_predicate = state.get_relations()[goal_predicate];
+        // States do not store the tuples of static predicates
+        const DBState &relations = predicates[goal_predicate].isStaticPredicate() ? static_info : state;
+        const Relation &relation_at_goal_predicate = relations.get_relations()[goal_predicate];
 
-        assert(!predicates[relation_at_goal_predicate.predicate_symbol].isStaticPredicate());
         assert(goal_predicate == relation_at_goal_predicate.predicate_symbol);
 
         const auto it = relation_at_goal_predicate.tuples.find(atomicGoal.get_arguments());
@@ -5,8 +5,11 @@
 #include "goal_condition.h"
 #include "object.h"
 #include "predicate.h"
+#include "states/atom_table.h"
 #include "states/state.h"
 
+#include <cassert>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <unordered_map>
@@ -27,6 +30,7 @@ class Task {
 
     std::vector<ActionSchema> action_schemas;
     GoalCondition goal;
+    std::shared_ptr<const AtomTable> atom_table;
 
 public:
     std::vector<Predicate> predicates;
@@ -57,6 +61,10 @@ public:
         return objects[index].get_name();
     }
 
+    /*
+     * Also creates the AtomTable of the task, so the types, predicates and
+     * objects must be known.
+     */
     void create_empty_initial_state(size_t number_predicates);
 
     void create_goal_condition(std::vector<AtomicGoal> goals,
@@ -105,6 +113,11 @@ public:
         return predicates[idx].get_name();
     }
 
+    const AtomTable &get_atom_table() const {
+        assert(atom_table);
+        return *atom_table;
+    }
+
   //! Return a vector R where R[i] contains all objects of type i (or of some subtype).
   std::vector<std::vector<int>> compute_object_index() const;
 
@@ -0,0 +1,161 @@
+#include "mapped_arena.h"
+
+#include "system.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+static const size_t BLOCK_BYTES = 1 << 20;
+static const size_t ALIGNMENT = alignof(max_align_t);
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+MappedArena::MappedArena(const string &directory, size_t memory_budget_mb)
+    : file_size(0),
+      block_used(0),
+      memory_budget_kb(memory_budget_mb * 1024),
+      page_size(sysconf(_SC_PAGESIZE)),
+      next_block_to_spill(0),
+      num_page_ins(0),
+      num_page_outs(0) {
+    string path = directory + "/search-space-XXXXXX";
+    vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    file_descriptor = mkstemp(name.data());
+    if (file_descriptor == -1) {
+        cerr << "Could not create the search space file in " << directory << endl;
+        exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    // The file is deleted as soon as it is closed
+    unlink(name.data());
+}
+
+MappedArena::~MappedArena() {
+    for (const Block &block : blocks) {
+        munmap(block.data, block.size);
+    }
+    close(file_descriptor);
+}
+
+void MappedArena::add_block(size_t size) {
+    enforce_memory_budget();
+
+    if (ftruncate(file_descriptor, file_size + size) == -1) {
+        cerr << "Could not grow the search space file" << endl;
+        exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, file_size);
+    if (data == MAP_FAILED) {
+        cerr << "Could not map the search space file" << endl;
+        exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    blocks.push_back(Block{static_cast<unsigned char *>(data), size, file_size, false});
+    file_size += size;
+    block_used = 0;
+}
+
+size_t MappedArena::count_resident_pages(const Block &block) const {
+    vector<unsigned char> residency(block.size / page_size);
+#if OPERATING_SYSTEM == OSX
+    mincore(block.data, block.size, reinterpret_cast<char *>(residency.data()));
+#else
+    mincore(block.data, block.size, residency.data());
+#endif
+    return count_if(residency.begin(), residency.end(),
+                    [](unsigned char page) {return page & 1;});
+}
+
+/*
+  Spill blocks, oldest first, until num_pages pages were dropped. The last
+  block is never spilled: it holds the most recent states and nodes, and it is
+  where the next ones are written. The search continues from the next block
+  the following time, so blocks that were read back are spilled again only
+  after all other blocks.
+*/
+void MappedArena::spill_oldest_blocks(size_t num_pages) {
+    size_t num_candidates = blocks.size() - 1;
+    size_t dropped = 0;
+    for (size_t i = 0; i < num_candidates && dropped < num_pages; ++i) {
+        if (next_block_to_spill >= num_candidates)
+            next_block_to_spill = 0;
+        Block &block = blocks[next_block_to_spill++];
+        size_t resident = count_resident_pages(block);
+        if (resident == 0)
+            continue;
+        if (block.is_spilled)
+            num_page_ins += resident;
+
+        msync(block.data, block.size, MS_SYNC);
+        madvise(block.data, block.size, MADV_DONTNEED);
+#if OPERATING_SYSTEM == LINUX
+        // Also drop the pages from the page cache, which counts against memory limits
+        posix_fadvise(file_descriptor, block.file_offset, block.size, POSIX_FADV_DONTNEED);
+#endif
+        block.is_spilled = true;
+        num_page_outs += resident;
+        dropped += resident;
+    }
+}
+
+void MappedArena::enforce_memory_budget() {
+    if (blocks.size() < 2)
+        return;
+    int resident_kb = get_resident_memory_in_kb();
+    if (resident_kb < 0 || size_t(resident_kb) <= memory_budget_kb)
+        return;
+    // Go below the budget by one block, so we do not spill at every new block
+    size_t excess_kb = resident_kb - memory_budget_kb + BLOCK_BYTES / 1024;
+    spill_oldest_blocks(excess_kb * 1024 / page_size);
+}
+
+size_t MappedArena::get_page_ins() const {
+    size_t page_ins = num_page_ins;
+    for (const Block &block : blocks) {
+        if (block.is_spilled)
+            page_ins += count_resident_pages(block);
+    }
+    return page_ins;
+}
+#else
+MappedArena::MappedArena(const string &, size_t) {
+    cerr << "Memory-bounded search spaces are not supported on this system" << endl;
+    exit_with(ExitCode::SEARCH_UNSUPPORTED);
+}
+
+MappedArena::~MappedArena() {
+}
+
+void MappedArena::add_block(size_t) {
+}
+
+size_t MappedArena::get_page_ins() const {
+    return 0;
+}
+#endif
+
+void *MappedArena::allocate(size_t bytes) {
+    size_t begin = (block_used + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    if (blocks.empty() || begin + bytes > blocks.back().size) {
+        // Blocks larger than BLOCK_BYTES hold a single allocation
+        add_block(max(BLOCK_BYTES, (bytes + page_size - 1) / page_size * page_size));
+        begin = 0;
+    }
+    block_used = begin + bytes;
+    return blocks.back().data + begin;
+}
+
+void MappedArena::print_statistics() const {
+    cout << "Search space file size: " << file_size / 1024 << " KB" << endl;
+    cout << "Search space pages written out: " << get_page_outs() << endl;
+    cout << "Search space pages read back: " << get_page_ins() << endl;
+}
+}
@@ -0,0 +1,115 @@
+#ifndef UTILS_MAPPED_ARENA_H
+#define UTILS_MAPPED_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utils {
+/*
+  Memory arena backed by a temporary file mapped into memory.
+
+  Memory is handed out from blocks that are mapped one after the other from
+  the file. It is never moved or freed before the arena is destroyed. When the
+  resident memory of the process exceeds the memory budget, the oldest blocks
+  are written to the file and dropped from memory ("spilled"). The kernel reads
+  spilled pages back on their next access, so pointers into the arena stay
+  valid and users of the arena do not need to know which blocks were spilled.
+
+  The budget is checked every time a new block is mapped. Page-outs are the
+  pages dropped when spilling. Page-ins are the pages of spilled blocks that
+  were read back; they are counted when the block is spilled again and when
+  the statistics are printed.
+*/
+class MappedArena {
+    struct Block {
+        unsigned char *data;
+        std::size_t size;
+        std::size_t file_offset;
+        bool is_spilled;
+    };
+
+    int file_descriptor;
+    std::size_t file_size;
+    std::vector<Block> blocks;
+    // Bytes used in the last block
+    std::size_t block_used;
+    std::size_t memory_budget_kb;
+    std::size_t page_size;
+    std::size_t next_block_to_spill;
+    std::size_t num_page_ins;
+    std::size_t num_page_outs;
+
+    void add_block(std::size_t size);
+    std::size_t count_resident_pages(const Block &block) const;
+    void spill_oldest_blocks(std::size_t num_pages);
+    void enforce_memory_budget();
+
+public:
+    MappedArena(const std::string &directory, std::size_t memory_budget_mb);
+    ~MappedArena();
+
+    MappedArena(const MappedArena &) = delete;
+    MappedArena &operator=(const MappedArena &) = delete;
+
+    void *allocate(std::size_t bytes);
+
+    std::size_t get_page_ins() const;
+    std::size_t get_page_outs() const { return num_page_outs; }
+    std::size_t get_file_size() const { return file_size; }
+
+    void print_statistics() const;
+};
+
+
+/*
+  Allocator for the segmented vectors. It allocates from a MappedArena if one
+  is given, and from the heap otherwise.
+*/
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    MappedArena *arena;
+
+    ArenaAllocator(MappedArena *arena = nullptr) : arena(arena) {
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {
+    }
+
+    T *allocate(std::size_t n) {
+        if (arena)
+            return static_cast<T *>(arena->allocate(n * sizeof(T)));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) {
+        // Memory of the arena is released with the arena
+        if (!arena)
+            std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U, typename ... Args>
+    void construct(U *p, Args &&... args) {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destroy(U *p) {
+        p->~U();
+    }
+};
+}
+
+#endif
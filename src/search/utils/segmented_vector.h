@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 namespace segmented_vector {
@@ -40,6 +41,9 @@ namespace segmented_vector {
   storing many fixed-size arrays. It's essentially a variant of SegmentedVector
   where the size of the stored data is only known at runtime, not at compile
   time.
+
+  SegmentedBlobVector stores byte arrays whose size differs from one array to
+  the next, packed one after the other.
 */
 
 template<class Entry, class Allocator = std::allocator<Entry>>
@@ -262,6 +266,90 @@ public:
         }
     }
 };
+
+
+/*
+  SegmentedBlobVector stores byte arrays of different sizes. Each array is
+  copied right after the previous one into large segments, so storing an array
+  only allocates memory when the current segment is full, and the overhead per
+  array is its address and size. Arrays larger than a segment get a segment of
+  their own. Arrays never move once stored.
+*/
+template<class Allocator = std::allocator<unsigned char>>
+class SegmentedBlobVector {
+public:
+    struct Blob {
+        const unsigned char *data;
+        size_t size;
+    };
+
+private:
+    typedef typename Allocator::template rebind<unsigned char>::other ByteAllocator;
+    typedef typename Allocator::template rebind<Blob>::other BlobAllocator;
+    static constexpr size_t SEGMENT_BYTES = 65536;
+
+    struct Segment {
+        unsigned char *data;
+        size_t capacity;
+    };
+
+    ByteAllocator byte_allocator;
+
+    std::vector<Segment> segments;
+    // Bytes used in the last segment
+    size_t segment_used;
+    SegmentedVector<Blob, BlobAllocator> blobs;
+
+    // No implementation to forbid copies and assignment
+    SegmentedBlobVector(const SegmentedBlobVector &);
+    SegmentedBlobVector &operator=(const SegmentedBlobVector &);
+public:
+    SegmentedBlobVector()
+        : segment_used(0) {
+    }
+
+    explicit SegmentedBlobVector(const Allocator &allocator_)
+        : byte_allocator(allocator_),
+          segment_used(0),
+          blobs(BlobAllocator(allocator_)) {
+    }
+
+    ~SegmentedBlobVector() {
+        for (const Segment &segment : segments) {
+            byte_allocator.deallocate(segment.data, segment.capacity);
+        }
+    }
+
+    Blob operator[](size_t index) const {
+        return blobs[index];
+    }
+
+    size_t size() const {
+        return blobs.size();
+    }
+
+    void push_back(const unsigned char *data, size_t size) {
+        if (segments.empty() || segment_used + size > segments.back().capacity) {
+            // The rest of the last segment is left unused
+            size_t capacity = std::max(SEGMENT_BYTES, size);
+            segments.push_back(Segment{byte_allocator.allocate(capacity), capacity});
+            segment_used = 0;
+        }
+        unsigned char *dest = segments.back().data + segment_used;
+        std::copy(data, data + size, dest);
+        segment_used += size;
+        blobs.push_back(Blob{dest, size});
+    }
+
+    void pop_back() {
+        const Blob &last = blobs[blobs.size() - 1];
+        // Give the bytes back if nothing was stored after them
+        if (last.data + last.size == segments.back().data + segment_used) {
+            segment_used -= last.size;
+        }
+        blobs.pop_back();
+    }
+};
 }
 
 
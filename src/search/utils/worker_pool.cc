@@ -0,0 +1,115 @@
+#include "worker_pool.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace utils {
+WorkerPool::WorkerPool(unsigned num_threads)
+    : job(nullptr),
+      num_jobs(0),
+      next_job(0),
+      active_workers(0),
+      batch_id(0),
+      shutting_down(false) {
+    assert(num_threads >= 1);
+    workers.reserve(num_threads - 1);
+    for (unsigned i = 1; i < num_threads; ++i) {
+        workers.emplace_back(&WorkerPool::worker_loop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        shutting_down = true;
+    }
+    batch_started.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::process_jobs(const function<void(size_t)> *f, size_t n) {
+    if (n == 0)
+        return;
+    while (true) {
+        size_t i = next_job.fetch_add(1, memory_order_relaxed);
+        if (i >= n)
+            return;
+        try {
+            (*f)(i);
+        } catch (...) {
+            lock_guard<mutex> lock(pool_mutex);
+            if (!first_exception)
+                first_exception = current_exception();
+        }
+    }
+}
+
+void WorkerPool::worker_loop() {
+    unsigned long last_batch = 0;
+    while (true) {
+        const function<void(size_t)> *current_job;
+        size_t current_num_jobs;
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            batch_started.wait(lock, [&] {
+                return shutting_down || batch_id != last_batch;
+            });
+            if (shutting_down)
+                return;
+            last_batch = batch_id;
+            current_job = job;
+            current_num_jobs = num_jobs;
+            ++active_workers;
+        }
+        process_jobs(current_job, current_num_jobs);
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            --active_workers;
+        }
+        batch_finished.notify_one();
+    }
+}
+
+void WorkerPool::run(size_t n, const function<void(size_t)> &f) {
+    if (workers.empty() || n <= 1) {
+        for (size_t i = 0; i < n; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        job = &f;
+        num_jobs = n;
+        next_job.store(0, memory_order_relaxed);
+        first_exception = nullptr;
+        ++batch_id;
+    }
+    batch_started.notify_all();
+
+    process_jobs(&f, n);
+
+    exception_ptr exception;
+    {
+        /*
+          At this point every job index has been claimed. Workers that wake up
+          only after we reset the batch below see zero jobs and go back to
+          sleep right away.
+        */
+        unique_lock<mutex> lock(pool_mutex);
+        batch_finished.wait(lock, [&] {
+            return active_workers == 0;
+        });
+        job = nullptr;
+        num_jobs = 0;
+        exception = first_exception;
+        first_exception = nullptr;
+    }
+    if (exception)
+        rethrow_exception(exception);
+}
+}
@@ -0,0 +1,60 @@
+#ifndef UTILS_WORKER_POOL_H
+#define UTILS_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  Fixed-size pool of threads that stay alive for the whole lifetime of the
+  pool, so that dispatching a batch of jobs does not pay for thread creation.
+
+  A call to run(n, job) executes job(0), ..., job(n - 1), each exactly once,
+  and returns only after all of them are done. The calling thread takes part
+  in the work, so a pool with k threads spawns k - 1 workers. Jobs are handed
+  out dynamically; callers that need a deterministic result must write the
+  output of job(i) into a slot reserved for index i.
+
+  If some job throws, the first exception is rethrown by run() once the batch
+  is finished.
+*/
+class WorkerPool {
+    std::vector<std::thread> workers;
+
+    std::mutex pool_mutex;
+    std::condition_variable batch_started;
+    std::condition_variable batch_finished;
+
+    const std::function<void(std::size_t)> *job;
+    std::size_t num_jobs;
+    std::atomic<std::size_t> next_job;
+    std::size_t active_workers;
+    unsigned long batch_id;
+    bool shutting_down;
+    std::exception_ptr first_exception;
+
+    void worker_loop();
+    void process_jobs(const std::function<void(std::size_t)> *f, std::size_t n);
+
+public:
+    explicit WorkerPool(unsigned num_threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    unsigned get_num_threads() const {
+        return workers.size() + 1;
+    }
+
+    void run(std::size_t num_jobs, const std::function<void(std::size_t)> &job);
+};
+}
+
+#endif
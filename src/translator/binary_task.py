@@ -0,0 +1,176 @@
+#! /usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+"""
+Binary version of the task file read by the search component.
+
+The binary file holds the same information as the text file printed by
+translate.py, laid out so that the planner can map it into memory and read it
+without tokenizing. All numbers are 32-bit little-endian integers.
+
+  - the magic bytes MAGIC, then the format VERSION;
+  - the size S in bytes of the string table, followed by the S bytes of the
+    table and zero bytes up to the next multiple of 4;
+  - a sequence of integers. Strings are written as two integers, the offset of
+    the string in the string table and its length. The sequence contains:
+      - domain name, task name
+      - TYPES, N, then N times: name
+      - PREDICATES, N, then N times: name, index, arity A, static, A types
+      - OBJECTS, N, then N times: name, index, number of types T, T types
+      - INITIAL-STATE, N, then N times: index, predicate index, negated,
+        arity A, A objects
+      - GOAL, N, then N times: predicate index, negated, arity A, A objects
+      - ACTION-SCHEMAS, N, then N times:
+          name, cost, number of parameters P, number of preconditions C,
+          number of effects E,
+          P times: name, index, type
+          C + E times: predicate name, predicate index, negated, arity A,
+          A pairs (is constant, object or parameter index)
+
+Section names are written as the integers in SECTIONS and checked when the
+file is read, like the canaries of the text format.
+
+The file is produced from the text output, so both formats always describe
+the same task. This module can also be called as a script to convert an
+existing task file:
+
+    binary_task.py output.lifted output.bin
+"""
+
+import struct
+import sys
+
+MAGIC = b'PWLBTASK'
+VERSION = 1
+
+SECTIONS = {'TYPES': 1,
+            'PREDICATES': 2,
+            'OBJECTS': 3,
+            'INITIAL-STATE': 4,
+            'GOAL': 5,
+            'ACTION-SCHEMAS': 6}
+
+
+class BinaryTaskWriter:
+    def __init__(self):
+        self.strings = bytearray()
+        self.string_offsets = {}
+        self.words = []
+
+    def add_int(self, value):
+        self.words.append(int(value))
+
+    def add_string(self, s):
+        if s not in self.string_offsets:
+            self.string_offsets[s] = len(self.strings)
+            self.strings += s.encode('utf-8')
+        self.words.append(self.string_offsets[s])
+        self.words.append(len(s.encode('utf-8')))
+
+    def add_section(self, name, size):
+        self.add_int(SECTIONS[name])
+        self.add_int(size)
+
+    def to_bytes(self):
+        padding = (-len(self.strings)) % 4
+        header = MAGIC + struct.pack('<II', VERSION, len(self.strings))
+        body = struct.pack('<%di' % len(self.words), *self.words)
+        return header + bytes(self.strings) + bytes(padding) + body
+
+
+def text_to_binary(text):
+    """
+    Convert the text task representation into the binary format. The text is
+    read exactly as the parser of the search component reads it.
+    """
+    tokens = iter(text.split())
+    next_token = lambda: next(tokens)
+    next_int = lambda: int(next(tokens))
+
+    def read_section(expected):
+        canary = next_token()
+        if canary != expected:
+            raise ValueError("Expected section %s, read '%s'" % (expected, canary))
+        size = next_int()
+        writer.add_section(expected, size)
+        return size
+
+    def copy_ints(n):
+        for _ in range(n):
+            writer.add_int(next_int())
+
+    writer = BinaryTaskWriter()
+    writer.add_string(next_token())
+    writer.add_string(next_token())
+    representation = next_token()
+    if representation != 'SPARSE-REPRESENTATION':
+        raise ValueError("Only the sparse representation has a binary format")
+
+    for _ in range(read_section('TYPES')):
+        writer.add_string(next_token())
+        next_int()  # the index is the position of the type
+
+    for _ in range(read_section('PREDICATES')):
+        writer.add_string(next_token())
+        copy_ints(1)
+        arity = next_int()
+        writer.add_int(arity)
+        copy_ints(1 + arity)
+
+    for _ in range(read_section('OBJECTS')):
+        writer.add_string(next_token())
+        copy_ints(1)
+        number_types = next_int()
+        writer.add_int(number_types)
+        copy_ints(number_types)
+
+    for _ in range(read_section('INITIAL-STATE')):
+        next_token()  # the name of the atom is not used by the planner
+        copy_ints(3)
+        arity = next_int()
+        writer.add_int(arity)
+        copy_ints(arity)
+
+    for _ in range(read_section('GOAL')):
+        next_token()
+        copy_ints(2)
+        arity = next_int()
+        writer.add_int(arity)
+        copy_ints(arity)
+
+    for _ in range(read_section('ACTION-SCHEMAS')):
+        writer.add_string(next_token())
+        copy_ints(1)
+        number_parameters = next_int()
+        number_preconditions = next_int()
+        number_effects = next_int()
+        for value in (number_parameters, number_preconditions, number_effects):
+            writer.add_int(value)
+        for _ in range(number_parameters):
+            writer.add_string(next_token())
+            copy_ints(2)
+        for _ in range(number_preconditions + number_effects):
+            writer.add_string(next_token())
+            copy_ints(2)
+            arity = next_int()
+            writer.add_int(arity)
+            for _ in range(arity):
+                kind = next_token()
+                if kind not in ('c', 'p'):
+                    raise ValueError("Argument is neither constant nor parameter: '%s'" % kind)
+                writer.add_int(kind == 'c')
+                copy_ints(1)
+
+    return writer.to_bytes()
+
+
+def write_binary_task(text, filename):
+    with open(filename, 'wb') as output:
+        output.write(text_to_binary(text))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        sys.exit("Usage: %s <task.lifted> <output-file>" % sys.argv[0])
+    with open(sys.argv[1]) as task_file:
+        write_binary_task(task_file.read(), sys.argv[2])
@@ -13,6 +13,10 @@ def parse_args():
     argparser.add_argument(
         "--output-file", default="output.lifted",
         help="path to the output file (default: %(default)s)")
+    argparser.add_argument(
+        "--binary-output", action="store_true",
+        help="write the output file in the binary format of binary_task.py, "
+             "which the planner loads faster than the text format.")
     argparser.add_argument(
         "--plan-file", default="plan",
         help="path to the plan file (default: %(default)s)")
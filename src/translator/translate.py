@@ -1,6 +1,7 @@
 #! /usr/bin/env python3
 # -*- coding: utf-8 -*-
 
+import io
 import os
 import signal
 import sys
@@ -17,6 +18,7 @@ def python_version_supported():
 if not python_version_supported():
     sys.exit("Error: Translator only supports Python >= 2.7 and Python >= 3.2.")
 
+import binary_task
 import compile_types
 import complete_state
 import normalize
@@ -97,7 +99,11 @@ def main():
     if os.path.isfile(options.output_file):
         print("WARNING: file %s already exists, it will be overwritten" %
               options.output_file)
-    output = open(options.output_file, "w")
+    if options.binary_output:
+        # The text output is converted when the translation is complete
+        output = io.StringIO()
+    else:
+        output = open(options.output_file, "w")
 
     with timers.timing("Removing function symbols from initial state"):
         remove_functions_from_initial_state(task)
@@ -137,6 +143,10 @@ def main():
     with timers.timing("Printing action schemas"):
         print_action_schemas(output, task, object_index, predicate_index, type_index)
 
+    if options.binary_output:
+        with timers.timing("Writing binary task file"):
+            binary_task.write_binary_task(output.getvalue(), options.output_file)
+
     print("Total translation time:", timer.get_cpu_time())
 
     return